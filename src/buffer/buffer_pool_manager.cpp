@@ -67,7 +67,14 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   pages_[frame_id].page_id_ = page_id;
   pages_[frame_id].pin_count_ = 1;
   pages_[frame_id].is_dirty_ = false;
-  disk_manager_->ReadPage(page_id, pages_[frame_id].data_);
+  if (!disk_manager_->ReadPage(page_id, pages_[frame_id].data_)) {
+    // The page is corrupt on disk, so the frame goes back to the free list.
+    pages_[frame_id].ResetMemory();
+    pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+    pages_[frame_id].pin_count_ = 0;
+    free_list_.emplace_back(frame_id);
+    return nullptr;
+  }
   page_table_.insert({page_id, frame_id});
 
   return &pages_[frame_id];
@@ -149,15 +156,16 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   if (iter == page_table_.end()) {
     disk_manager_->DeallocatePage(page_id);
   } else {
-    Page &page = pages_[iter->second];
+    frame_id_t frame_id = iter->second;
+    Page &page = pages_[frame_id];
     if (page.pin_count_ > 0) return false;
-    replacer_->Pin(iter->second);
+    replacer_->Pin(frame_id);
     page.ResetMemory();
     page.page_id_ = INVALID_PAGE_ID;
     page.pin_count_ = 0;
     page.is_dirty_ = false;
     page_table_.erase(page_id);
-    free_list_.emplace_back(static_cast<int>(iter->second));
+    free_list_.emplace_back(frame_id);
     disk_manager_->DeallocatePage(page_id);
   }
 
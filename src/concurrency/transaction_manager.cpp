@@ -15,6 +15,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "storage/index/index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -42,16 +43,23 @@ void TransactionManager::Commit(Transaction *txn) {
 
   // Perform all deletes before we commit.
   auto write_set = txn->GetWriteSet();
+  std::unordered_set<TableHeap *> inserted_tables;
   while (!write_set->empty()) {
     auto &item = write_set->back();
     auto table = item.table_;
     if (item.wtype_ == WType::DELETE) {
       // Note that this also releases the lock when holding the page latch.
       table->ApplyDelete(item.rid_, txn);
+    } else if (item.wtype_ == WType::INSERT) {
+      inserted_tables.insert(table);
     }
     write_set->pop_back();
   }
   write_set->clear();
+  for (auto table : inserted_tables) {
+    table->ReleaseInsertPage(txn);
+  }
+  txn->GetIndexWriteSet()->clear();
 
   if (enable_logging) {
     // TODO(student): add logging here
@@ -66,8 +74,19 @@ void TransactionManager::Commit(Transaction *txn) {
 void TransactionManager::Abort(Transaction *txn) {
   txn->SetState(TransactionState::ABORTED);
 
-  // Rollback before releasing the lock.
+  // Rollback before releasing the lock. Index entries are undone first, so that none points to a removed tuple.
+  auto index_write_set = txn->GetIndexWriteSet();
+  while (!index_write_set->empty()) {
+    auto &item = index_write_set->back();
+    if (item.wtype_ == WType::INSERT) {
+      item.index_->DeleteEntry(item.key_, item.rid_, txn);
+    } else if (item.wtype_ == WType::DELETE) {
+      item.index_->InsertEntry(item.key_, item.rid_, txn);
+    }
+    index_write_set->pop_back();
+  }
   auto write_set = txn->GetWriteSet();
+  std::unordered_set<TableHeap *> inserted_tables;
   while (!write_set->empty()) {
     auto &item = write_set->back();
     auto table = item.table_;
@@ -76,12 +95,18 @@ void TransactionManager::Abort(Transaction *txn) {
     } else if (item.wtype_ == WType::INSERT) {
       // Note that this also releases the lock when holding the page latch.
       table->ApplyDelete(item.rid_, txn);
+      inserted_tables.insert(table);
+    } else if (item.wtype_ == WType::BULKINSERT) {
+      table->RollbackBulkInsert(item.rid_, txn);
     } else if (item.wtype_ == WType::UPDATE) {
       table->UpdateTuple(item.tuple_, item.rid_, txn);
     }
     write_set->pop_back();
   }
   write_set->clear();
+  for (auto table : inserted_tables) {
+    table->ReleaseInsertPage(txn);
+  }
 
   if (enable_logging) {
     // TODO(student): add logging here
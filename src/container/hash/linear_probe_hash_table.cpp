@@ -12,7 +12,9 @@
 
 #include "container/hash/linear_probe_hash_table.h"
 
+#include <algorithm>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,22 +30,10 @@ HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  auto header_page_all =  buffer_pool_manager_->NewPage(&header_page_id_);
-  header_page_all->WLatch();
-  auto header_page = reinterpret_cast<HashTableHeaderPage *>(header_page_all->GetData());
-  header_page->SetSize(num_buckets);
-  header_page->SetPageId(header_page_id_);
-
-  //allocate block page
-  for (size_t i = 0; i < num_buckets; i++) {
-      page_id_t block_page_id = INVALID_PAGE_ID;
-      buffer_pool_manager_->NewPage(&block_page_id);
-      if (block_page_id == INVALID_PAGE_ID) { i--; continue; }
-      header_page->AddBlockPageId(block_page_id);
-      buffer_pool_manager_->UnpinPage(block_page_id, false);
+  header_page_id_ = NewHeaderPage(num_buckets);
+  if (header_page_id_ == INVALID_PAGE_ID) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "hash table cannot be created: no free buffer pool frame");
   }
-  header_page_all->WUnlatch();
-  buffer_pool_manager_->UnpinPage(header_page_id_, true);
 }
 
 /*****************************************************************************
@@ -67,7 +57,6 @@ bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
     if (block_page->IsReadable(bucket_ind) && comparator_(block_page->KeyAt(bucket_ind), key) == 0) 
       result->push_back(block_page->ValueAt(bucket_ind));
     bucket_ind++;
-    if (block_ind * BLOCK_ARRAY_SIZE + bucket_ind == index) break;
     if (bucket_ind == BLOCK_ARRAY_SIZE) {
       bucket_ind = 0;
       block_page_all->RUnlatch();
@@ -76,8 +65,9 @@ bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
       block_page_all = buffer_pool_manager_->FetchPage(header_page->GetBlockPageId(block_ind));
       block_page_all->RLatch();
       block_page = reinterpret_cast<HashTableBlockPage<KeyType, ValueType, KeyComparator> *>(block_page_all->GetData());
-      
     }
+    // Every bucket has been probed.
+    if (block_ind * BLOCK_ARRAY_SIZE + bucket_ind == index) break;
   }
   block_page_all->RUnlatch();
   buffer_pool_manager_->UnpinPage(header_page->GetBlockPageId(block_ind), false);
@@ -95,44 +85,44 @@ bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.RLock();
+  size_t num_blocks;
+  std::optional<bool> inserted = InsertImpl(key, value, &num_blocks);
+  table_latch_.RUnlock();
+  if (!inserted.has_value()) {
+    // The table is full. Resize() needs the table latch exclusively, so it must not be called while holding it.
+    if (!Resize(num_blocks * BLOCK_ARRAY_SIZE)) {
+      return false;
+    }
+    return Insert(transaction, key, value);
+  }
+  return *inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::optional<bool> HASH_TABLE_TYPE::InsertImpl(const KeyType &key, const ValueType &value, size_t *num_blocks) {
   auto header_page_all =  buffer_pool_manager_->FetchPage(header_page_id_);
   header_page_all->RLatch();
   auto header_page = reinterpret_cast<HashTableHeaderPage *>(header_page_all->GetData());
+  *num_blocks = header_page->NumBlocks();
 
   size_t index, block_ind, bucket_ind;
   GetIndex(key, header_page->NumBlocks(), index, block_ind, bucket_ind);
- 
+
   auto block_page_all = buffer_pool_manager_->FetchPage(header_page->GetBlockPageId(block_ind));
   block_page_all->WLatch();
   auto block_page = reinterpret_cast<HashTableBlockPage<KeyType, ValueType, KeyComparator> *>(block_page_all->GetData());
 
-  while (!block_page->Insert(bucket_ind, key, value)) {
+  std::optional<bool> inserted;
+  while (true) {
+    if (block_page->Insert(bucket_ind, key, value)) {
+      inserted = true;
+      break;
+    }
     if (!comparator_(block_page->KeyAt(bucket_ind), key) && block_page->ValueAt(bucket_ind) == value) {
-      block_page_all->WUnlatch();
-      buffer_pool_manager_->UnpinPage(header_page->GetBlockPageId(block_ind), true);
-      header_page_all->RUnlatch();
-      buffer_pool_manager_->UnpinPage(header_page_id_, false);
-      return false;
+      inserted = false;
+      break;
     }
     bucket_ind++;
-    //Resize hash table
-    if (block_ind * BLOCK_ARRAY_SIZE + bucket_ind == index) {
-      block_page_all->WUnlatch();
-      buffer_pool_manager_->UnpinPage(header_page->GetBlockPageId(block_ind), false);
-      header_page_all->RUnlatch();
-      buffer_pool_manager_->UnpinPage(header_page_id_, false);
-      Resize(header_page->NumBlocks() * BLOCK_ARRAY_SIZE);
-
-      header_page_all =  buffer_pool_manager_->FetchPage(header_page_id_);
-      header_page_all->RLatch();
-      header_page = reinterpret_cast<HashTableHeaderPage *>(header_page_all->GetData());
-      GetIndex(key, header_page->NumBlocks(), index, block_ind, bucket_ind);
-
-      block_page_all = buffer_pool_manager_->FetchPage(header_page->GetBlockPageId(block_ind));
-      block_page_all->WLatch();
-      block_page = reinterpret_cast<HashTableBlockPage<KeyType, ValueType, KeyComparator> *>(block_page_all->GetData());
-      continue;
-    }
     if (bucket_ind == BLOCK_ARRAY_SIZE) {
       bucket_ind = 0;
       block_page_all->WUnlatch();
@@ -142,13 +132,14 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
       block_page_all->WLatch();
       block_page = reinterpret_cast<HashTableBlockPage<KeyType, ValueType, KeyComparator> *>(block_page_all->GetData());
     }
+    // Every bucket has been probed, the table is full.
+    if (block_ind * BLOCK_ARRAY_SIZE + bucket_ind == index) break;
   }
   block_page_all->WUnlatch();
-  buffer_pool_manager_->UnpinPage(header_page->GetBlockPageId(block_ind), true);
+  buffer_pool_manager_->UnpinPage(header_page->GetBlockPageId(block_ind), inserted.value_or(false));
   header_page_all->RUnlatch();
   buffer_pool_manager_->UnpinPage(header_page_id_, false);
-  table_latch_.RUnlock();
-  return true;
+  return inserted;
 }
 
 /*****************************************************************************
@@ -176,6 +167,7 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
         buffer_pool_manager_->UnpinPage(header_page->GetBlockPageId(block_ind), true);
         header_page_all->RUnlatch();
         buffer_pool_manager_->UnpinPage(header_page_id_, false);
+        table_latch_.RUnlock();
         return false;
       }
       block_page->Remove(bucket_ind);
@@ -183,10 +175,10 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
       buffer_pool_manager_->UnpinPage(header_page->GetBlockPageId(block_ind), true);
       header_page_all->RUnlatch();
       buffer_pool_manager_->UnpinPage(header_page_id_, false);
+      table_latch_.RUnlock();
       return true;
     }
     bucket_ind++;
-    if (block_ind * BLOCK_ARRAY_SIZE + bucket_ind == index) break;
     if (bucket_ind == BLOCK_ARRAY_SIZE) {
       bucket_ind = 0;
       block_page_all->WUnlatch();
@@ -196,6 +188,8 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
       block_page_all->WLatch();
       block_page = reinterpret_cast<HashTableBlockPage<KeyType, ValueType, KeyComparator> *>(block_page_all->GetData());
     }
+    // Every bucket has been probed.
+    if (block_ind * BLOCK_ARRAY_SIZE + bucket_ind == index) break;
   }
   block_page_all->WUnlatch();
   buffer_pool_manager_->UnpinPage(header_page->GetBlockPageId(block_ind), true);
@@ -209,48 +203,42 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+bool HASH_TABLE_TYPE::Resize(size_t initial_size) {
   table_latch_.WLock();
-  size_t num_buckets = 2 * initial_size / BLOCK_ARRAY_SIZE;
-  page_id_t del_header_page_id = header_page_id_;
-  auto header_page_all =  buffer_pool_manager_->NewPage(&header_page_id_);
-  header_page_all->WLatch();
-  auto header_page = reinterpret_cast<HashTableHeaderPage *>(header_page_all->GetData());
-  header_page->SetSize(num_buckets);
-  header_page->SetPageId(header_page_id_);
-  // allocate block page
-  for (size_t i = 0; i < num_buckets; i++) {
-      page_id_t block_page_id = INVALID_PAGE_ID;
-      buffer_pool_manager_->NewPage(&block_page_id);
-      if (block_page_id == INVALID_PAGE_ID) { i--; continue; }
-      header_page->AddBlockPageId(block_page_id);
-      buffer_pool_manager_->UnpinPage(block_page_id, false);
+  page_id_t new_header_page_id = NewHeaderPage(std::max<size_t>(1, 2 * initial_size / BLOCK_ARRAY_SIZE));
+  if (new_header_page_id == INVALID_PAGE_ID) {
+    // Keep the old pages.
+    table_latch_.WUnlock();
+    return false;
   }
+  page_id_t old_header_page_id = header_page_id_;
+  header_page_id_ = new_header_page_id;
+
   // move key-value
-  auto del_header_page_all =  buffer_pool_manager_->FetchPage(header_page_id_);
-  del_header_page_all->RLatch();
-  auto del_header_page = reinterpret_cast<HashTableHeaderPage *>(header_page_all->GetData());
-  for (size_t block_ind = 0; block_ind < del_header_page->NumBlocks(); block_ind++) {
-    page_id_t del_block_page_id = del_header_page->GetBlockPageId(block_ind);    
-    auto del_block_page_all = buffer_pool_manager_->FetchPage(del_block_page_id);
-    del_block_page_all->RLatch();
-    auto del_block_page = reinterpret_cast<HashTableBlockPage<KeyType, ValueType, KeyComparator> *>(del_block_page_all->GetData());
+  auto old_header_page_all =  buffer_pool_manager_->FetchPage(old_header_page_id);
+  old_header_page_all->RLatch();
+  auto old_header_page = reinterpret_cast<HashTableHeaderPage *>(old_header_page_all->GetData());
+  for (size_t block_ind = 0; block_ind < old_header_page->NumBlocks(); block_ind++) {
+    page_id_t old_block_page_id = old_header_page->GetBlockPageId(block_ind);
+    auto old_block_page_all = buffer_pool_manager_->FetchPage(old_block_page_id);
+    old_block_page_all->RLatch();
+    auto old_block_page = reinterpret_cast<HashTableBlockPage<KeyType, ValueType, KeyComparator> *>(old_block_page_all->GetData());
 
     for (size_t bucket_ind = 0; bucket_ind < BLOCK_ARRAY_SIZE; bucket_ind++) {
-      if (del_block_page->IsReadable(bucket_ind)) {
-        KeyType key = del_block_page->KeyAt(bucket_ind);
-        ValueType value = del_block_page->ValueAt(bucket_ind);
-        Insert(nullptr, key, value);
+      if (old_block_page->IsReadable(bucket_ind)) {
+        size_t num_blocks;
+        InsertImpl(old_block_page->KeyAt(bucket_ind), old_block_page->ValueAt(bucket_ind), &num_blocks);
       }
     }
-    del_block_page_all->RUnlatch();
-    buffer_pool_manager_->UnpinPage(del_block_page_id, false);
-    buffer_pool_manager_->DeletePage(del_block_page_id);
+    old_block_page_all->RUnlatch();
+    buffer_pool_manager_->UnpinPage(old_block_page_id, false);
+    buffer_pool_manager_->DeletePage(old_block_page_id);
   }
-  del_header_page_all->RUnlatch();
-  buffer_pool_manager_->UnpinPage(del_header_page_id ,false);
-  buffer_pool_manager_->DeletePage(del_header_page_id);
+  old_header_page_all->RUnlatch();
+  buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+  buffer_pool_manager_->DeletePage(old_header_page_id);
   table_latch_.WUnlock();
+  return true;
 }
 
 /*****************************************************************************
@@ -269,6 +257,39 @@ size_t HASH_TABLE_TYPE::GetSize() {
   return BLOCK_ARRAY_SIZE * num_buckets;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::NewHeaderPage(size_t num_blocks) {
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_page_all =  buffer_pool_manager_->NewPage(&header_page_id);
+  if (header_page_all == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  header_page_all->WLatch();
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(header_page_all->GetData());
+  header_page->SetSize(num_blocks);
+  header_page->SetPageId(header_page_id);
+
+  //allocate block page
+  for (size_t i = 0; i < num_blocks; i++) {
+      page_id_t block_page_id = INVALID_PAGE_ID;
+      if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+        // Give back the pages allocated so far.
+        for (size_t j = 0; j < header_page->NumBlocks(); j++) {
+          buffer_pool_manager_->DeletePage(header_page->GetBlockPageId(j));
+        }
+        header_page_all->WUnlatch();
+        buffer_pool_manager_->UnpinPage(header_page_id, false);
+        buffer_pool_manager_->DeletePage(header_page_id);
+        return INVALID_PAGE_ID;
+      }
+      header_page->AddBlockPageId(block_page_id);
+      buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+  header_page_all->WUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::GetIndex(const KeyType &key, const size_t &num_buckets, size_t &index,size_t &block_ind, size_t &bucket_ind) {
   index = hash_fn_.GetHash(key) % (BLOCK_ARRAY_SIZE * num_buckets);
@@ -18,8 +18,11 @@
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/hash_join_executor.h"
+#include "execution/executors/index_nested_loop_join_executor.h"
+#include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/executors/sort_executor.h"
 
 namespace bustub {
 std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx,
@@ -30,6 +33,11 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
       return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan));
     }
 
+    // Create a new index scan executor.
+    case PlanType::IndexScan: {
+      return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan));
+    }
+
     // Create a new insert executor.
     case PlanType::Insert: {
       auto insert_plan = dynamic_cast<const InsertPlanNode *>(plan);
@@ -47,6 +55,13 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
                                                 std::move(right_executor));
     }
 
+    // Create a new index nested loop join executor.
+    case PlanType::IndexNestedLoopJoin: {
+      auto join_plan = dynamic_cast<const IndexNestedLoopJoinPlanNode *>(plan);
+      auto outer_executor = ExecutorFactory::CreateExecutor(exec_ctx, join_plan->GetOuterPlan());
+      return std::make_unique<IndexNestedLoopJoinExecutor>(exec_ctx, join_plan, std::move(outer_executor));
+    }
+
     // Create a new aggregation executor.
     case PlanType::Aggregation: {
       auto agg_plan = dynamic_cast<const AggregationPlanNode *>(plan);
@@ -54,6 +69,13 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
       return std::make_unique<AggregationExecutor>(exec_ctx, agg_plan, std::move(child_executor));
     }
 
+    // Create a new sort executor.
+    case PlanType::Sort: {
+      auto sort_plan = dynamic_cast<const SortPlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+      return std::make_unique<SortExecutor>(exec_ctx, sort_plan, std::move(child_executor));
+    }
+
     default: {
       BUSTUB_ASSERT(false, "Unsupported plan type.");
     }
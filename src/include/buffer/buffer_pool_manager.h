@@ -114,7 +114,7 @@ class BufferPoolManager {
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
-   * @return the requested page
+   * @return the requested page, or nullptr if no frame is free or the page is corrupt on disk
    */
   Page *FetchPageImpl(page_id_t page_id);
 
@@ -4,10 +4,12 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "storage/index/index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -17,6 +19,7 @@ namespace bustub {
  */
 using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
+using index_oid_t = uint32_t;
 
 /**
  * Metadata about a table.
@@ -30,9 +33,29 @@ struct TableMetadata {
   table_oid_t oid_;
 };
 
+/**
+ * Metadata about an index.
+ */
+struct IndexInfo {
+  IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
+            std::string table_name, size_t key_size)
+      : key_schema_(std::move(key_schema)),
+        name_(std::move(name)),
+        index_(std::move(index)),
+        index_oid_(index_oid),
+        table_name_(std::move(table_name)),
+        key_size_(key_size) {}
+  Schema key_schema_;
+  std::string name_;
+  std::unique_ptr<Index> index_;
+  index_oid_t index_oid_;
+  std::string table_name_;
+  const size_t key_size_;
+};
+
 /**
  * SimpleCatalog is a non-persistent catalog that is designed for the executor to use.
- * It handles table creation and table lookup.
+ * It handles table and index creation and lookup.
  */
 class SimpleCatalog {
  public:
@@ -50,13 +73,16 @@ class SimpleCatalog {
    * @param txn the transaction in which the table is being created
    * @param table_name the name of the new table
    * @param schema the schema of the new table
+   * @param layout the format of the pages of the new table, e.g. PAX for tables that are mostly scanned a few columns
+   * at a time
    * @return a pointer to the metadata of the new table
    */
-  TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema) {
+  TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema,
+                             TableLayout layout = TableLayout::ROW) {
     BUSTUB_ASSERT(names_.count(table_name) == 0, "Table names should be unique!");
     table_oid_t table_oid = next_table_oid_++;
     names_.insert({table_name, table_oid});
-    TableHeap* table_heap = new TableHeap{bpm_, lock_manager_, log_manager_, txn};
+    TableHeap* table_heap = new TableHeap{bpm_, lock_manager_, log_manager_, txn, layout, &schema};
     TableMetadata *table = new TableMetadata {schema, table_name, static_cast<std::unique_ptr<TableHeap>>(table_heap), table_oid};
     tables_.insert({table_oid, static_cast<std::unique_ptr<TableMetadata>>(table)});
     return table;
@@ -76,6 +102,66 @@ class SimpleCatalog {
       return iter->second.get();
   }
 
+  /**
+   * Create a new hash index on a table, fill it with the table's tuples and return its metadata.
+   * @param txn the transaction in which the index is being created
+   * @param index_name the name of the new index, unique within its table
+   * @param table_name the name of the table to be indexed
+   * @param key_attrs the indexes of the table columns that make up the index key
+   * @param num_buckets the number of block pages that the hash table starts out with
+   * @return a pointer to the metadata of the new index
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                         const std::vector<uint32_t> &key_attrs, size_t num_buckets = 1) {
+    TableMetadata *table = GetTable(table_name);
+    auto &table_indexes = index_names_[table_name];
+    BUSTUB_ASSERT(table_indexes.count(index_name) == 0, "Index names should be unique within a table!");
+    auto *metadata = new IndexMetadata(index_name, table_name, &table->schema_, key_attrs);
+    const Schema &key_schema = *metadata->GetKeySchema();
+    BUSTUB_ASSERT(key_schema.GetLength() <= sizeof(KeyType) && key_schema.GetUnlinedColumns().empty(),
+                  "The index key must be fixed-length and fit in the key type.");
+    auto index = std::make_unique<LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>>(
+        metadata, bpm_, num_buckets, HashFunction<KeyType>{});
+    for (auto iter = table->table_->Begin(txn); iter != table->table_->End(); ++iter) {
+      index->InsertEntry(iter->KeyFromTuple(table->schema_, key_schema, key_attrs), iter->GetRid(), txn);
+    }
+
+    index_oid_t index_oid = next_index_oid_++;
+    auto *index_info = new IndexInfo{key_schema, index_name, std::move(index), index_oid, table_name, sizeof(KeyType)};
+    indexes_.emplace(index_oid, std::unique_ptr<IndexInfo>(index_info));
+    table_indexes.emplace(index_name, index_oid);
+    return index_info;
+  }
+
+  /** @return index metadata by index name and table name */
+  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) {
+    auto table_iter = index_names_.find(table_name);
+    if (table_iter == index_names_.end()) throw std::out_of_range {"The table has no indexes."};
+    auto iter = table_iter->second.find(index_name);
+    if (iter == table_iter->second.end()) throw std::out_of_range {"The index doesn't exist on the table."};
+    return indexes_.find(iter->second)->second.get();
+  }
+
+  /** @return index metadata by oid */
+  IndexInfo *GetIndex(index_oid_t index_oid) {
+    auto iter = indexes_.find(index_oid);
+    if (iter == indexes_.end()) throw std::out_of_range {"The index doesn't exist in the catalog."};
+    return iter->second.get();
+  }
+
+  /** @return all the indexes on the table, empty if it has none */
+  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) {
+    std::vector<IndexInfo *> result;
+    auto table_iter = index_names_.find(table_name);
+    if (table_iter != index_names_.end()) {
+      for (const auto &[name, index_oid] : table_iter->second) {
+        result.push_back(indexes_.find(index_oid)->second.get());
+      }
+    }
+    return result;
+  }
+
  private:
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
@@ -87,5 +173,12 @@ class SimpleCatalog {
   std::unordered_map<std::string, table_oid_t> names_;
   /** The next table identifier to be used. */
   std::atomic<table_oid_t> next_table_oid_{0};
+
+  /** indexes_: index identifiers -> index metadata. Note that indexes_ owns all index metadata. */
+  std::unordered_map<index_oid_t, std::unique_ptr<IndexInfo>> indexes_;
+  /** index_names_: table name -> index names -> index identifiers */
+  std::unordered_map<std::string, std::unordered_map<std::string, index_oid_t>> index_names_;
+  /** The next index identifier to be used. */
+  std::atomic<index_oid_t> next_index_oid_{0};
 };
 }  // namespace bustub
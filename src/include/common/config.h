@@ -35,6 +35,10 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr uint32_t TUPLE_BATCH_SIZE = 1024;                            // max rows in a tuple batch
+static constexpr uint32_t SCAN_MORSEL_SIZE = 4;                               // table pages in a parallel scan morsel
+static constexpr size_t EXECUTOR_MEMORY_BUDGET = 64 * 1024 * 1024;           // bytes an executor may hold before spilling
+static constexpr size_t ARENA_CHUNK_SIZE = 64 * 1024;                        // bytes per chunk of an arena pool
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -45,6 +45,8 @@ enum class ExceptionType {
   INCOMPATIBLE_TYPE = 8,
   /** Method not implemented. */
   NOT_IMPLEMENTED = 11,
+  /** Out of memory, e.g. the buffer pool has no frame to spill to. */
+  OUT_OF_MEMORY = 12,
 };
 
 class Exception : public std::runtime_error {
@@ -81,6 +83,8 @@ class Exception : public std::runtime_error {
         return "Incompatible type";
       case ExceptionType::NOT_IMPLEMENTED:
         return "Not implemented";
+      case ExceptionType::OUT_OF_MEMORY:
+        return "Out of Memory";
       default:
         return "Unknown";
     }
@@ -13,10 +13,18 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
 #include "common/macros.h"
 #include "type/value.h"
 
@@ -24,27 +32,100 @@ namespace bustub {
 
 using hash_t = std::size_t;
 
+/**
+ * HashUtil provides the hash functions used throughout the execution engine.
+ *
+ * Byte strings are hashed a word at a time in the style of wyhash: input is consumed in 8-byte (or 16-byte) chunks
+ * that are folded together with a 64x64->128 bit multiply. Fixed-width values skip the byte loop entirely and are
+ * mixed with a single CRC32C instruction pair where the hardware supports it, or a single multiply otherwise.
+ */
 class HashUtil {
  private:
   static const hash_t prime_factor = 10000019;
 
+  /** Mixing constants, taken from wyhash. */
+  static constexpr uint64_t WY_P0 = 0xa0761d6478bd642fULL;
+  static constexpr uint64_t WY_P1 = 0xe7037ed1a0b428dbULL;
+  static constexpr uint64_t WY_P2 = 0x8ebc6af09c88c6e3ULL;
+
+  /** @return the 128-bit product of a and b, folded down to 64 bits */
+  static inline uint64_t Mum(uint64_t a, uint64_t b) {
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+  }
+
+  /** @return 8 bytes read from an arbitrarily aligned address */
+  static inline uint64_t Read8(const char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  /** @return 4 bytes read from an arbitrarily aligned address */
+  static inline uint64_t Read4(const char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  /** @return 1 to 3 bytes packed into a word, reading the first, middle and last byte */
+  static inline uint64_t Read3(const char *p, size_t length) {
+    return (static_cast<uint64_t>(static_cast<uint8_t>(p[0])) << 16) |
+           (static_cast<uint64_t>(static_cast<uint8_t>(p[length >> 1])) << 8) |
+           static_cast<uint64_t>(static_cast<uint8_t>(p[length - 1]));
+  }
+
  public:
   static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+    uint64_t seed = WY_P0;
+    uint64_t a;
+    uint64_t b;
+    if (length <= 16) {
+      if (length >= 4) {
+        // Two overlapping 4-byte reads from each end cover every byte of a 4..16 byte key.
+        size_t mid = (length >> 3) << 2;
+        a = (Read4(bytes) << 32) | Read4(bytes + mid);
+        b = (Read4(bytes + length - 4) << 32) | Read4(bytes + length - 4 - mid);
+      } else if (length > 0) {
+        a = Read3(bytes, length);
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      const char *p = bytes;
+      size_t remaining = length;
+      while (remaining > 16) {
+        seed = Mum(Read8(p) ^ WY_P1, Read8(p + 8) ^ seed);
+        p += 16;
+        remaining -= 16;
+      }
+      // The last 16 bytes of the input, possibly overlapping the final chunk above.
+      a = Read8(p + remaining - 16);
+      b = Read8(p + remaining - 8);
     }
-    return hash;
+    return Mum(WY_P1 ^ length, Mum(a ^ WY_P1, b ^ seed));
   }
 
-  static inline hash_t CombineHashes(hash_t l, hash_t r) {
-    hash_t both[2];
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+  /** @return the hash of a single 64-bit word */
+  static inline hash_t HashWord(uint64_t word) {
+#if defined(__SSE4_2__)
+    // CRC32C is a 3-cycle instruction, but only produces 32 bits. Hash the word and its rotation with different seeds
+    // so that the upper half is not a linear function of the lower half.
+    uint64_t lo = _mm_crc32_u64(WY_P0, word);
+    uint64_t hi = _mm_crc32_u64(WY_P1, (word << 32) | (word >> 32));
+    return (hi << 32) | lo;
+#elif defined(__ARM_FEATURE_CRC32)
+    uint64_t lo = __crc32cd(static_cast<uint32_t>(WY_P0), word);
+    uint64_t hi = __crc32cd(static_cast<uint32_t>(WY_P1), (word << 32) | (word >> 32));
+    return (hi << 32) | lo;
+#else
+    return Mum(word ^ WY_P0, WY_P2);
+#endif
   }
 
+  static inline hash_t CombineHashes(hash_t l, hash_t r) { return Mum(l ^ WY_P0, r ^ WY_P1); }
+
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % prime_factor + r % prime_factor) % prime_factor; }
 
   template <typename T>
@@ -54,7 +135,7 @@ class HashUtil {
 
   template <typename T>
   static inline hash_t HashPtr(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(&ptr), sizeof(void *));
+    return HashWord(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)));
   }
 
   /** @return the hash of the value */
@@ -62,27 +143,29 @@ class HashUtil {
     switch (val->GetTypeId()) {
       case TypeId::TINYINT: {
         auto raw = static_cast<int64_t>(val->GetAs<int8_t>());
-        return Hash<int64_t>(&raw);
+        return HashWord(static_cast<uint64_t>(raw));
       }
       case TypeId::SMALLINT: {
         auto raw = static_cast<int64_t>(val->GetAs<int16_t>());
-        return Hash<int64_t>(&raw);
+        return HashWord(static_cast<uint64_t>(raw));
       }
       case TypeId::INTEGER: {
         auto raw = static_cast<int64_t>(val->GetAs<int32_t>());
-        return Hash<int64_t>(&raw);
+        return HashWord(static_cast<uint64_t>(raw));
       }
       case TypeId::BIGINT: {
         auto raw = static_cast<int64_t>(val->GetAs<int64_t>());
-        return Hash<int64_t>(&raw);
+        return HashWord(static_cast<uint64_t>(raw));
       }
       case TypeId::BOOLEAN: {
         auto raw = val->GetAs<bool>();
-        return Hash<bool>(&raw);
+        return HashWord(static_cast<uint64_t>(raw));
       }
       case TypeId::DECIMAL: {
         auto raw = val->GetAs<double>();
-        return Hash<double>(&raw);
+        uint64_t bits;
+        memcpy(&bits, &raw, sizeof(bits));
+        return HashWord(bits);
       }
       case TypeId::VARCHAR: {
         auto raw = val->GetData();
@@ -91,7 +174,7 @@ class HashUtil {
       }
       case TypeId::TIMESTAMP: {
         auto raw = val->GetAs<uint64_t>();
-        return Hash<uint64_t>(&raw);
+        return HashWord(raw);
       }
       default: {
         BUSTUB_ASSERT(false, "Unsupported type.");
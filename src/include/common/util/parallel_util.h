@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_util.h
+//
+// Identification: src/include/common/util/parallel_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace bustub {
+
+/**
+ * ParallelUtil provides helpers for spreading work over a fixed number of worker threads.
+ */
+class ParallelUtil {
+ public:
+  /**
+   * Runs task(i) for every i in [0, num_tasks) on up to num_workers threads, including the calling thread.
+   * Workers claim one task at a time, so uneven tasks are balanced across the workers.
+   * @param num_workers the maximum number of threads to run the tasks on
+   * @param num_tasks the number of tasks
+   * @param task the task to run, must be safe to call concurrently for different indexes
+   */
+  template <typename Task>
+  static void ParallelFor(uint32_t num_workers, size_t num_tasks, const Task &task) {
+    std::atomic<size_t> next_task{0};
+    auto work = [&] {
+      for (size_t i = next_task++; i < num_tasks; i = next_task++) {
+        task(i);
+      }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_workers && i < num_tasks; i++) {
+      threads.emplace_back(work);
+    }
+    work();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+};
+
+}  // namespace bustub
@@ -39,8 +39,9 @@ enum class TransactionState { GROWING, SHRINKING, COMMITTED, ABORTED };
 /**
  * Type of write operation.
  */
-enum class WType { INSERT = 0, DELETE, UPDATE };
+enum class WType { INSERT = 0, DELETE, UPDATE, BULKINSERT };
 
+class Index;
 class TableHeap;
 
 /**
@@ -51,6 +52,7 @@ class WriteRecord {
   WriteRecord(RID rid, WType wtype, const Tuple &tuple, TableHeap *table)
       : rid_(rid), wtype_(wtype), tuple_(tuple), table_(table) {}
 
+  /** For a bulk insert, the page id is that of a new page and the slot number the number of tuples packed into it. */
   RID rid_;
   WType wtype_;
   /** The tuple is only used for the update operation. */
@@ -59,6 +61,23 @@ class WriteRecord {
   TableHeap *table_;
 };
 
+/**
+ * IndexWriteRecord tracks information related to a write to an index.
+ */
+class IndexWriteRecord {
+ public:
+  IndexWriteRecord(RID rid, WType wtype, const Tuple &key, Index *index)
+      : rid_(rid), wtype_(wtype), key_(key), index_(index) {}
+
+  /** The rid of the tuple that the index entry points to. */
+  RID rid_;
+  WType wtype_;
+  /** The key of the index entry. */
+  Tuple key_;
+  /** The index specifies which index this write record is for. */
+  Index *index_;
+};
+
 /**
  * Transaction tracks information related to a transaction.
  */
@@ -73,6 +92,7 @@ class Transaction {
         exclusive_lock_set_{new std::unordered_set<RID>} {
     // Initialize the sets that will be tracked.
     write_set_ = std::make_shared<std::deque<WriteRecord>>();
+    index_write_set_ = std::make_shared<std::deque<IndexWriteRecord>>();
     page_set_ = std::make_shared<std::deque<bustub::Page *>>();
     deleted_page_set_ = std::make_shared<std::unordered_set<page_id_t>>();
   }
@@ -90,6 +110,9 @@ class Transaction {
   /** @return the list of of write records of this transaction */
   inline std::shared_ptr<std::deque<WriteRecord>> GetWriteSet() { return write_set_; }
 
+  /** @return the list of of index write records of this transaction */
+  inline std::shared_ptr<std::deque<IndexWriteRecord>> GetIndexWriteSet() { return index_write_set_; }
+
   /** @return the page set */
   inline std::shared_ptr<std::deque<Page *>> GetPageSet() { return page_set_; }
 
@@ -148,6 +171,8 @@ class Transaction {
 
   /** The undo set of the transaction. */
   std::shared_ptr<std::deque<WriteRecord>> write_set_;
+  /** The undo set of the transaction's index writes. */
+  std::shared_ptr<std::deque<IndexWriteRecord>> index_write_set_;
   /** The LSN of the last record written by the transaction. */
   lsn_t prev_lsn_;
 
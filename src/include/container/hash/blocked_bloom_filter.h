@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// blocked_bloom_filter.h
+//
+// Identification: src/include/container/hash/blocked_bloom_filter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * BlockedBloomFilter is a split block Bloom filter over hashes.
+ *
+ * The filter is an array of 256-bit blocks. The upper half of a hash picks one block, and the lower half sets or tests
+ * one bit in each of the block's eight 32-bit words. Every lookup therefore touches a single cache line, and the bit
+ * positions are computed without any data-dependent branches.
+ */
+class BlockedBloomFilter {
+ public:
+  /**
+   * Creates a new, empty Bloom filter.
+   * @param num_keys the expected number of keys
+   * @param bits_per_key the number of filter bits per expected key; 16 bits give a false positive rate below 0.1%
+   */
+  explicit BlockedBloomFilter(size_t num_keys, uint32_t bits_per_key = 16)
+      : blocks_(std::max<size_t>((num_keys * bits_per_key + BLOCK_BITS - 1) / BLOCK_BITS, 1)) {}
+
+  /** Adds a hash to the filter. */
+  void Insert(hash_t hash) {
+    Block &block = blocks_[BlockOf(hash)];
+    for (uint32_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      block.words_[i] |= BitOf(hash, i);
+    }
+  }
+
+  /** @return false if the hash was certainly never inserted, true if it may have been */
+  bool MayContain(hash_t hash) const {
+    const Block &block = blocks_[BlockOf(hash)];
+    uint32_t missing = 0;
+    for (uint32_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      missing |= ~block.words_[i] & BitOf(hash, i);
+    }
+    return missing == 0;
+  }
+
+  /** @return the number of blocks in the filter */
+  size_t GetNumBlocks() const { return blocks_.size(); }
+
+ private:
+  static constexpr uint32_t WORDS_PER_BLOCK = 8;
+  static constexpr uint32_t BLOCK_BITS = WORDS_PER_BLOCK * 32;
+
+  /** Odd multipliers that derive one bit position per word from the lower half of a hash. */
+  static constexpr uint32_t SALTS[WORDS_PER_BLOCK] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+  struct alignas(32) Block {
+    uint32_t words_[WORDS_PER_BLOCK]{};
+  };
+
+  /** @return the block of a hash, scaling the upper 32 bits to the number of blocks without a division */
+  size_t BlockOf(hash_t hash) const { return static_cast<size_t>(((hash >> 32) * blocks_.size()) >> 32); }
+
+  /** @return the bit of the given word that a hash maps to */
+  static uint32_t BitOf(hash_t hash, uint32_t word) {
+    return 1U << ((static_cast<uint32_t>(hash) * SALTS[word]) >> 27);
+  }
+
+  std::vector<Block> blocks_;
+};
+
+}  // namespace bustub
@@ -14,7 +14,7 @@
 
 #include <cstdint>
 
-#include "murmur3/MurmurHash3.h"
+#include "common/util/hash_util.h"
 
 namespace bustub {
 
@@ -25,12 +25,7 @@ class HashFunction {
    * @param key the key to be hashed
    * @return the hashed value
    */
-  virtual uint64_t GetHash(KeyType key) {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
-  }
+  virtual uint64_t GetHash(KeyType key) { return HashUtil::Hash<KeyType>(&key); }
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <string>
 #include <vector>
@@ -77,8 +78,9 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   /**
    * Resizes the table to at least twice the initial size provided.
    * @param initial_size the initial size of the hash table
+   * @return false if the pages of the larger table could not be allocated, in which case the table is left as it was
    */
-  void Resize(size_t initial_size);
+  bool Resize(size_t initial_size);
 
   /**
    * Gets the size of the hash table
@@ -87,6 +89,23 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   size_t GetSize();
 
  private:
+  /**
+   * Inserts a key-value pair, with the table latch already held.
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @param[out] num_blocks the number of block pages of the table
+   * @return true if the pair was inserted, false if it already exists, std::nullopt if the table is full
+   */
+  std::optional<bool> InsertImpl(const KeyType &key, const ValueType &value, size_t *num_blocks);
+
+  /**
+   * Allocates a header page and its block pages.
+   * @param num_blocks the number of block pages
+   * @return the page id of the new header page, or INVALID_PAGE_ID if the buffer pool has no free frame for one of the
+   * pages, in which case none of them are kept
+   */
+  page_id_t NewHeaderPage(size_t num_blocks);
+
   /**
    * Gets the block index and the bucket index of the hash table
    */
@@ -0,0 +1,331 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate.h
+//
+// Identification: src/include/execution/compiled_predicate.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/filter_kernels.h"
+#include "storage/table/tuple_batch.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+/**
+ * CompiledPredicate is a predicate expression compiled into a flat program of type-specialized kernels that filter a
+ * whole TupleBatch at a time.
+ *
+ * Every comparison of the expression tree becomes one instruction, in post-order. An instruction reads its operands
+ * straight from the raw column data of the batch, from a constant, or from the result register of an earlier
+ * instruction, and runs a kernel specialized for the operand type, the comparison and which operands are constants,
+ * e.g. "INTEGER column < constant". A kernel is a loop over the rows from FilterKernels, vectorized where the target
+ * allows, with no virtual calls and no Values. A predicate of one comparison selects its rows straight from the kernel.
+ *
+ * Results follow Value semantics: a comparison with a NULL operand is NULL, and a row is selected exactly when
+ * AbstractExpression::EvaluateAt() would return a Value whose GetAs<bool>() is true.
+ */
+class CompiledPredicate {
+ public:
+  /**
+   * Compiles a predicate over the rows of a batch.
+   * @param predicate the predicate to compile, whose column value expressions refer to the columns of schema
+   * @param schema the schema of the batches that the predicate will filter
+   * @return the compiled predicate, or nullptr if the predicate uses something that has no kernel, e.g. VARCHAR values
+   * or a comparison of two different types, in which case it has to be interpreted
+   */
+  static std::unique_ptr<CompiledPredicate> Compile(const AbstractExpression *predicate, const Schema *schema) {
+    std::unique_ptr<CompiledPredicate> compiled(new CompiledPredicate());
+    TypeId type;
+    if (!compiled->CompileNode(predicate, schema, &compiled->result_, &type) || type != TypeId::BOOLEAN) {
+      return nullptr;
+    }
+    return compiled;
+  }
+
+  /**
+   * Evaluates the predicate on every row of a batch.
+   * @param batch the batch to filter, with the schema that the predicate was compiled for
+   * @param[out] sel the indexes of the rows that satisfy the predicate, in increasing order
+   */
+  void Filter(const TupleBatch &batch, std::vector<uint32_t> *sel) const {
+    uint32_t n = batch.GetSize();
+    sel->resize(n);
+    if (result_.kind_ == OperandKind::Constant) {
+      uint32_t count = result_.constant_[0] != 0 ? n : 0;
+      for (uint32_t i = 0; i < count; i++) {
+        (*sel)[i] = i;
+      }
+      sel->resize(count);
+      return;
+    }
+    if (program_.size() == 1) {
+      // A single comparison selects its rows directly, without materializing its results.
+      const Instruction &instruction = program_[0];
+      std::vector<int8_t> no_registers;
+      sel->resize(instruction.select_kernel_(Resolve(instruction.left_, batch, &no_registers),
+                                             Resolve(instruction.right_, batch, &no_registers), n, sel->data()));
+      return;
+    }
+    std::vector<int8_t> registers(static_cast<size_t>(num_registers_) * n);
+    for (const auto &instruction : program_) {
+      instruction.kernel_(Resolve(instruction.left_, batch, &registers), Resolve(instruction.right_, batch, &registers),
+                          &registers[static_cast<size_t>(instruction.result_) * n], n);
+    }
+    auto result = static_cast<const int8_t *>(Resolve(result_, batch, &registers));
+    sel->resize(FilterKernels::Select(result, n, sel->data()));
+  }
+
+ private:
+  /** A kernel compares the n values of its left and right operands and writes the n CmpBool results as int8_t. */
+  using Kernel = void (*)(const void *left, const void *right, int8_t *out, uint32_t n);
+  /** A select kernel compares the n values of its operands and writes the rows whose result is not false to sel. */
+  using SelectKernel = uint32_t (*)(const void *left, const void *right, uint32_t n, uint32_t *sel);
+
+  /** OperandKind enumerates where an instruction reads an operand from. */
+  enum class OperandKind { Column, Constant, Register };
+
+  /** An operand of an instruction. */
+  struct Operand {
+    OperandKind kind_{OperandKind::Constant};
+    /** The column index of a Column operand, or the register of a Register operand. */
+    uint32_t idx_{0};
+    /** The serialized value of a Constant operand. */
+    alignas(8) char constant_[8]{};
+  };
+
+  /** One comparison of the program. */
+  struct Instruction {
+    Kernel kernel_;
+    /** The fused kernel that selects rows directly, for a program of this one instruction. */
+    SelectKernel select_kernel_;
+    Operand left_;
+    Operand right_;
+    /** The register that the results are written to. */
+    uint32_t result_;
+  };
+
+  CompiledPredicate() = default;
+
+  /** Compares column values, constants or earlier results of type T. */
+  template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+  static void CompareKernel(const void *left, const void *right, int8_t *out, uint32_t n) {
+    FilterKernels::Compare<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>(static_cast<const T *>(left),
+                                                                  static_cast<const T *>(right), out, n);
+  }
+
+  /** Compares column values or constants of type T and selects the rows whose result is not false. */
+  template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+  static uint32_t CompareSelectKernel(const void *left, const void *right, uint32_t n, uint32_t *sel) {
+    return FilterKernels::CompareSelect<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>(static_cast<const T *>(left),
+                                                                               static_cast<const T *>(right), n, sel);
+  }
+
+  template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+  static void SelectKernels(Instruction *instruction) {
+    instruction->kernel_ = &CompareKernel<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>;
+    instruction->select_kernel_ = &CompareSelectKernel<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>;
+  }
+
+  template <typename T, ComparisonType CMP>
+  static void SelectKernels(bool left_constant, bool right_constant, Instruction *instruction) {
+    if (left_constant && right_constant) {
+      SelectKernels<T, CMP, true, true>(instruction);
+    } else if (left_constant) {
+      SelectKernels<T, CMP, true, false>(instruction);
+    } else if (right_constant) {
+      SelectKernels<T, CMP, false, true>(instruction);
+    } else {
+      SelectKernels<T, CMP, false, false>(instruction);
+    }
+  }
+
+  template <typename T>
+  static void SelectKernels(ComparisonType comp_type, bool left_constant, bool right_constant,
+                            Instruction *instruction) {
+    switch (comp_type) {
+      case ComparisonType::Equal:
+        return SelectKernels<T, ComparisonType::Equal>(left_constant, right_constant, instruction);
+      case ComparisonType::NotEqual:
+        return SelectKernels<T, ComparisonType::NotEqual>(left_constant, right_constant, instruction);
+      case ComparisonType::LessThan:
+        return SelectKernels<T, ComparisonType::LessThan>(left_constant, right_constant, instruction);
+      case ComparisonType::LessThanOrEqual:
+        return SelectKernels<T, ComparisonType::LessThanOrEqual>(left_constant, right_constant, instruction);
+      case ComparisonType::GreaterThan:
+        return SelectKernels<T, ComparisonType::GreaterThan>(left_constant, right_constant, instruction);
+      case ComparisonType::GreaterThanOrEqual:
+        return SelectKernels<T, ComparisonType::GreaterThanOrEqual>(left_constant, right_constant, instruction);
+    }
+  }
+
+  /**
+   * Sets the kernels of an instruction that compares two values of the given type.
+   * @return false if the type has no kernels
+   */
+  static bool SelectKernels(TypeId type, ComparisonType comp_type, bool left_constant, bool right_constant,
+                            Instruction *instruction) {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        SelectKernels<int8_t>(comp_type, left_constant, right_constant, instruction);
+        return true;
+      case TypeId::SMALLINT:
+        SelectKernels<int16_t>(comp_type, left_constant, right_constant, instruction);
+        return true;
+      case TypeId::INTEGER:
+        SelectKernels<int32_t>(comp_type, left_constant, right_constant, instruction);
+        return true;
+      case TypeId::BIGINT:
+        SelectKernels<int64_t>(comp_type, left_constant, right_constant, instruction);
+        return true;
+      case TypeId::DECIMAL:
+        SelectKernels<double>(comp_type, left_constant, right_constant, instruction);
+        return true;
+      case TypeId::TIMESTAMP:
+        SelectKernels<uint64_t>(comp_type, left_constant, right_constant, instruction);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /** @return true if values of the type can be compared by the kernels */
+  static bool HasKernels(TypeId type) {
+    Instruction instruction{};
+    return SelectKernels(type, ComparisonType::Equal, false, false, &instruction);
+  }
+
+  /** @return true if values of the type are integers that can be compared in any of the integer types */
+  static bool IsInteger(TypeId type) {
+    return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+  }
+
+  /**
+   * Converts a constant operand to the type of the other operand of its comparison, which keeps the result of the
+   * comparison unchanged as long as the constant fits into that type.
+   * @return false if the constant cannot be converted
+   */
+  static bool ConvertConstant(const Value &constant, TypeId type, Operand *operand) {
+    if (constant.GetTypeId() == type) {
+      return true;
+    }
+    if (!IsInteger(constant.GetTypeId()) || !IsInteger(type)) {
+      return false;
+    }
+    auto value = constant.CastAs(TypeId::BIGINT).GetAs<int64_t>();
+    int64_t min = BUSTUB_INT64_MIN;
+    int64_t max = BUSTUB_INT64_MAX;
+    if (type == TypeId::TINYINT) {
+      min = BUSTUB_INT8_MIN;
+      max = BUSTUB_INT8_MAX;
+    } else if (type == TypeId::SMALLINT) {
+      min = BUSTUB_INT16_MIN;
+      max = BUSTUB_INT16_MAX;
+    } else if (type == TypeId::INTEGER) {
+      min = BUSTUB_INT32_MIN;
+      max = BUSTUB_INT32_MAX;
+    }
+    if (value < min || value > max) {
+      return false;
+    }
+    constant.CastAs(type).SerializeTo(operand->constant_);
+    return true;
+  }
+
+  /**
+   * Compiles an expression, appending the instructions that compute it to the program.
+   * @param expr the expression to compile
+   * @param schema the schema of the batches
+   * @param[out] operand where the value of the expression can be read from
+   * @param[out] type the type of the value of the expression
+   * @return false if the expression cannot be compiled
+   */
+  bool CompileNode(const AbstractExpression *expr, const Schema *schema, Operand *operand, TypeId *type) {
+    if (auto column = dynamic_cast<const ColumnValueExpression *>(expr); column != nullptr) {
+      operand->kind_ = OperandKind::Column;
+      operand->idx_ = column->GetColIdx();
+      *type = schema->GetColumn(column->GetColIdx()).GetType();
+      return HasKernels(*type);
+    }
+    if (auto constant = dynamic_cast<const ConstantValueExpression *>(expr); constant != nullptr) {
+      const Value &value = constant->GetValue();
+      operand->kind_ = OperandKind::Constant;
+      *type = value.GetTypeId();
+      if (value.IsNull() || !HasKernels(*type)) {
+        return false;
+      }
+      value.SerializeTo(operand->constant_);
+      return true;
+    }
+    auto comparison = dynamic_cast<const ComparisonExpression *>(expr);
+    if (comparison == nullptr) {
+      return false;
+    }
+    Instruction instruction{};
+    TypeId left_type;
+    TypeId right_type;
+    if (!CompileNode(comparison->GetChildAt(0), schema, &instruction.left_, &left_type) ||
+        !CompileNode(comparison->GetChildAt(1), schema, &instruction.right_, &right_type)) {
+      return false;
+    }
+    // Both operands are compared in the same type, so a constant may have to be converted to the other side's type.
+    bool left_constant = instruction.left_.kind_ == OperandKind::Constant;
+    bool right_constant = instruction.right_.kind_ == OperandKind::Constant;
+    if (left_type != right_type) {
+      if (right_constant && ConvertConstant(comparison->GetChildAt(1)->Evaluate(nullptr, nullptr), left_type,
+                                            &instruction.right_)) {
+        right_type = left_type;
+      } else if (left_constant && ConvertConstant(comparison->GetChildAt(0)->Evaluate(nullptr, nullptr), right_type,
+                                                  &instruction.left_)) {
+        left_type = right_type;
+      } else {
+        return false;
+      }
+    }
+    SelectKernels(left_type, comparison->GetComparisonType(), left_constant, right_constant, &instruction);
+    instruction.result_ = num_registers_++;
+    program_.push_back(instruction);
+    operand->kind_ = OperandKind::Register;
+    operand->idx_ = instruction.result_;
+    *type = TypeId::BOOLEAN;
+    return true;
+  }
+
+  /** @return the values of an operand for the rows of the batch */
+  static const void *Resolve(const Operand &operand, const TupleBatch &batch, std::vector<int8_t> *registers) {
+    switch (operand.kind_) {
+      case OperandKind::Column:
+        return batch.GetColumn(operand.idx_).GetData<char>();
+      case OperandKind::Register:
+        return registers->data() + static_cast<size_t>(operand.idx_) * batch.GetSize();
+      case OperandKind::Constant:
+      default:
+        return operand.constant_;
+    }
+  }
+
+  /** The instructions of the program, in the order they run. */
+  std::vector<Instruction> program_;
+  /** Where the value of the whole predicate can be read from once the program has run. */
+  Operand result_;
+  /** The number of result registers that the program uses, one per instruction. */
+  uint32_t num_registers_{0};
+};
+
+}  // namespace bustub
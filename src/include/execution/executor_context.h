@@ -12,6 +12,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -19,10 +25,13 @@
 #include "catalog/simple_catalog.h"
 #include "concurrency/transaction.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "type/arena_pool.h"
 
 namespace bustub {
 /**
  * ExecutorContext stores all the context necessary to run an executor.
+ *
+ * The context lives as long as the query, and so does the memory of its pools (see GetPool()).
  */
 class ExecutorContext {
  public:
@@ -54,10 +63,62 @@ class ExecutorContext {
   /** @return the lock manager - don't worry about it for now */
   LockManager *GetLockManager() { return nullptr; }
 
+  /** @return the maximum number of worker threads an executor may use, 1 for serial execution */
+  uint32_t GetDegreeOfParallelism() const { return degree_of_parallelism_; }
+
+  /**
+   * Sets the maximum number of worker threads an executor may use.
+   * @param degree_of_parallelism the number of workers, 0 is treated as 1
+   */
+  void SetDegreeOfParallelism(uint32_t degree_of_parallelism) {
+    degree_of_parallelism_ = std::max<uint32_t>(degree_of_parallelism, 1);
+  }
+
+  /** @return the number of bytes of tuples an executor may hold in memory before it spills to disk */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  /**
+   * Sets the number of bytes of tuples an executor may hold in memory before it spills to disk.
+   * @param memory_budget the memory budget in bytes
+   */
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  /**
+   * Returns the calling thread's memory pool for this query. Values and tuples that are needed until the end of the
+   * query can be allocated from it, and are then all freed at once when the context is destroyed. Every thread gets a
+   * pool of its own, so that parallel workers never contend on an allocator.
+   * @return the calling thread's pool, which only the calling thread may allocate from
+   */
+  ArenaPool *GetPool() {
+    // Remember the last pool per thread, so that most calls do not take the latch. Contexts are told apart by a
+    // unique id rather than their address, which a later context may reuse.
+    thread_local uint64_t cached_context_id = 0;
+    thread_local ArenaPool *cached_pool = nullptr;
+    if (cached_context_id != context_id_) {
+      std::scoped_lock lock(pools_latch_);
+      auto &pool = pools_[std::this_thread::get_id()];
+      if (pool == nullptr) {
+        pool = std::make_unique<ArenaPool>();
+      }
+      cached_context_id = context_id_;
+      cached_pool = pool.get();
+    }
+    return cached_pool;
+  }
+
  private:
+  /** The id of the next context, 0 is never used. */
+  inline static std::atomic<uint64_t> next_context_id_{1};
+
+  uint64_t context_id_{next_context_id_++};
   Transaction *transaction_;
   SimpleCatalog *catalog_;
   BufferPoolManager *bpm_;
+  uint32_t degree_of_parallelism_{1};
+  size_t memory_budget_{EXECUTOR_MEMORY_BUDGET};
+  /** The memory pools of the threads that run this query. */
+  std::unordered_map<std::thread::id, std::unique_ptr<ArenaPool>> pools_;
+  std::mutex pools_latch_;
 };
 
 }  // namespace bustub
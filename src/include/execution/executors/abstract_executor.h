@@ -12,12 +12,22 @@
 
 #pragma once
 
+#include <vector>
+
+#include "container/hash/blocked_bloom_filter.h"
 #include "execution/executor_context.h"
+#include "execution/expressions/abstract_expression.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+#include "storage/table/tuple_view.h"
 
 namespace bustub {
 /**
  * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * Executors can additionally produce tuples a batch at a time through NextBatch(), which amortizes the virtual call
+ * and per-tuple allocation over up to TUPLE_BATCH_SIZE rows, and through NextView(), which lets a consumer read a
+ * tuple where the executor already has it. A consumer should use only one of Next(), NextBatch() and NextView() on a
+ * given executor.
  */
 class AbstractExecutor {
  public:
@@ -43,6 +53,49 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple) = 0;
 
+  /**
+   * Produces the next batch of tuples from this executor.
+   * The default implementation adapts Next() by collecting tuples until the batch is full; executors that can produce
+   * batches more cheaply should override it.
+   * @param[out] batch the batch to fill, its schema must be the output schema of this executor
+   * @return true if at least one tuple was produced, false if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Reset();
+    Tuple tuple;
+    while (!batch->IsFull() && Next(&tuple)) {
+      batch->AppendTuple(tuple);
+    }
+    return !batch->IsEmpty();
+  }
+
+  /**
+   * Produces the next tuple from this executor as a view, which stays valid until the next call to this executor.
+   * The default implementation produces the tuple with Next() into a buffer owned by the executor; executors that
+   * already hold their output tuples, such as a scan over table pages, should override it to avoid that copy.
+   * @param[out] view a view of the next tuple produced by this executor
+   * @return true if a tuple was produced, false if there are no more tuples
+   */
+  virtual bool NextView(TupleView *view) {
+    if (!Next(&view_buffer_)) {
+      return false;
+    }
+    *view = TupleView(view_buffer_);
+    return true;
+  }
+
+  /**
+   * Pushes a Bloom filter over join keys down into this executor. An executor that accepts the filter may drop any
+   * row whose join key, evaluated by keys against its output schema, is not in the filter. The filter must outlive
+   * the executor's use of it, and must be pushed down before Init().
+   * @param filter the Bloom filter over JoinKey hashes
+   * @param keys the join key expressions over the output schema of this executor
+   * @return true if the executor applies the filter, false if it ignores it
+   */
+  virtual bool PushDownBloomFilter(const BlockedBloomFilter *filter, const std::vector<const AbstractExpression *> &keys) {
+    return false;
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
@@ -51,5 +104,9 @@ class AbstractExecutor {
 
  protected:
   ExecutorContext *exec_ctx_;
+
+ private:
+  /** The tuple that the default NextView() produces views of. */
+  Tuple view_buffer_;
 };
 }  // namespace bustub
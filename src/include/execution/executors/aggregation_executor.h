@@ -12,17 +12,24 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/exception.h"
 #include "common/util/hash_util.h"
+#include "common/util/parallel_util.h"
 #include "container/hash/hash_function.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/flat_aggregation_hash_table.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 
@@ -64,7 +71,7 @@ class SimpleAggregationHashTable {
           break;
       }
     }
-    return {values};
+    return {std::move(values)};
   }
 
   /** Combines the input into the aggregation result. */
@@ -91,16 +98,81 @@ class SimpleAggregationHashTable {
     }
   }
 
+  /**
+   * Merges a partial aggregation result, e.g. from another hash table over a different part of the input, into the
+   * aggregation result. Unlike CombineAggregateValues(), counts are added up rather than incremented.
+   */
+  void MergeAggregateValues(AggregateValue *result, const AggregateValue &partial) {
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      switch (agg_types_[i]) {
+        case AggregationType::CountAggregate:
+        case AggregationType::SumAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Add(partial.aggregates_[i]);
+          break;
+        case AggregationType::MinAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Min(partial.aggregates_[i]);
+          break;
+        case AggregationType::MaxAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Max(partial.aggregates_[i]);
+          break;
+      }
+    }
+  }
+
   /**
    * Inserts a value into the hash table and then combines it with the current aggregation.
    * @param agg_key the key to be inserted
    * @param agg_val the value to be inserted
    */
   void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht.count(agg_key) == 0) {
-      ht.insert({agg_key, GenerateInitialAggregateValue()});
+    auto iter = ht.find(agg_key);
+    if (iter == ht.end()) {
+      iter = ht.emplace(agg_key, GenerateInitialAggregateValue()).first;
     }
-    CombineAggregateValues(&ht[agg_key], agg_val);
+    CombineAggregateValues(&iter->second, agg_val);
+  }
+
+  /**
+   * Combines a value into the current aggregation of its group, but only if the group is already in the hash table.
+   * @param agg_key the key of the group
+   * @param agg_val the value to be combined
+   * @return true if the group was found
+   */
+  bool CombineExisting(const AggregateKey &agg_key, const AggregateValue &agg_val) {
+    auto iter = ht.find(agg_key);
+    if (iter == ht.end()) {
+      return false;
+    }
+    CombineAggregateValues(&iter->second, agg_val);
+    return true;
+  }
+
+  /** @return the number of groups in the hash table */
+  size_t Size() const { return ht.size(); }
+
+  /**
+   * Merges a partial aggregation result of a group into the hash table.
+   * @param agg_key the key of the group
+   * @param partial the partial aggregation result of the group
+   */
+  void MergePartial(const AggregateKey &agg_key, AggregateValue &&partial) {
+    auto iter = ht.find(agg_key);
+    if (iter == ht.end()) {
+      ht.emplace(agg_key, std::move(partial));
+    } else {
+      MergeAggregateValues(&iter->second, partial);
+    }
+  }
+
+  /**
+   * Merges every group of another hash table over the same aggregation into this one.
+   * @param other the hash table to be merged, left in an unspecified state
+   */
+  void MergeFrom(SimpleAggregationHashTable *other) {
+    for (auto &[agg_key, partial] : other->ht) {
+      MergePartial(agg_key, std::move(partial));
+    }
+    other->ht.clear();
   }
 
   /**
@@ -151,6 +223,22 @@ class SimpleAggregationHashTable {
 
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX) on the tuples of a child executor.
+ *
+ * If the executor context allows more than one worker, the aggregation runs in two phases. First, every worker pulls
+ * batches from the child and pre-aggregates them into its own hash tables, one for each of NUM_PARTITIONS partitions
+ * of the group-by hash. Then the workers merge the tables of each partition independently. Groups come out partition
+ * by partition. If the groups of all workers together exceed the memory budget, the workers stop, their groups are
+ * merged into a single hash table, and the rest of the child is aggregated serially.
+ *
+ * A serial aggregation whose group-by keys are integers and whose aggregate inputs are INTEGERs first aggregates into
+ * a FlatAggregationHashTable, which works on raw 64-bit words instead of boxed Values. It hands its groups over to
+ * the regular hash table once the child is drained, or earlier if it meets a NULL or exceeds the memory budget.
+ *
+ * A serial aggregation only adds groups to its hash table while the table fits in the context's memory budget. Past
+ * the budget, rows of groups that are already in the table are still aggregated in memory, but rows of new groups are
+ * hash-partitioned into TmpTupleRuns. Once the in-memory groups have been produced, every spilled partition is read
+ * back, aggregated and produced on its own. A spilled partition with more groups than the budget allows is split the
+ * same way, on the next bits of the group-by hash.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -173,33 +261,74 @@ class AggregationExecutor : public AbstractExecutor {
 
   void Init() override {
     child_->Init();
-    Tuple tuple;
-    while (child_->Next(&tuple)) {
-      AggregateKey aggregate_key = MakeKey(&tuple);
-      AggregateValue aggregate_value = MakeVal(&tuple);
-      aht_.InsertCombine(aggregate_key, aggregate_value);
+    spill_runs_.clear();
+    spill_levels_.clear();
+    size_t max_groups = exec_ctx_->GetMemoryBudget() / EstimateGroupSize();
+    uint32_t num_workers = exec_ctx_->GetDegreeOfParallelism();
+    std::vector<std::unique_ptr<TupleBatch>> pending_batches;
+    std::vector<uint32_t> pending_rows;
+    parallel_ = num_workers > 1 && ParallelAggregate(num_workers, max_groups, &pending_batches, &pending_rows);
+    if (parallel_) {
+      return;
+    }
+    auto aggregate_rows = [&](const TupleBatch *batch, uint32_t begin) {
+      for (uint32_t i = begin; i < batch->GetSize(); i++) {
+        AggregateKey agg_key = MakeKey(batch, i);
+        AggregateValue agg_val = MakeVal(batch, i);
+        if (aht_.CombineExisting(agg_key, agg_val)) {
+          continue;
+        }
+        if (aht_.Size() < max_groups) {
+          aht_.InsertCombine(agg_key, agg_val);
+        } else {
+          Spill(agg_key, agg_val, 0, 0);
+        }
+      }
+    };
+    // Finish the rows that a parallel aggregation pulled from the child before it gave up.
+    for (size_t worker = 0; worker < pending_batches.size(); worker++) {
+      aggregate_rows(pending_batches[worker].get(), pending_rows[worker]);
     }
+    // Drain the child a batch at a time.
+    TupleBatch batch(child_->GetOutputSchema());
+    uint32_t resume_row = 0;
+    bool drained = pending_batches.empty() && CanUseFlatTable() && FlatAggregate(&batch, max_groups, &resume_row);
+    if (!drained) {
+      aggregate_rows(&batch, resume_row);
+      while (child_->NextBatch(&batch)) {
+        aggregate_rows(&batch, 0);
+      }
+    }
+    current_table_ = &aht_;
     aht_iterator_ = aht_.Begin();
+    spill_partition_ = 0;
   }
 
   bool Next(Tuple *tuple) override {
-    while (aht_iterator_ != aht_.End()) {
-      auto group_bys = aht_iterator_.Key().group_bys_;
-      auto aggregates = aht_iterator_.Val().aggregates_;
-      if (!plan_->GetHaving() || plan_->GetHaving()->EvaluateAggregate(group_bys, aggregates).GetAs<bool>()) {
-        std::vector<Value> out_vec;
-        int count = plan_->OutputSchema()->GetColumnCount();
-        for (int i=0; i < count; i++) {
-          out_vec.push_back(plan_->OutputSchema()->GetColumn(i).GetExpr()->EvaluateAggregate(group_bys, aggregates));
-        }
-        *tuple = Tuple(out_vec, plan_->OutputSchema());
+    while (HasGroup()) {
+      const auto &group_bys = aht_iterator_.Key().group_bys_;
+      const auto &aggregates = aht_iterator_.Val().aggregates_;
+      if (SatisfiesHaving(group_bys, aggregates)) {
+        *tuple = Tuple(MakeOutput(group_bys, aggregates), plan_->OutputSchema());
         ++aht_iterator_;
         return true;
       }
       ++aht_iterator_;
     }
     return false;
+  }
 
+  bool NextBatch(TupleBatch *batch) override {
+    batch->Reset();
+    while (!batch->IsFull() && HasGroup()) {
+      const auto &group_bys = aht_iterator_.Key().group_bys_;
+      const auto &aggregates = aht_iterator_.Val().aggregates_;
+      if (SatisfiesHaving(group_bys, aggregates)) {
+        batch->AppendValues(MakeOutput(group_bys, aggregates));
+      }
+      ++aht_iterator_;
+    }
+    return !batch->IsEmpty();
   }
 
   /** @return the tuple as an AggregateKey */
@@ -208,7 +337,16 @@ class AggregationExecutor : public AbstractExecutor {
     for (const auto &expr : plan_->GetGroupBys()) {
       keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
     }
-    return {keys};
+    return {std::move(keys)};
+  }
+
+  /** @return the row_idx'th row of the batch as an AggregateKey */
+  AggregateKey MakeKey(const TupleBatch *batch, uint32_t row_idx) {
+    std::vector<Value> keys;
+    for (const auto &expr : plan_->GetGroupBys()) {
+      keys.emplace_back(expr->EvaluateAt(batch, row_idx));
+    }
+    return {std::move(keys)};
   }
 
   /** @return the tuple as an AggregateValue */
@@ -217,10 +355,332 @@ class AggregationExecutor : public AbstractExecutor {
     for (const auto &expr : plan_->GetAggregates()) {
       vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
     }
-    return {vals};
+    return {std::move(vals)};
+  }
+
+  /** @return the row_idx'th row of the batch as an AggregateValue */
+  AggregateValue MakeVal(const TupleBatch *batch, uint32_t row_idx) {
+    std::vector<Value> vals;
+    for (const auto &expr : plan_->GetAggregates()) {
+      vals.emplace_back(expr->EvaluateAt(batch, row_idx));
+    }
+    return {std::move(vals)};
   }
 
  private:
+  /** @return true if every group-by key is an integer and every aggregate input is an INTEGER */
+  bool CanUseFlatTable() const {
+    for (const auto *expr : plan_->GetGroupBys()) {
+      auto type = expr->GetReturnType();
+      if (type != TypeId::TINYINT && type != TypeId::SMALLINT && type != TypeId::INTEGER && type != TypeId::BIGINT) {
+        return false;
+      }
+    }
+    for (const auto *expr : plan_->GetAggregates()) {
+      if (expr->GetReturnType() != TypeId::INTEGER) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Evaluates expressions on a row of a batch into 64-bit words.
+   * @param exprs the expressions, all returning integers
+   * @param batch the batch
+   * @param row_idx the row
+   * @param[out] words one word per expression
+   * @return false if an expression evaluated to NULL
+   */
+  static bool EvaluateWords(const std::vector<const AbstractExpression *> &exprs, const TupleBatch *batch,
+                            uint32_t row_idx, int64_t *words) {
+    for (size_t i = 0; i < exprs.size(); i++) {
+      Value val = exprs[i]->EvaluateAt(batch, row_idx);
+      if (val.IsNull()) {
+        return false;
+      }
+      switch (val.GetTypeId()) {
+        case TypeId::TINYINT:
+          words[i] = val.GetAs<int8_t>();
+          break;
+        case TypeId::SMALLINT:
+          words[i] = val.GetAs<int16_t>();
+          break;
+        case TypeId::INTEGER:
+          words[i] = val.GetAs<int32_t>();
+          break;
+        default:
+          words[i] = val.GetAs<int64_t>();
+          break;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Aggregates the child's rows into a FlatAggregationHashTable, then merges its groups into aht_.
+   * @param batch the batch to pull the child's rows into
+   * @param max_groups the number of groups that fit in the memory budget
+   * @param[out] resume_row if the child was not drained, the first row of the batch that was not aggregated
+   * @return true if every row of the child was aggregated, false if the flat table gave up on a NULL or on a group
+   * past the memory budget
+   */
+  bool FlatAggregate(TupleBatch *batch, size_t max_groups, uint32_t *resume_row) {
+    const auto &group_bys = plan_->GetGroupBys();
+    const auto &aggregates = plan_->GetAggregates();
+    FlatAggregationHashTable table(group_bys.size(), plan_->GetAggregateTypes());
+    std::vector<int64_t> key(group_bys.size());
+    std::vector<int64_t> inputs(aggregates.size());
+    bool drained = true;
+    while (drained && child_->NextBatch(batch)) {
+      for (uint32_t i = 0; i < batch->GetSize(); i++) {
+        // Not knowing whether the row starts a new group, stop as soon as one more group could exceed the budget.
+        if (table.Size() >= max_groups || !EvaluateWords(group_bys, batch, i, key.data()) ||
+            !EvaluateWords(aggregates, batch, i, inputs.data())) {
+          *resume_row = i;
+          drained = false;
+          break;
+        }
+        table.InsertCombine(key.data(), table.Hash(key.data()), inputs.data());
+      }
+    }
+
+    const auto &agg_types = plan_->GetAggregateTypes();
+    table.ForEach([&](const int64_t *key_words, const int64_t *accumulators) {
+      AggregateKey agg_key;
+      for (size_t i = 0; i < group_bys.size(); i++) {
+        agg_key.group_bys_.emplace_back(group_bys[i]->GetReturnType(), key_words[i]);
+      }
+      AggregateValue agg_val;
+      for (size_t i = 0; i < agg_types.size(); i++) {
+        if (accumulators[i] < BUSTUB_INT32_MIN || accumulators[i] > BUSTUB_INT32_MAX) {
+          throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+        }
+        agg_val.aggregates_.emplace_back(ValueFactory::GetIntegerValue(static_cast<int32_t>(accumulators[i])));
+      }
+      aht_.MergePartial(agg_key, std::move(agg_val));
+    });
+    return drained;
+  }
+
+  /**
+   * @return a rough estimate of the memory taken by one group in the hash table, counting its values and the hash
+   * table node, but not the data of variable-length values
+   */
+  size_t EstimateGroupSize() const {
+    size_t num_values = plan_->GetGroupBys().size() + plan_->GetAggregates().size();
+    return sizeof(AggregateKey) + sizeof(AggregateValue) + num_values * sizeof(Value) + 4 * sizeof(void *);
+  }
+
+  /**
+   * Appends a row of a group that does not fit in memory to the spill partition of its group.
+   * @param agg_key the group-by values of the row
+   * @param agg_val the aggregate input values of the row
+   * @param first_run the index in spill_runs_ of the first of the NUM_SPILL_PARTITIONS partitions to spill into, which
+   * are created if spill_runs_ ends there
+   * @param level how many times the rows have been partitioned before
+   */
+  void Spill(const AggregateKey &agg_key, const AggregateValue &agg_val, size_t first_run, uint32_t level) {
+    if (spill_schema_ == nullptr) {
+      // Spilled rows are stored as tuples of their group-by values followed by their aggregate input values.
+      std::vector<Column> columns;
+      auto add_column = [&columns](const AbstractExpression *expr) {
+        if (expr->GetReturnType() == TypeId::VARCHAR) {
+          columns.emplace_back("spill", TypeId::VARCHAR, MAX_SPILL_VARCHAR_SIZE);
+        } else {
+          columns.emplace_back("spill", expr->GetReturnType());
+        }
+      };
+      for (const auto *expr : plan_->GetGroupBys()) {
+        add_column(expr);
+      }
+      for (const auto *expr : plan_->GetAggregates()) {
+        add_column(expr);
+      }
+      spill_schema_ = std::make_unique<Schema>(columns);
+    }
+    if (spill_runs_.size() == first_run) {
+      for (uint32_t p = 0; p < NUM_SPILL_PARTITIONS; p++) {
+        spill_runs_.emplace_back(std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager()));
+        spill_levels_.push_back(level);
+      }
+    }
+    std::vector<Value> values(agg_key.group_bys_);
+    values.insert(values.end(), agg_val.aggregates_.begin(), agg_val.aggregates_.end());
+    // Every level of partitioning uses the next low hash bits, so that a partition that is split again spreads out.
+    auto hash = std::hash<AggregateKey>{}(agg_key) >> (level * SPILL_PARTITION_BITS);
+    auto partition = static_cast<uint32_t>(hash % NUM_SPILL_PARTITIONS);
+    Tuple tuple(values, spill_schema_.get());
+    if (!TmpTupleRun::Fits(tuple)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "aggregation cannot spill: row is larger than a page");
+    }
+    if (!spill_runs_[first_run + partition]->Append(tuple)) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "aggregation cannot spill: all pages are pinned");
+    }
+  }
+
+  /**
+   * Aggregates the given spill partition into spill_table_ and deletes the partition's pages. Rows of groups past the
+   * memory budget are split into new partitions at the end of spill_runs_, unless the hash bits are used up.
+   */
+  void LoadSpillPartition(size_t partition) {
+    spill_table_ = std::make_unique<SimpleAggregationHashTable>(plan_->GetAggregates(), plan_->GetAggregateTypes());
+    // At least one group is loaded, so that every partition makes progress.
+    size_t max_groups = std::max<size_t>(exec_ctx_->GetMemoryBudget() / EstimateGroupSize(), 1);
+    uint32_t level = spill_levels_[partition] + 1;
+    bool can_split = level < MAX_SPILL_LEVELS;
+    size_t first_run = spill_runs_.size();
+    uint32_t num_group_bys = plan_->GetGroupBys().size();
+    uint32_t num_values = spill_schema_->GetColumnCount();
+    // Splitting appends to spill_runs_, so hold on to the run itself.
+    TmpTupleRun *run = spill_runs_[partition].get();
+    std::vector<Tuple> tuples;
+    for (size_t page_idx = 0; page_idx < run->GetPageCount(); page_idx++) {
+      tuples.clear();
+      run->ReadPage(page_idx, &tuples);
+      for (const auto &tuple : tuples) {
+        AggregateKey agg_key;
+        AggregateValue agg_val;
+        for (uint32_t i = 0; i < num_values; i++) {
+          auto &values = i < num_group_bys ? agg_key.group_bys_ : agg_val.aggregates_;
+          values.emplace_back(tuple.GetValue(spill_schema_.get(), i));
+        }
+        if (spill_table_->CombineExisting(agg_key, agg_val)) {
+          continue;
+        }
+        if (spill_table_->Size() < max_groups || !can_split) {
+          spill_table_->InsertCombine(agg_key, agg_val);
+        } else {
+          Spill(agg_key, agg_val, first_run, level);
+        }
+      }
+    }
+    run->Clear();
+  }
+
+  /**
+   * Runs both phases of a parallel aggregation, leaving the merged groups in partitions_.
+   * @param num_workers the number of workers
+   * @param max_groups the number of groups that fit in the memory budget, counted over the tables of all workers
+   * @param[out] pending_batches if the groups exceed the budget, the last batch that every worker pulled
+   * @param[out] pending_rows if the groups exceed the budget, the first row of every pending batch that was not
+   * aggregated
+   * @return false if the groups exceed the budget, in which case the groups aggregated so far are merged into aht_
+   */
+  bool ParallelAggregate(uint32_t num_workers, size_t max_groups,
+                         std::vector<std::unique_ptr<TupleBatch>> *pending_batches,
+                         std::vector<uint32_t> *pending_rows) {
+    // Phase 1: thread-local pre-aggregation. The child is not thread-safe, so the workers take turns pulling batches.
+    std::vector<std::vector<SimpleAggregationHashTable>> local_tables(num_workers);
+    pending_batches->clear();
+    for (uint32_t worker = 0; worker < num_workers; worker++) {
+      pending_batches->emplace_back(std::make_unique<TupleBatch>(child_->GetOutputSchema()));
+    }
+    pending_rows->assign(num_workers, 0);
+    std::mutex child_latch;
+    std::atomic<size_t> num_groups{0};
+    std::atomic<bool> over_budget{false};
+    ParallelUtil::ParallelFor(num_workers, num_workers, [&](size_t worker) {
+      auto &tables = local_tables[worker];
+      tables.reserve(NUM_PARTITIONS);
+      for (uint32_t p = 0; p < NUM_PARTITIONS; p++) {
+        tables.emplace_back(plan_->GetAggregates(), plan_->GetAggregateTypes());
+      }
+      TupleBatch *batch = (*pending_batches)[worker].get();
+      while (!over_budget) {
+        {
+          std::scoped_lock latch{child_latch};
+          if (!child_->NextBatch(batch)) {
+            break;
+          }
+        }
+        uint32_t i = 0;
+        for (; i < batch->GetSize(); i++) {
+          AggregateKey agg_key = MakeKey(batch, i);
+          AggregateValue agg_val = MakeVal(batch, i);
+          auto &table = tables[PartitionOf(agg_key)];
+          if (table.CombineExisting(agg_key, agg_val)) {
+            continue;
+          }
+          if (num_groups++ >= max_groups) {
+            over_budget = true;
+            break;
+          }
+          table.InsertCombine(agg_key, agg_val);
+        }
+        (*pending_rows)[worker] = i;
+      }
+    });
+    if (over_budget) {
+      for (auto &tables : local_tables) {
+        for (auto &table : tables) {
+          aht_.MergeFrom(&table);
+        }
+      }
+      return false;
+    }
+
+    // Phase 2: partition-wise merge. Every partition is merged by a single worker.
+    partitions_.clear();
+    partitions_.reserve(NUM_PARTITIONS);
+    for (uint32_t p = 0; p < NUM_PARTITIONS; p++) {
+      partitions_.emplace_back(plan_->GetAggregates(), plan_->GetAggregateTypes());
+    }
+    ParallelUtil::ParallelFor(num_workers, NUM_PARTITIONS, [&](size_t p) {
+      for (auto &tables : local_tables) {
+        partitions_[p].MergeFrom(&tables[p]);
+      }
+    });
+    partition_idx_ = 0;
+    current_table_ = &partitions_[0];
+    aht_iterator_ = current_table_->Begin();
+    return true;
+  }
+
+  /** @return the partition of a group; the top bits are used so that partitions do not skew buckets */
+  static uint32_t PartitionOf(const AggregateKey &agg_key) {
+    return static_cast<uint32_t>(std::hash<AggregateKey>{}(agg_key) >> (64 - PARTITION_BITS));
+  }
+
+  /**
+   * @return true if aht_iterator_ points at a group, moving on to the next hash table (the next partition of a
+   * parallel aggregation, or the next spilled partition) when one is used up
+   */
+  bool HasGroup() {
+    while (aht_iterator_ == current_table_->End()) {
+      if (parallel_) {
+        if (partition_idx_ + 1 == partitions_.size()) {
+          return false;
+        }
+        current_table_ = &partitions_[++partition_idx_];
+      } else {
+        if (spill_partition_ == spill_runs_.size()) {
+          return false;
+        }
+        LoadSpillPartition(spill_partition_++);
+        current_table_ = spill_table_.get();
+      }
+      aht_iterator_ = current_table_->Begin();
+    }
+    return true;
+  }
+
+  /** @return true if the group satisfies the having clause, or if there is no having clause */
+  bool SatisfiesHaving(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) {
+    return !plan_->GetHaving() || plan_->GetHaving()->EvaluateAggregate(group_bys, aggregates).GetAs<bool>();
+  }
+
+  /** @return the output values of the group */
+  std::vector<Value> MakeOutput(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) {
+    std::vector<Value> out_vec;
+    uint32_t count = plan_->OutputSchema()->GetColumnCount();
+    out_vec.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+      out_vec.push_back(plan_->OutputSchema()->GetColumn(i).GetExpr()->EvaluateAggregate(group_bys, aggregates));
+    }
+    return out_vec;
+  }
+
   /** The aggregation plan node. */
   const AggregationPlanNode *plan_;
   /** The child executor whose tuples we are aggregating. */
@@ -231,5 +691,35 @@ class AggregationExecutor : public AbstractExecutor {
   /** Simple aggregation hash table iterator. */
   // Uncomment me! SimpleAggregationHashTable::Iterator aht_iterator_;
   SimpleAggregationHashTable::Iterator aht_iterator_;
+
+  /** The number of group-by hash bits used to partition a parallel aggregation, and the number of partitions. */
+  static constexpr uint32_t PARTITION_BITS = 6;
+  static constexpr uint32_t NUM_PARTITIONS = 1U << PARTITION_BITS;
+  /** True if the aggregation ran on multiple workers. */
+  bool parallel_{false};
+  /** The merged groups of a parallel aggregation, one hash table per partition. */
+  std::vector<SimpleAggregationHashTable> partitions_;
+  /** The partition that aht_iterator_ iterates over. */
+  size_t partition_idx_{0};
+  /** The hash table that aht_iterator_ iterates over. */
+  SimpleAggregationHashTable *current_table_{&aht_};
+
+  /** The number of partitions that a serial aggregation spills new groups into once it exceeds its memory budget. */
+  static constexpr uint32_t SPILL_PARTITION_BITS = 4;
+  static constexpr uint32_t NUM_SPILL_PARTITIONS = 1U << SPILL_PARTITION_BITS;
+  /** The number of times spilled rows can be partitioned before the bits of the group-by hash are used up. */
+  static constexpr uint32_t MAX_SPILL_LEVELS = 64 / SPILL_PARTITION_BITS;
+  /** The maximum length of a spilled VARCHAR value. */
+  static constexpr uint32_t MAX_SPILL_VARCHAR_SIZE = 128;
+  /** The partitions of spilled rows, empty if the aggregation fits in memory. */
+  std::vector<std::unique_ptr<TmpTupleRun>> spill_runs_;
+  /** How many times the rows of every spill partition have been partitioned before. */
+  std::vector<uint32_t> spill_levels_;
+  /** The schema of spilled rows: the group-by values followed by the aggregate input values. */
+  std::unique_ptr<Schema> spill_schema_;
+  /** The groups of the spill partition that is being produced. */
+  std::unique_ptr<SimpleAggregationHashTable> spill_table_;
+  /** The next spill partition to be aggregated. */
+  size_t spill_partition_{0};
 };
 }  // namespace bustub
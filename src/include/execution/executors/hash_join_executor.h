@@ -12,22 +12,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/exception.h"
 #include "common/util/hash_util.h"
+#include "common/util/parallel_util.h"
+#include "container/hash/blocked_bloom_filter.h"
 #include "container/hash/hash_function.h"
 #include "container/hash/linear_probe_hash_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/join_key.h"
 #include "execution/plans/hash_join_plan.h"
 #include "storage/index/hash_comparator.h"
 #include "storage/table/tmp_tuple.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "storage/table/tuple.h"
+#include "type/arena_pool.h"
 
 namespace bustub {
 /**
@@ -44,7 +52,8 @@ class IdentityHashFunction : public HashFunction<hash_t> {
 };
 
 /**
- * A simple hash table that supports hash joins.
+ * A simple hash table that supports hash joins. Tuples are stored together with the bytes of their join key, so that
+ * lookups only return tuples whose key is really equal to the probe key and not just its hash.
  */
 class SimpleHashJoinHashTable {
  public:
@@ -53,27 +62,53 @@ class SimpleHashJoinHashTable {
                           const IdentityHashFunction &hash_fn) {}
 
   /**
-   * Inserts a (hash key, tuple) pair into the hash table.
+   * Inserts a (join key, tuple) pair into the hash table.
    * @param txn the transaction that we execute in
-   * @param h the hash key
+   * @param key the join key
    * @param t the tuple to associate with the key
    * @return true if the insert succeeded
    */
-  bool Insert(Transaction *txn, hash_t h, const Tuple &t) {
-    hash_table_[h].emplace_back(t);
+  bool Insert(Transaction *txn, const JoinKey &key, const Tuple &t) {
+    hash_table_[key.hash_].emplace_back(key.bytes_, t);
     return true;
   }
 
   /**
-   * Gets the values in the hash table that match the given hash key.
+   * Gets the tuples in the hash table whose join key equals the given key.
    * @param txn the transaction that we execute in
-   * @param h the hash key
-   * @param[out] t the list of tuples that matched the key
+   * @param key the join key
+   * @param[out] t the tuples that matched the key are appended here; they stay valid until the table is modified
    */
-  void GetValue(Transaction *txn, hash_t h, std::vector<Tuple> *t) { *t = hash_table_[h]; }
+  void GetValue(Transaction *txn, const JoinKey &key, std::vector<const Tuple *> *t) const {
+    auto iter = hash_table_.find(key.hash_);
+    if (iter == hash_table_.end()) {
+      return;
+    }
+    for (const auto &[bytes, tuple] : iter->second) {
+      if (bytes == key.bytes_) {
+        t->push_back(&tuple);
+      }
+    }
+  }
+
+  /**
+   * Calls f(h, t) for every tuple in the hash table.
+   * @param f the function to call with each hash key and tuple
+   */
+  template <typename F>
+  void ForEach(F f) const {
+    for (const auto &[h, entries] : hash_table_) {
+      for (const auto &entry : entries) {
+        f(h, entry.second);
+      }
+    }
+  }
+
+  /** Removes every tuple from the hash table. */
+  void Clear() { hash_table_.clear(); }
 
  private:
-  std::unordered_map<hash_t, std::vector<Tuple>> hash_table_;
+  std::unordered_map<hash_t, std::vector<std::pair<std::string, Tuple>>> hash_table_;
 };
 
 // TODO(student): when you are ready to attempt task 3, replace the using declaration!
@@ -85,6 +120,19 @@ using HT = SimpleHashJoinHashTable;
 
 /**
  * HashJoinExecutor executes hash join operations.
+ *
+ * If the executor context allows more than one worker, the build side is radix-partitioned: it is split into
+ * NUM_PARTITIONS partitions on the top bits of its key hashes, and the workers build the hash table of each partition
+ * independently in Init(). The probe side is then streamed a chunk of one batch per worker at a time: the workers
+ * probe the batches of a chunk in parallel, and the joined rows of that chunk are produced before the next chunk is
+ * read. Joined tuples come out in no particular order.
+ *
+ * The build side is held in memory only up to the context's memory budget. A parallel join whose build side exceeds
+ * the budget is carried on by a serial join instead. Once a serial join exceeds the budget, it turns into a grace hash
+ * join: both inputs are partitioned into TmpTupleRuns on disk, and the partitions are then joined one at a time with
+ * only one partition of the build side in memory.
+ *
+ * Either way, a Bloom filter over the build side's join keys is pushed down into the probe side before it starts.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -107,37 +155,120 @@ class HashJoinExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
   void Init() override {
+    // The probe side is only initialized once the build side is done, so that it can use the Bloom filter.
     left_exec_->Init();
+    jht_.Clear();
+    build_pool_.Reset();
+    build_runs_.clear();
+    probe_runs_.clear();
+    partition_tables_.clear();
+    results_.clear();
+    result_idx_ = 0;
+    result_row_idx_ = 0;
+    num_workers_ = exec_ctx_->GetDegreeOfParallelism();
+    std::vector<std::unique_ptr<TupleBatch>> left_batches;
+    parallel_ = num_workers_ > 1 && ParallelBuild(&left_batches);
+    if (parallel_) {
+      right_exec_->PushDownBloomFilter(bloom_filter_.get(), plan_->GetRightKeys());
+      right_exec_->Init();
+      return;
+    }
+    // Build the hash table a batch at a time, starting with any batches that a parallel build gave up on. Tuples are
+    // stored in the left child's output schema.
+    build_used_ = 0;
+    build_hashes_.clear();
+    for (auto &batch : left_batches) {
+      BuildBatch(batch.get());
+      batch.reset();
+    }
+    TupleBatch batch(left_exec_->GetOutputSchema());
+    while (left_exec_->NextBatch(&batch)) {
+      BuildBatch(&batch);
+    }
+    if (!IsSpilled()) {
+      BuildBloomFilter(build_hashes_.size(), build_hashes_);
+    }
+    std::vector<hash_t>().swap(build_hashes_);
+    right_exec_->PushDownBloomFilter(bloom_filter_.get(), plan_->GetRightKeys());
     right_exec_->Init();
-    Tuple tuple;
-    auto left_schema = left_exec_->GetOutputSchema();
-    while (left_exec_->Next(&tuple)) {
-      auto h = plan_->GetLeftKeyAt(0)->Evaluate(&tuple, left_schema).GetAs<int>();
-      jht_.Insert(exec_ctx_->GetTransaction(), h, tuple);
+    if (IsSpilled()) {
+      SpillProbeSide();
     }
+    right_batch_ = std::make_unique<TupleBatch>(right_exec_->GetOutputSchema());
+    right_idx_ = 0;
+    matches_.clear();
+    match_idx_ = 0;
   }
 
   bool Next(Tuple *tuple) override {
-    Tuple tuple1;
+    if (parallel_) {
+      if (!FetchResultRow()) {
+        return false;
+      }
+      *tuple = results_[result_idx_]->GetTuple(result_row_idx_++);
+      return true;
+    }
     auto left_schema = left_exec_->GetOutputSchema();
     auto right_schema = right_exec_->GetOutputSchema();
-    while (right_exec_->Next(&tuple1)) {
-      std::vector<Tuple> join_vec;
-      auto h = plan_->GetRightKeyAt(0)->Evaluate(&tuple1, right_schema).GetAs<int>();
-      jht_.GetValue(exec_ctx_->GetTransaction(), h, &join_vec);
-      for (auto tuple2 : join_vec) {
-        if (plan_->Predicate()->EvaluateJoin(&tuple2, left_schema, &tuple1, right_schema).GetAs<bool>()) {
-          std::vector<Value> out_vec;
-          int count = plan_->OutputSchema()->GetColumnCount();
-          for (int i = 0; i < count; i++) {
-            out_vec.push_back(plan_->OutputSchema()->GetColumn(i).GetExpr()->EvaluateJoin(&tuple2, left_schema, &tuple1, right_schema));
-          }
-          *tuple = Tuple(out_vec, plan_->OutputSchema());
+    while (true) {
+      // Join the current probe tuple with its remaining matches, one output tuple per call.
+      while (match_idx_ < matches_.size()) {
+        const Tuple *build_tuple = matches_[match_idx_++];
+        if (plan_->Predicate()->EvaluateJoin(build_tuple, left_schema, &probe_tuple_, right_schema).GetAs<bool>()) {
+          *tuple = Tuple(MakeOutput(build_tuple, &probe_tuple_), plan_->OutputSchema());
           return true;
         }
       }
+      if (!(IsSpilled() ? NextSpilledProbeTuple(&probe_tuple_) : right_exec_->Next(&probe_tuple_))) {
+        return false;
+      }
+      matches_.clear();
+      match_idx_ = 0;
+      JoinKey key;
+      if (EvaluateKey(&probe_tuple_, right_schema, plan_->GetRightKeys(), &key)) {
+        jht_.GetValue(exec_ctx_->GetTransaction(), key, &matches_);
+      }
     }
-    return false;
+  }
+
+  bool NextBatch(TupleBatch *batch) override {
+    batch->Reset();
+    if (parallel_) {
+      while (!batch->IsFull() && FetchResultRow()) {
+        batch->AppendRow(*results_[result_idx_], result_row_idx_++);
+      }
+      return !batch->IsEmpty();
+    }
+    auto left_schema = left_exec_->GetOutputSchema();
+    auto right_schema = right_exec_->GetOutputSchema();
+    while (!batch->IsFull()) {
+      if (match_idx_ == matches_.size()) {
+        // Advance to the next probe row, pulling a new batch from the right child once this one is used up.
+        if (right_idx_ >= right_batch_->GetSize()) {
+          if (!(IsSpilled() ? NextSpilledProbeBatch(right_batch_.get()) : right_exec_->NextBatch(right_batch_.get()))) {
+            break;
+          }
+          right_idx_ = 0;
+        }
+        matches_.clear();
+        match_idx_ = 0;
+        JoinKey key;
+        if (EvaluateKey(right_batch_.get(), right_idx_, plan_->GetRightKeys(), &key)) {
+          jht_.GetValue(exec_ctx_->GetTransaction(), key, &matches_);
+        }
+        // Only materialize the probe row if something may join with it.
+        if (!matches_.empty()) {
+          probe_tuple_ = right_batch_->GetTuple(right_idx_);
+        }
+        right_idx_++;
+        continue;
+      }
+      const Tuple *build_tuple = matches_[match_idx_++];
+      if (plan_->Predicate()->EvaluateJoin(build_tuple, left_schema, &probe_tuple_, right_schema).GetAs<bool>()) {
+        batch->AppendValues(MakeOutput(build_tuple, &probe_tuple_));
+      }
+    }
+    return !batch->IsEmpty();
   }
 
   /**
@@ -162,7 +293,373 @@ class HashJoinExecutor : public AbstractExecutor {
     return curr_hash;
   }
 
+  /**
+   * Evaluates the join key of a tuple.
+   * @param tuple the tuple to evaluate
+   * @param schema schema to evaluate the tuple on
+   * @param exprs the key expressions
+   * @param[out] key the join key of the tuple
+   * @return false if any key value is NULL, in which case the tuple cannot join with anything
+   */
+  bool EvaluateKey(const Tuple *tuple, const Schema *schema, const std::vector<const AbstractExpression *> &exprs,
+                   JoinKey *key) {
+    for (const auto &expr : exprs) {
+      if (!key->Append(expr->Evaluate(tuple, schema))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Evaluates the join key of a row of a batch.
+   * @param batch batch containing the row
+   * @param row_idx index of the row within the batch
+   * @param exprs the key expressions
+   * @param[out] key the join key of the row
+   * @return false if any key value is NULL, in which case the row cannot join with anything
+   */
+  bool EvaluateKey(const TupleBatch *batch, uint32_t row_idx, const std::vector<const AbstractExpression *> &exprs,
+                   JoinKey *key) {
+    for (const auto &expr : exprs) {
+      if (!key->Append(expr->EvaluateAt(batch, row_idx))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
  private:
+  /** Adds the rows of a build-side batch to the hash table of a serial join, spilling once it exceeds the budget. */
+  void BuildBatch(const TupleBatch *batch) {
+    size_t budget = exec_ctx_->GetMemoryBudget();
+    for (uint32_t i = 0; i < batch->GetSize(); i++) {
+      JoinKey key;
+      if (!EvaluateKey(batch, i, plan_->GetLeftKeys(), &key)) {
+        continue;
+      }
+      if (IsSpilled()) {
+        Tuple tuple = batch->GetTuple(i);
+        bloom_filter_->Insert(key.hash_);
+        Spill(&build_runs_, key.hash_, tuple);
+        continue;
+      }
+      // The in-memory build side is released all at once, so its tuples come from build_pool_ and the hash table
+      // keeps them without another copy. The pool is reset when the build side spills and when the join restarts.
+      Tuple tuple = batch->GetTuple(i, &build_pool_);
+      build_hashes_.push_back(key.hash_);
+      jht_.Insert(exec_ctx_->GetTransaction(), key, tuple);
+      build_used_ += tuple.GetLength() + key.bytes_.size() + sizeof(hash_t);
+      if (build_used_ > budget) {
+        SpillBuildSide();
+        // The size of the build side is unknown now, so the filter gets a fixed share of the budget instead.
+        BuildBloomFilter(std::max(build_hashes_.size(), budget / SPILLED_FILTER_BUDGET_SHARE / BYTES_PER_FILTER_KEY),
+                         build_hashes_);
+        std::vector<hash_t>().swap(build_hashes_);
+      }
+    }
+  }
+
+  /**
+   * Starts the Bloom filter over the build side's join keys, which is pushed down into the probe side before its
+   * Init(), so that a probe-side scan can drop tuples that cannot join before they are materialized.
+   * @param num_keys the number of keys to size the filter for
+   * @param build_hashes the join key hashes of the build tuples seen so far
+   */
+  void BuildBloomFilter(size_t num_keys, const std::vector<hash_t> &build_hashes) {
+    bloom_filter_ = std::make_unique<BlockedBloomFilter>(num_keys);
+    for (auto h : build_hashes) {
+      bloom_filter_->Insert(h);
+    }
+  }
+
+  /** @return true if the serial join ran out of memory and is joining spilled partitions */
+  bool IsSpilled() const { return !build_runs_.empty(); }
+
+  /** @return the spill partition that a hash belongs to; independent of the bits used by PartitionOf() */
+  static uint32_t SpillPartitionOf(hash_t h) { return static_cast<uint32_t>(h >> 32) % NUM_SPILL_PARTITIONS; }
+
+  /** Appends a tuple to the spill partition of its hash. */
+  void Spill(std::vector<std::unique_ptr<TmpTupleRun>> *runs, hash_t h, const Tuple &tuple) {
+    if (!TmpTupleRun::Fits(tuple)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "hash join cannot spill: tuple is larger than a page");
+    }
+    if (!(*runs)[SpillPartitionOf(h)]->Append(tuple)) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "hash join cannot spill: no free buffer pool frame");
+    }
+  }
+
+  /** Moves the in-memory build side into spill partitions. */
+  void SpillBuildSide() {
+    for (uint32_t p = 0; p < NUM_SPILL_PARTITIONS; p++) {
+      build_runs_.emplace_back(std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager()));
+      probe_runs_.emplace_back(std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager()));
+    }
+    jht_.ForEach([&](hash_t h, const Tuple &tuple) { Spill(&build_runs_, h, tuple); });
+    jht_.Clear();
+    build_pool_.Reset();
+  }
+
+  /** Partitions the whole probe side into spill partitions and loads the first build partition. */
+  void SpillProbeSide() {
+    TupleBatch batch(right_exec_->GetOutputSchema());
+    while (right_exec_->NextBatch(&batch)) {
+      for (uint32_t i = 0; i < batch.GetSize(); i++) {
+        JoinKey key;
+        if (EvaluateKey(&batch, i, plan_->GetRightKeys(), &key)) {
+          Spill(&probe_runs_, key.hash_, batch.GetTuple(i));
+        }
+      }
+    }
+    LoadSpillPartition(0);
+  }
+
+  /** Replaces the hash table with the given build partition and rewinds to the start of its probe partition. */
+  void LoadSpillPartition(uint32_t partition) {
+    auto left_schema = left_exec_->GetOutputSchema();
+    spill_partition_ = partition;
+    jht_.Clear();
+    std::vector<Tuple> tuples;
+    auto &run = build_runs_[partition];
+    for (size_t page_idx = 0; page_idx < run->GetPageCount(); page_idx++) {
+      tuples.clear();
+      run->ReadPage(page_idx, &tuples);
+      for (const auto &tuple : tuples) {
+        JoinKey key;
+        EvaluateKey(&tuple, left_schema, plan_->GetLeftKeys(), &key);
+        jht_.Insert(exec_ctx_->GetTransaction(), key, tuple);
+      }
+    }
+    // The build side of this partition is in memory now.
+    run->Clear();
+    spill_tuples_.clear();
+    spill_page_idx_ = 0;
+    spill_tuple_idx_ = 0;
+  }
+
+  /**
+   * Makes sure that spill_tuples_ has a probe tuple of the current spill partition left to be consumed.
+   * @return false if the current probe partition is exhausted
+   */
+  bool FetchSpilledProbeTuple() {
+    auto &run = probe_runs_[spill_partition_];
+    while (spill_tuple_idx_ == spill_tuples_.size()) {
+      if (spill_page_idx_ == run->GetPageCount()) {
+        return false;
+      }
+      spill_tuples_.clear();
+      spill_tuple_idx_ = 0;
+      run->ReadPage(spill_page_idx_++, &spill_tuples_);
+    }
+    return true;
+  }
+
+  /** Produces the next probe tuple of a spilled join, moving on to the next partition when one is used up. */
+  bool NextSpilledProbeTuple(Tuple *tuple) {
+    while (!FetchSpilledProbeTuple()) {
+      if (spill_partition_ + 1 == NUM_SPILL_PARTITIONS) {
+        return false;
+      }
+      LoadSpillPartition(spill_partition_ + 1);
+    }
+    *tuple = spill_tuples_[spill_tuple_idx_++];
+    return true;
+  }
+
+  /**
+   * Produces the next batch of probe tuples of a spilled join. A batch never spans two partitions, because its rows
+   * are probed against the hash table of the partition that is loaded when the batch is produced.
+   */
+  bool NextSpilledProbeBatch(TupleBatch *batch) {
+    batch->Reset();
+    while (!batch->IsFull()) {
+      if (FetchSpilledProbeTuple()) {
+        batch->AppendTuple(spill_tuples_[spill_tuple_idx_++]);
+        continue;
+      }
+      if (!batch->IsEmpty() || spill_partition_ + 1 == NUM_SPILL_PARTITIONS) {
+        break;
+      }
+      LoadSpillPartition(spill_partition_ + 1);
+    }
+    return !batch->IsEmpty();
+  }
+
+  /** The rows of one batch that fall into one partition, as (join key, row index) pairs. */
+  using PartitionRows = std::vector<std::pair<JoinKey, uint32_t>>;
+
+  /** @return the partition that a hash belongs to; the top bits are used so that partitions do not skew buckets */
+  static uint32_t PartitionOf(hash_t h) { return static_cast<uint32_t>(h >> (64 - PARTITION_BITS)); }
+
+  /**
+   * Hashes and radix-partitions the rows of the given batches in parallel.
+   * @return for every batch, the rows of that batch in each partition
+   */
+  std::vector<std::vector<PartitionRows>> PartitionBatches(const std::vector<std::unique_ptr<TupleBatch>> &batches,
+                                                           const std::vector<const AbstractExpression *> &keys,
+                                                           uint32_t num_workers) {
+    std::vector<std::vector<PartitionRows>> partitions(batches.size(), std::vector<PartitionRows>(NUM_PARTITIONS));
+    ParallelUtil::ParallelFor(num_workers, batches.size(), [&](size_t b) {
+      const TupleBatch *batch = batches[b].get();
+      for (uint32_t i = 0; i < batch->GetSize(); i++) {
+        JoinKey key;
+        if (EvaluateKey(batch, i, keys, &key)) {
+          auto partition = PartitionOf(key.hash_);
+          partitions[b][partition].emplace_back(std::move(key), i);
+        }
+      }
+    });
+    return partitions;
+  }
+
+  /**
+   * Builds the hash tables of the partitions of a parallel join, and the Bloom filter over the build side. Every build
+   * row is counted against the memory budget with the fixed-size part of its tuple twice, once in its batch and once in
+   * its hash table, and with its join key.
+   * @param[out] left_batches if the build side exceeds the budget, the batches read from the left child so far
+   * @return false if the build side exceeds the budget, in which case no tables are built
+   */
+  bool ParallelBuild(std::vector<std::unique_ptr<TupleBatch>> *left_batches) {
+    size_t budget = exec_ctx_->GetMemoryBudget();
+    size_t row_size = 2 * static_cast<size_t>(left_exec_->GetOutputSchema()->GetLength());
+    size_t used = 0;
+    auto batch = std::make_unique<TupleBatch>(left_exec_->GetOutputSchema());
+    while (left_exec_->NextBatch(batch.get())) {
+      used += batch->GetSize() * row_size;
+      left_batches->emplace_back(std::move(batch));
+      if (used > budget) {
+        return false;
+      }
+      batch = std::make_unique<TupleBatch>(left_exec_->GetOutputSchema());
+    }
+    auto left_partitions = PartitionBatches(*left_batches, plan_->GetLeftKeys(), num_workers_);
+    size_t num_build_keys = 0;
+    for (const auto &batch_partitions : left_partitions) {
+      for (const auto &rows : batch_partitions) {
+        num_build_keys += rows.size();
+        for (const auto &row : rows) {
+          used += row.first.bytes_.size() + sizeof(row);
+        }
+      }
+    }
+    if (used > budget) {
+      return false;
+    }
+    BuildBloomFilter(num_build_keys, {});
+    for (const auto &batch_partitions : left_partitions) {
+      for (const auto &rows : batch_partitions) {
+        for (const auto &row : rows) {
+          bloom_filter_->Insert(row.first.hash_);
+        }
+      }
+    }
+
+    // Each partition is built by a single worker, so the partitions need no synchronization.
+    for (uint32_t p = 0; p < NUM_PARTITIONS; p++) {
+      partition_tables_.emplace_back("build_hash_table", exec_ctx_->GetBufferPoolManager(), jht_comp_,
+                                     jht_num_buckets_, jht_hash_fn_);
+    }
+    ParallelUtil::ParallelFor(num_workers_, NUM_PARTITIONS, [&](size_t p) {
+      for (size_t b = 0; b < left_batches->size(); b++) {
+        for (const auto &[key, row_idx] : left_partitions[b][p]) {
+          partition_tables_[p].Insert(exec_ctx_->GetTransaction(), key, (*left_batches)[b]->GetTuple(row_idx));
+        }
+      }
+    });
+    // The tables hold copies of the build tuples.
+    left_batches->clear();
+    return true;
+  }
+
+  /**
+   * Reads the next chunk of the probe side of a parallel join, one batch per worker, and probes its batches on the
+   * workers, leaving their joined rows in results_.
+   * @return false if the probe side is exhausted
+   */
+  bool ProbeNextChunk() {
+    std::vector<std::unique_ptr<TupleBatch>> right_batches;
+    while (right_batches.size() < num_workers_) {
+      auto batch = std::make_unique<TupleBatch>(right_exec_->GetOutputSchema());
+      if (!right_exec_->NextBatch(batch.get())) {
+        break;
+      }
+      right_batches.emplace_back(std::move(batch));
+    }
+    if (right_batches.empty()) {
+      return false;
+    }
+    auto left_schema = left_exec_->GetOutputSchema();
+    auto right_schema = right_exec_->GetOutputSchema();
+    // The tables are only read while probing, so the workers can share them.
+    std::vector<std::vector<std::unique_ptr<TupleBatch>>> batch_results(right_batches.size());
+    ParallelUtil::ParallelFor(num_workers_, right_batches.size(), [&](size_t b) {
+      const TupleBatch *batch = right_batches[b].get();
+      auto &results = batch_results[b];
+      std::vector<const Tuple *> matches;
+      for (uint32_t i = 0; i < batch->GetSize(); i++) {
+        JoinKey key;
+        if (!EvaluateKey(batch, i, plan_->GetRightKeys(), &key)) {
+          continue;
+        }
+        matches.clear();
+        partition_tables_[PartitionOf(key.hash_)].GetValue(exec_ctx_->GetTransaction(), key, &matches);
+        if (matches.empty()) {
+          continue;
+        }
+        Tuple probe_tuple = batch->GetTuple(i);
+        for (const auto *build_tuple : matches) {
+          if (plan_->Predicate()->EvaluateJoin(build_tuple, left_schema, &probe_tuple, right_schema).GetAs<bool>()) {
+            if (results.empty() || results.back()->IsFull()) {
+              results.emplace_back(std::make_unique<TupleBatch>(plan_->OutputSchema()));
+            }
+            results.back()->AppendValues(MakeOutput(build_tuple, &probe_tuple));
+          }
+        }
+      }
+    });
+
+    results_.clear();
+    for (auto &results : batch_results) {
+      std::move(results.begin(), results.end(), std::back_inserter(results_));
+    }
+    result_idx_ = 0;
+    result_row_idx_ = 0;
+    return true;
+  }
+
+  /**
+   * Advances past exhausted result batches of a parallel join, probing further chunks of the probe side as needed.
+   * @return true if results_[result_idx_] has a row left at result_row_idx_
+   */
+  bool FetchResultRow() {
+    while (true) {
+      while (result_idx_ < results_.size() && result_row_idx_ == results_[result_idx_]->GetSize()) {
+        result_idx_++;
+        result_row_idx_ = 0;
+      }
+      if (result_idx_ < results_.size()) {
+        return true;
+      }
+      if (!ProbeNextChunk()) {
+        return false;
+      }
+    }
+  }
+
+  /** @return the output values of joining the given build (left) and probe (right) tuples */
+  std::vector<Value> MakeOutput(const Tuple *left_tuple, const Tuple *right_tuple) {
+    auto left_schema = left_exec_->GetOutputSchema();
+    auto right_schema = right_exec_->GetOutputSchema();
+    std::vector<Value> out_vec;
+    uint32_t count = plan_->OutputSchema()->GetColumnCount();
+    out_vec.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+      out_vec.push_back(
+          plan_->OutputSchema()->GetColumn(i).GetExpr()->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema));
+    }
+    return out_vec;
+  }
+
   /** The hash join plan node. */
   const HashJoinPlanNode *plan_;
   /** The comparator is used to compare hashes. */
@@ -170,6 +667,9 @@ class HashJoinExecutor : public AbstractExecutor {
   /** The identity hash function. */
   IdentityHashFunction jht_hash_fn_{};
 
+  /** The memory of the in-memory build tuples of a serial join; declared before jht_, which refers to it. */
+  ArenaPool build_pool_;
+
   /** The hash table that we are using. */
   // Uncomment me! HT jht_;
   HT jht_;
@@ -177,6 +677,52 @@ class HashJoinExecutor : public AbstractExecutor {
   /** The number of buckets in the hash table. */
   static constexpr uint32_t jht_num_buckets_ = 2;
 
+  /** The number of hash bits used to partition a parallel join, and the resulting number of partitions. */
+  static constexpr uint32_t PARTITION_BITS = 6;
+  static constexpr uint32_t NUM_PARTITIONS = 1U << PARTITION_BITS;
+  /** The number of partitions that a serial join spills each input into once it exceeds its memory budget. */
+  static constexpr uint32_t NUM_SPILL_PARTITIONS = 16;
+  /** The Bloom filter of a spilled join takes at most this fraction of the memory budget, at 16 bits per key. */
+  static constexpr size_t SPILLED_FILTER_BUDGET_SHARE = 4;
+  static constexpr size_t BYTES_PER_FILTER_KEY = 2;
+
   std::unique_ptr<AbstractExecutor> left_exec_, right_exec_;
+
+  /** The current batch of probe (right) rows, used by NextBatch(). Next() probes with a tuple at a time instead. */
+  std::unique_ptr<TupleBatch> right_batch_;
+  /** The index of the next row of right_batch_ to be probed. */
+  uint32_t right_idx_{0};
+  /** The probe row currently being joined, materialized as a tuple. */
+  Tuple probe_tuple_;
+  /** The build tuples whose join key equals that of probe_tuple_. */
+  std::vector<const Tuple *> matches_;
+  /** The index of the next tuple of matches_ to be joined with probe_tuple_. */
+  size_t match_idx_{0};
+
+  /** The Bloom filter over the build side's join keys that was pushed down into the probe side. */
+  std::unique_ptr<BlockedBloomFilter> bloom_filter_;
+  /** The bytes of the in-memory build side of a serial join, and the key hashes kept to size the Bloom filter. */
+  size_t build_used_{0};
+  std::vector<hash_t> build_hashes_;
+
+  /** The spilled partitions of the build (left) and probe (right) inputs, empty if the join fits in memory. */
+  std::vector<std::unique_ptr<TmpTupleRun>> build_runs_;
+  std::vector<std::unique_ptr<TmpTupleRun>> probe_runs_;
+  /** The spill partition whose build side is in jht_. */
+  uint32_t spill_partition_{0};
+  /** The tuples of the probe page currently being read, and the position within the probe run and that page. */
+  std::vector<Tuple> spill_tuples_;
+  size_t spill_page_idx_{0};
+  size_t spill_tuple_idx_{0};
+
+  /** True if the join is running on multiple workers, and the number of workers. */
+  bool parallel_{false};
+  uint32_t num_workers_{1};
+  /** The hash tables of the build partitions of a parallel join. */
+  std::vector<HT> partition_tables_;
+  /** The joined rows of the current probe chunk of a parallel join, and the position of the next row to be produced. */
+  std::vector<std::unique_ptr<TupleBatch>> results_;
+  size_t result_idx_{0};
+  uint32_t result_row_idx_{0};
 };
 }  // namespace bustub
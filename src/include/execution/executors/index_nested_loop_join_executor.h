@@ -0,0 +1,206 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_nested_loop_join_executor.h
+//
+// Identification: src/include/execution/executors/index_nested_loop_join_executor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/index_nested_loop_join_plan.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * IndexNestedLoopJoinExecutor joins every outer tuple with the inner table tuples whose index key equals the outer
+ * tuple's join key. Unlike a hash join, the inner table is never read as a whole: only the tuples that an outer key
+ * matches are fetched.
+ *
+ * Probing is batched. The keys of a whole batch of outer tuples are looked up in the index first, and the matching
+ * RIDs are then sorted and deduplicated, so every inner page is fetched once per outer batch however many outer tuples
+ * match tuples on it. Joined tuples are produced in outer order.
+ */
+class IndexNestedLoopJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new index nested loop join executor.
+   * @param exec_ctx the context that the join should be performed in
+   * @param plan the index nested loop join plan node
+   * @param outer the outer child, whose tuples are looked up in the index
+   */
+  IndexNestedLoopJoinExecutor(ExecutorContext *exec_ctx, const IndexNestedLoopJoinPlanNode *plan,
+                              std::unique_ptr<AbstractExecutor> &&outer)
+      : AbstractExecutor(exec_ctx), plan_(plan), outer_exec_(std::move(outer)) {}
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override {
+    index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+    table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
+    outer_exec_->Init();
+    outer_batch_ = std::make_unique<TupleBatch>(outer_exec_->GetOutputSchema());
+    matches_.clear();
+    match_idx_ = 0;
+    inner_tuples_.clear();
+    outer_row_ = NO_ROW;
+  }
+
+  bool Next(Tuple *tuple) override {
+    std::vector<Value> values;
+    if (!NextJoinedRow(&values)) {
+      return false;
+    }
+    *tuple = Tuple(values, plan_->OutputSchema());
+    return true;
+  }
+
+  bool NextBatch(TupleBatch *batch) override {
+    batch->Reset();
+    std::vector<Value> values;
+    while (!batch->IsFull() && NextJoinedRow(&values)) {
+      batch->AppendValues(values);
+    }
+    return !batch->IsEmpty();
+  }
+
+ private:
+  /** The outer row index that stands for "no outer tuple is materialized". */
+  static constexpr uint32_t NO_ROW = UINT32_MAX;
+
+  /**
+   * Produces the output values of the next joined pair of tuples, probing new outer batches as needed.
+   * @param[out] values the output values
+   * @return false if the join is exhausted
+   */
+  bool NextJoinedRow(std::vector<Value> *values) {
+    const Schema *outer_schema = outer_exec_->GetOutputSchema();
+    const Schema *inner_schema = &table_info_->schema_;
+    while (true) {
+      while (match_idx_ < matches_.size()) {
+        auto [outer_row, inner_idx] = matches_[match_idx_++];
+        // Only materialize an outer row once, and only if it matched something.
+        if (outer_row != outer_row_) {
+          outer_tuple_ = outer_batch_->GetTuple(outer_row);
+          outer_row_ = outer_row;
+        }
+        const Tuple *inner_tuple = &inner_tuples_[inner_idx];
+        if (plan_->Predicate() != nullptr &&
+            !plan_->Predicate()->EvaluateJoin(&outer_tuple_, outer_schema, inner_tuple, inner_schema).GetAs<bool>()) {
+          continue;
+        }
+        const Schema *output_schema = plan_->OutputSchema();
+        values->clear();
+        values->reserve(output_schema->GetColumnCount());
+        for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+          const AbstractExpression *expr = output_schema->GetColumn(i).GetExpr();
+          values->push_back(expr->EvaluateJoin(&outer_tuple_, outer_schema, inner_tuple, inner_schema));
+        }
+        return true;
+      }
+      if (!ProbeOuterBatch()) {
+        return false;
+      }
+    }
+  }
+
+  /**
+   * Pulls the next batch of outer tuples, looks all of their keys up in the index and reads the matching inner tuples.
+   * @return false if the outer child is exhausted
+   */
+  bool ProbeOuterBatch() {
+    if (!outer_exec_->NextBatch(outer_batch_.get())) {
+      return false;
+    }
+    matches_.clear();
+    match_idx_ = 0;
+    outer_row_ = NO_ROW;
+
+    // Look up every outer key, remembering which outer row each RID belongs to.
+    std::vector<std::pair<uint32_t, RID>> outer_rids;
+    std::vector<RID> rids;
+    std::vector<Value> key_values(plan_->GetOuterKeys().size());
+    for (uint32_t row = 0; row < outer_batch_->GetSize(); row++) {
+      if (!EvaluateKey(row, &key_values)) {
+        continue;
+      }
+      size_t begin = rids.size();
+      index_info_->index_->ScanKey(Tuple(key_values, &index_info_->key_schema_), &rids, exec_ctx_->GetTransaction());
+      for (size_t i = begin; i < rids.size(); i++) {
+        outer_rids.emplace_back(row, rids[i]);
+      }
+    }
+
+    // Read every distinct inner tuple once, page by page.
+    std::sort(rids.begin(), rids.end(), [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+    rids.erase(std::unique(rids.begin(), rids.end()), rids.end());
+    inner_tuples_.clear();
+    table_info_->table_->GetTuples(rids, &inner_tuples_, exec_ctx_->GetTransaction());
+
+    // The inner tuples are in RID order, so the tuple of every match can be found by binary search.
+    for (const auto &[row, rid] : outer_rids) {
+      auto iter = std::lower_bound(inner_tuples_.begin(), inner_tuples_.end(), rid,
+                                   [](const Tuple &t, const RID &r) { return t.GetRid().Get() < r.Get(); });
+      if (iter != inner_tuples_.end() && iter->GetRid() == rid) {
+        matches_.emplace_back(row, static_cast<size_t>(iter - inner_tuples_.begin()));
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Evaluates the join key of a row of the outer batch.
+   * @param row the index of the row within the outer batch
+   * @param[out] key_values the key values in the types of the index's key schema, sized to the number of keys
+   * @return false if any key value is NULL, in which case the row cannot join with anything
+   */
+  bool EvaluateKey(uint32_t row, std::vector<Value> *key_values) {
+    const auto &keys = plan_->GetOuterKeys();
+    for (size_t i = 0; i < keys.size(); i++) {
+      Value value = keys[i]->EvaluateAt(outer_batch_.get(), row);
+      if (value.IsNull()) {
+        return false;
+      }
+      // The key is serialized in the index's key schema, so e.g. a SMALLINT outer key can probe an INTEGER index.
+      TypeId key_type = index_info_->key_schema_.GetColumn(i).GetType();
+      (*key_values)[i] = value.GetTypeId() == key_type ? std::move(value) : value.CastAs(key_type);
+    }
+    return true;
+  }
+
+  /** The index nested loop join plan node. */
+  const IndexNestedLoopJoinPlanNode *plan_;
+  /** The outer child. */
+  std::unique_ptr<AbstractExecutor> outer_exec_;
+  /** The index on the inner table. */
+  IndexInfo *index_info_{nullptr};
+  /** The inner table. */
+  TableMetadata *table_info_{nullptr};
+
+  /** The outer batch currently being joined. */
+  std::unique_ptr<TupleBatch> outer_batch_;
+  /** The inner tuples that the keys of the outer batch matched, in RID order. */
+  std::vector<Tuple> inner_tuples_;
+  /** The matches of the outer batch as (outer row, index into inner_tuples_) pairs, in outer order. */
+  std::vector<std::pair<uint32_t, size_t>> matches_;
+  /** The index of the next match to be joined. */
+  size_t match_idx_{0};
+  /** The outer row that is materialized in outer_tuple_, or NO_ROW. */
+  uint32_t outer_row_{NO_ROW};
+  Tuple outer_tuple_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_executor.h
+//
+// Identification: src/include/execution/executors/index_scan_executor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "common/config.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/index_scan_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * IndexScanExecutor looks up the keys of its plan in an index and produces the matching table tuples.
+ *
+ * All RIDs are collected up front and sorted, so the tuples are read page by page: a point lookup fetches one index
+ * bucket and one table page, and the tuples of many matching RIDs on the same page cost a single page fetch. Tuples
+ * are produced in RID order.
+ */
+class IndexScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new index scan executor.
+   * @param exec_ctx the executor context
+   * @param plan the index scan plan to be executed
+   */
+  IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
+      : AbstractExecutor(exec_ctx), plan_{plan} {}
+
+  void Init() override {
+    index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+    table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
+    rids_.clear();
+    for (const auto &key : plan_->GetKeys()) {
+      index_info_->index_->ScanKey(Tuple(key, &index_info_->key_schema_), &rids_, exec_ctx_->GetTransaction());
+    }
+    // Sorting groups the RIDs of a page, and a RID found under several keys is only produced once.
+    std::sort(rids_.begin(), rids_.end(), [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+    rids_.erase(std::unique(rids_.begin(), rids_.end()), rids_.end());
+    next_rid_idx_ = 0;
+    tuples_.clear();
+    tuple_idx_ = 0;
+  }
+
+  bool Next(Tuple *tuple) override {
+    std::vector<Value> values(plan_->OutputSchema()->GetColumnCount());
+    while (FetchTuples()) {
+      const Tuple &table_tuple = tuples_[tuple_idx_++];
+      if (Project(table_tuple, &values)) {
+        *tuple = Tuple(values, plan_->OutputSchema());
+        tuple->SetRid(table_tuple.GetRid());
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool NextBatch(TupleBatch *batch) override {
+    batch->Reset();
+    std::vector<Value> values(plan_->OutputSchema()->GetColumnCount());
+    while (!batch->IsFull() && FetchTuples()) {
+      const Tuple &table_tuple = tuples_[tuple_idx_++];
+      if (Project(table_tuple, &values)) {
+        batch->AppendValues(values, table_tuple.GetRid());
+      }
+    }
+    return !batch->IsEmpty();
+  }
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /**
+   * Makes sure that tuples_ has a tuple left to produce, reading the tuples of up to TUPLE_BATCH_SIZE more RIDs.
+   * @return false if every tuple has been produced
+   */
+  bool FetchTuples() {
+    while (tuple_idx_ == tuples_.size()) {
+      if (next_rid_idx_ == rids_.size()) {
+        return false;
+      }
+      size_t end = std::min(next_rid_idx_ + TUPLE_BATCH_SIZE, rids_.size());
+      std::vector<RID> rids(rids_.begin() + next_rid_idx_, rids_.begin() + end);
+      next_rid_idx_ = end;
+      tuples_.clear();
+      tuple_idx_ = 0;
+      table_info_->table_->GetTuples(rids, &tuples_, exec_ctx_->GetTransaction());
+    }
+    return true;
+  }
+
+  /**
+   * Evaluates the predicate and the output columns on a table tuple.
+   * @param tuple the table tuple
+   * @param[out] values the output values, sized to the output schema
+   * @return false if the tuple does not satisfy the predicate
+   */
+  bool Project(const Tuple &tuple, std::vector<Value> *values) {
+    const Schema *schema = &table_info_->schema_;
+    if (plan_->GetPredicate() && !plan_->GetPredicate()->Evaluate(&tuple, schema).GetAs<bool>()) {
+      return false;
+    }
+    const Schema *output_schema = plan_->OutputSchema();
+    for (uint32_t i = 0; i < values->size(); i++) {
+      (*values)[i] = output_schema->GetColumn(i).GetExpr()->Evaluate(&tuple, schema);
+    }
+    return true;
+  }
+
+  /** The index scan plan node to be executed. */
+  const IndexScanPlanNode *plan_;
+  /** The index to look the keys up in. */
+  IndexInfo *index_info_{nullptr};
+  /** The table that the index is on. */
+  TableMetadata *table_info_{nullptr};
+  /** The sorted, distinct RIDs of the matching tuples. */
+  std::vector<RID> rids_;
+  /** The first RID whose tuple has not been read yet. */
+  size_t next_rid_idx_{0};
+  /** The tuples that have been read, in RID order. */
+  std::vector<Tuple> tuples_;
+  /** The next tuple of tuples_ to be produced. */
+  size_t tuple_idx_{0};
+};
+
+}  // namespace bustub
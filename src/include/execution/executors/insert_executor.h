@@ -14,10 +14,14 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/plans/index_nested_loop_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
 #include "execution/plans/insert_plan.h"
+#include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -41,38 +45,157 @@ class InsertExecutor : public AbstractExecutor {
 
   void Init() override {
     table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+    indexes_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
     if (!plan_->IsRawInsert()) {
       child_executor_ = ExecutorFactory::CreateExecutor(GetExecutorContext(), plan_->GetChildPlan());
       child_executor_->Init();
+      reads_target_ = ReadsTable(plan_->GetChildPlan());
     }
   }
 
   // Note that Insert does not make use of the tuple pointer being passed in.
   // We return false if the insert failed for any reason, and return true if all inserts succeeded.
   bool Next([[maybe_unused]] Tuple *tuple) override {
+    std::vector<Tuple> tuples;
     if (plan_->IsRawInsert()) {
-      int size = plan_->RawValues().size();
-      for (int i=0; i < size; i++) {
-        Tuple tuple1 {plan_->RawValuesAt(i), &table_info_->schema_};
-        RID rid;
-        if (!table_info_->table_->InsertTuple(tuple1, &rid, exec_ctx_->GetTransaction()))
+      tuples.reserve(plan_->RawValues().size());
+      for (const auto &values : plan_->RawValues()) {
+        tuples.emplace_back(values, &table_info_->schema_);
+      }
+      return InsertTuples(tuples);
+    }
+    if (reads_target_) {
+      return InsertFromTarget();
+    }
+    // The child's tuples are copied out of wherever the child holds them and inserted a batch at a time.
+    TupleView view;
+    while (child_executor_->NextView(&view)) {
+      tuples.push_back(view.ToTuple());
+      if (tuples.size() == TUPLE_BATCH_SIZE) {
+        if (!InsertTuples(tuples)) {
           return false;
+        }
+        tuples.clear();
+      }
+    }
+    return InsertTuples(tuples);
+  }
+
+  // Like Next(), NextBatch() does not produce any tuples and the batch may be nullptr. Rows from the child executor
+  // are pulled a batch at a time. We return false if the insert failed for any reason, and true otherwise.
+  bool NextBatch([[maybe_unused]] TupleBatch *batch) override {
+    if (plan_->IsRawInsert()) {
+      return Next(nullptr);
+    }
+    if (reads_target_) {
+      return InsertFromTarget();
+    }
+    TupleBatch child_batch(child_executor_->GetOutputSchema());
+    std::vector<Tuple> tuples;
+    while (child_executor_->NextBatch(&child_batch)) {
+      tuples.clear();
+      tuples.reserve(child_batch.GetSize());
+      for (uint32_t i = 0; i < child_batch.GetSize(); i++) {
+        tuples.emplace_back(child_batch.GetValues(i), &table_info_->schema_);
+      }
+      if (!InsertTuples(tuples)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  /** @return true if the plan or any plan below it reads the table that is inserted into */
+  bool ReadsTable(const AbstractPlanNode *plan) const {
+    auto *catalog = exec_ctx_->GetCatalog();
+    switch (plan->GetType()) {
+      case PlanType::SeqScan:
+        if (static_cast<const SeqScanPlanNode *>(plan)->GetTableOid() == table_info_->oid_) {
+          return true;
+        }
+        break;
+      case PlanType::IndexScan:
+        if (catalog->GetIndex(static_cast<const IndexScanPlanNode *>(plan)->GetIndexOid())->table_name_ ==
+            table_info_->name_) {
+          return true;
+        }
+        break;
+      case PlanType::IndexNestedLoopJoin:
+        if (catalog->GetIndex(static_cast<const IndexNestedLoopJoinPlanNode *>(plan)->GetIndexOid())->table_name_ ==
+            table_info_->name_) {
+          return true;
+        }
+        break;
+      default:
+        break;
+    }
+    for (const auto *child : plan->GetChildren()) {
+      if (ReadsTable(child)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Inserts the tuples of a child that reads the table being inserted into. All of them are read before the first one
+   * is inserted: the child must not see the new tuples, and NextView() would keep a page of the table latched while
+   * the insert writes to it.
+   */
+  bool InsertFromTarget() {
+    std::vector<Tuple> tuples;
+    Tuple tuple;
+    while (child_executor_->Next(&tuple)) {
+      tuples.push_back(tuple);
+    }
+    return InsertTuples(tuples);
+  }
+
+  /**
+   * Inserts tuples into the table, then adds their keys to the indexes on the table one index at a time. Every index
+   * entry is recorded in the transaction, so that an abort removes it again.
+   *
+   * Tuples that fill more than a page are bulk inserted into new pages of their own. Fewer tuples are inserted one by
+   * one, so that they fill the room that is left on existing pages instead of starting a new page every time.
+   */
+  bool InsertTuples(const std::vector<Tuple> &tuples) {
+    auto *txn = exec_ctx_->GetTransaction();
+    std::vector<RID> rids;
+    rids.reserve(tuples.size());
+    size_t total_size = 0;
+    for (const auto &tuple : tuples) {
+      total_size += tuple.GetLength();
+    }
+    if (total_size >= PAGE_SIZE) {
+      if (!table_info_->table_->BulkInsert(tuples, &rids, txn)) {
+        return false;
       }
     } else {
-      Tuple tuple1;
-      RID rid;
-      while (child_executor_->Next(&tuple1)) {
-        if (!table_info_->table_->InsertTuple(tuple1, &rid, exec_ctx_->GetTransaction()))
+      for (const auto &tuple : tuples) {
+        if (!table_info_->table_->InsertTuple(tuple, &rids.emplace_back(), txn)) {
           return false;
+        }
+      }
+    }
+    for (auto *index_info : indexes_) {
+      auto *index = index_info->index_.get();
+      for (size_t i = 0; i < tuples.size(); i++) {
+        Tuple key = tuples[i].KeyFromTuple(table_info_->schema_, index_info->key_schema_, index->GetKeyAttrs());
+        index->InsertEntry(key, rids[i], txn);
+        txn->GetIndexWriteSet()->emplace_back(rids[i], WType::INSERT, key, index);
       }
     }
     return true;
   }
 
- private:
   /** The insert plan node to be executed. */
   const InsertPlanNode *plan_;
   const TableMetadata *table_info_;
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Whether the child executor reads the table that is inserted into. */
+  bool reads_target_{false};
+  /** The indexes on the table. */
+  std::vector<IndexInfo *> indexes_;
 };
 }  // namespace bustub
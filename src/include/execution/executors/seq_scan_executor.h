@@ -12,17 +12,53 @@
 
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <numeric>
+#include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
+#include "execution/compiled_predicate.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/join_key.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/morsel_dispenser.h"
+#include "storage/table/table_view_cursor.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * SeqScanExecutor executes a sequential scan over a table.
+ *
+ * If the executor context allows more than one worker, the scan runs morsel-driven: worker threads claim morsels of
+ * table pages from a shared MorselDispenser, evaluate the predicate and projection locally and hand full batches to
+ * the consuming thread through a bounded queue. Tuples are then produced in no particular order.
+ *
+ * Tuples are filtered and projected in place in the latched table page, so only the output columns of qualifying
+ * tuples are ever copied out of the page. If the predicate can be compiled, NextBatch() instead gathers the raw table
+ * tuples into a batch and filters the whole batch with the CompiledPredicate before projecting the rows that pass.
+ *
+ * Batches of a PAX table are gathered column by column instead, copying only the columns that the predicate and the
+ * projection read out of their minipages, as long as the predicate is either absent or compiled.
+ *
+ * Predicates of the form column op constant are also checked against the zone map of the table before every page, and
+ * pages whose zone rules out every tuple are skipped without being fetched.
+ *
+ * NextView() goes further when the output schema is the table schema itself: the view points at the tuple in its page,
+ * which the scan keeps pinned, and nothing is copied at all.
+ *
+ * A hash join may push a Bloom filter over its build keys down into its probe-side scan, which then drops tuples that
+ * cannot join before they are projected.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -34,26 +70,549 @@ class SeqScanExecutor : public AbstractExecutor {
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_{plan} {}
 
+  ~SeqScanExecutor() override { StopWorkers(); }
+
   void Init() override {
+    StopWorkers();
     table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
-    table_iter_ = static_cast<std::unique_ptr<TableIterator>>(new TableIterator{table_info_->table_->Begin(exec_ctx_->GetTransaction())});
+    compiled_predicate_ = plan_->GetPredicate() == nullptr
+                              ? nullptr
+                              : CompiledPredicate::Compile(plan_->GetPredicate(), &table_info_->schema_);
+    gather_columns_ = table_info_->table_->GetLayout() == TableLayout::PAX &&
+                      (plan_->GetPredicate() == nullptr || compiled_predicate_ != nullptr);
+    if (gather_columns_) {
+      CollectScanColumns();
+    }
+    PrepareZonePredicate();
+    // Workers would share the transaction's lock sets, so only scan in parallel when no locks are taken.
+    uint32_t num_workers = enable_logging ? 1 : exec_ctx_->GetDegreeOfParallelism();
+    if (num_workers > 1) {
+      StartWorkers(num_workers);
+      return;
+    }
+    scan_page_id_ = table_info_->table_->GetFirstPageId();
+    scan_slot_ = 0;
+    view_cursor_.reset();
+    views_in_place_ = IsTableSchema(plan_->OutputSchema());
+    buffers_ = std::make_unique<ScanBuffers>(&table_info_->schema_, plan_->OutputSchema());
   }
 
   bool Next(Tuple *tuple) override {
-    while (*table_iter_ != table_info_->table_->End()) {
-      *tuple = **table_iter_;
-      ++(*table_iter_);
-      if (!plan_->GetPredicate() || plan_->GetPredicate()->Evaluate(tuple, &table_info_->schema_).GetAs<bool>()) return true;
+    if (!workers_.empty()) {
+      if (!FetchWorkerBatch()) {
+        return false;
+      }
+      *tuple = worker_batch_->GetTuple(worker_batch_idx_++);
+      return true;
+    }
+    std::vector<Value> values(plan_->OutputSchema()->GetColumnCount());
+    bool produced = false;
+    while (!produced && scan_page_id_ != INVALID_PAGE_ID) {
+      ScanCurrentPage([&](const Tuple &table_tuple) {
+        if (!Project(table_tuple, &values)) {
+          return true;
+        }
+        *tuple = Tuple(values, plan_->OutputSchema());
+        tuple->SetRid(table_tuple.GetRid());
+        produced = true;
+        return false;
+      });
+    }
+    return produced;
+  }
+
+  bool NextBatch(TupleBatch *batch) override {
+    batch->Reset();
+    if (!workers_.empty()) {
+      while (!batch->IsFull() && FetchWorkerBatch()) {
+        batch->AppendRow(*worker_batch_, worker_batch_idx_++);
+      }
+      return !batch->IsEmpty();
+    }
+    while (!batch->IsFull() && scan_page_id_ != INVALID_PAGE_ID) {
+      page_id_t next_page_id;
+      if (ScanPageInto(scan_page_id_, &scan_slot_, &next_page_id, buffers_.get(), batch)) {
+        scan_page_id_ = next_page_id;
+        scan_slot_ = 0;
+      }
+    }
+    if (scan_page_id_ == INVALID_PAGE_ID) {
+      FlushTableBatch(buffers_.get(), batch);
+    }
+    return !batch->IsEmpty();
+  }
+
+  bool NextView(TupleView *view) override {
+    if (!workers_.empty() || !views_in_place_) {
+      return AbstractExecutor::NextView(view);
+    }
+    if (view_cursor_ == nullptr) {
+      view_cursor_ = std::make_unique<TableViewCursor>(table_info_->table_.get(), exec_ctx_->GetTransaction());
+    }
+    const Schema *schema = &table_info_->schema_;
+    while (view_cursor_->Next(view)) {
+      Tuple tuple = view->AsTuple();
+      if (bloom_filter_ != nullptr && !MayJoin(tuple)) {
+        continue;
+      }
+      if (plan_->GetPredicate() == nullptr || plan_->GetPredicate()->Evaluate(&tuple, schema).GetAs<bool>()) {
+        return true;
+      }
     }
     return false;
   }
 
+  bool PushDownBloomFilter(const BlockedBloomFilter *filter, const std::vector<const AbstractExpression *> &keys) override {
+    // Only plain output columns are supported, so that keys can be evaluated on table tuples before projecting them.
+    std::vector<const AbstractExpression *> table_keys;
+    for (const auto *key : keys) {
+      auto column = dynamic_cast<const ColumnValueExpression *>(key);
+      if (column == nullptr || plan_->OutputSchema()->GetColumn(column->GetColIdx()).GetExpr() == nullptr) {
+        return false;
+      }
+      table_keys.push_back(plan_->OutputSchema()->GetColumn(column->GetColIdx()).GetExpr());
+    }
+    bloom_filter_ = filter;
+    bloom_keys_ = std::move(table_keys);
+    return true;
+  }
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  /** @return true if every output column is the table column at the same position, so table tuples need no projection */
+  bool IsTableSchema(const Schema *output_schema) const {
+    const Schema &schema = table_info_->schema_;
+    if (output_schema->GetColumnCount() != schema.GetColumnCount() || output_schema->GetLength() != schema.GetLength()) {
+      return false;
+    }
+    for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+      const Column &column = output_schema->GetColumn(i);
+      auto expr = dynamic_cast<const ColumnValueExpression *>(column.GetExpr());
+      if (expr == nullptr || expr->GetColIdx() != i || column.GetType() != schema.GetColumn(i).GetType() ||
+          column.GetOffset() != schema.GetColumn(i).GetOffset()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** @return false if the join key of the table tuple is certainly not in the pushed down Bloom filter */
+  bool MayJoin(const Tuple &tuple) {
+    hash_t hash = 0;
+    for (const auto *key : bloom_keys_) {
+      if (!JoinKey::AppendHash(key->Evaluate(&tuple, &table_info_->schema_), &hash)) {
+        return false;
+      }
+    }
+    return bloom_filter_->MayContain(hash);
+  }
+
+  /**
+   * Evaluates the predicate on a table tuple and, if it is satisfied, projects the tuple onto the output schema.
+   * @param tuple the table tuple
+   * @param[out] values the projected values, one for each output column
+   * @return true if the tuple satisfies the predicate
+   */
+  bool Project(const Tuple &tuple, std::vector<Value> *values) {
+    const Schema *schema = &table_info_->schema_;
+    if (bloom_filter_ != nullptr && !MayJoin(tuple)) {
+      return false;
+    }
+    if (plan_->GetPredicate() && !plan_->GetPredicate()->Evaluate(&tuple, schema).GetAs<bool>()) {
+      return false;
+    }
+    const Schema *output_schema = plan_->OutputSchema();
+    for (uint32_t i = 0; i < values->size(); i++) {
+      (*values)[i] = output_schema->GetColumn(i).GetExpr()->Evaluate(&tuple, schema);
+    }
+    return true;
+  }
+
+  /**
+   * Appends the projection of a table tuple to the batch if it satisfies the predicate.
+   * @param tuple the table tuple
+   * @param values scratch space for the projected values
+   * @param batch the batch to append to
+   */
+  void ScanTuple(const Tuple &tuple, std::vector<Value> *values, TupleBatch *batch) {
+    if (Project(tuple, values)) {
+      batch->AppendValues(*values, tuple.GetRid());
+    }
+  }
+
+  /** Collects the table columns that the predicate and the output columns read into scan_columns_. */
+  void CollectScanColumns() {
+    std::vector<bool> used(table_info_->schema_.GetColumnCount(), false);
+    std::function<void(const AbstractExpression *)> collect = [&](const AbstractExpression *expr) {
+      if (auto column = dynamic_cast<const ColumnValueExpression *>(expr); column != nullptr) {
+        used[column->GetColIdx()] = true;
+      }
+      for (const auto *child : expr->GetChildren()) {
+        collect(child);
+      }
+    };
+    if (plan_->GetPredicate() != nullptr) {
+      collect(plan_->GetPredicate());
+    }
+    for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+      collect(column.GetExpr());
+    }
+    scan_columns_.clear();
+    for (uint32_t i = 0; i < used.size(); i++) {
+      if (used[i]) {
+        scan_columns_.push_back(i);
+      }
+    }
+  }
+
+  /** Recognizes a predicate of the form column op constant, or constant op column, that zone maps can check. */
+  void PrepareZonePredicate() {
+    has_zone_predicate_ = false;
+    auto comparison = dynamic_cast<const ComparisonExpression *>(plan_->GetPredicate());
+    if (comparison == nullptr) {
+      return;
+    }
+    ComparisonType cmp = comparison->GetComparisonType();
+    auto column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+    auto constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+    if (column == nullptr || constant == nullptr) {
+      // constant op column is column op' constant, with the comparison mirrored.
+      column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+      constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+      switch (cmp) {
+        case ComparisonType::LessThan:
+          cmp = ComparisonType::GreaterThan;
+          break;
+        case ComparisonType::LessThanOrEqual:
+          cmp = ComparisonType::GreaterThanOrEqual;
+          break;
+        case ComparisonType::GreaterThan:
+          cmp = ComparisonType::LessThan;
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+          cmp = ComparisonType::LessThanOrEqual;
+          break;
+        default:
+          break;
+      }
+    }
+    if (column == nullptr || constant == nullptr || constant->GetValue().IsNull()) {
+      return;
+    }
+    // Only compare values of the same type, or numbers with numbers.
+    auto is_numeric = [](TypeId type) { return type >= TypeId::TINYINT && type <= TypeId::DECIMAL; };
+    TypeId column_type = table_info_->schema_.GetColumn(column->GetColIdx()).GetType();
+    TypeId value_type = constant->GetValue().GetTypeId();
+    if (column_type != value_type && (!is_numeric(column_type) || !is_numeric(value_type))) {
+      return;
+    }
+    has_zone_predicate_ = true;
+    zone_col_idx_ = column->GetColIdx();
+    zone_cmp_ = cmp;
+    zone_value_ = constant->GetValue();
+  }
+
+  /**
+   * Checks the zone map of the table for whether a page can be skipped.
+   * @param page_id the page to check
+   * @param[out] next_page_id the id of the page after this one, set if the page can be skipped
+   * @return true if no tuple of the page can satisfy the predicate
+   */
+  bool CanSkipPage(page_id_t page_id, page_id_t *next_page_id) const {
+    ColumnZone zone;
+    page_id_t zone_next_page_id;
+    if (!has_zone_predicate_ ||
+        !table_info_->table_->GetZone(page_id, zone_col_idx_, &zone, &zone_next_page_id)) {
+      return false;
+    }
+    bool skip;
+    auto less = [](const Value &left, const Value &right) { return left.CompareLessThan(right) == CmpBool::CmpTrue; };
+    if (zone.tuple_count_ == 0) {
+      skip = true;
+    } else if (zone.null_count_ > 0) {
+      // A comparison with NULL counts as satisfied, so pages with NULLs can never be ruled out.
+      skip = false;
+    } else {
+      switch (zone_cmp_) {
+        case ComparisonType::Equal:
+          skip = less(zone_value_, zone.min_) || less(zone.max_, zone_value_);
+          break;
+        case ComparisonType::NotEqual:
+          skip = !less(zone.min_, zone_value_) && !less(zone_value_, zone.max_);
+          break;
+        case ComparisonType::LessThan:
+          skip = !less(zone.min_, zone_value_);
+          break;
+        case ComparisonType::LessThanOrEqual:
+          skip = less(zone_value_, zone.min_);
+          break;
+        case ComparisonType::GreaterThan:
+          skip = !less(zone_value_, zone.max_);
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+          skip = less(zone.max_, zone_value_);
+          break;
+        default:
+          skip = false;
+      }
+    }
+    if (skip) {
+      *next_page_id = zone_next_page_id;
+    }
+    return skip;
+  }
+
+  /** @return true if batches are gathered column by column, which needs no table tuples for a Bloom filter */
+  bool GathersColumns() const { return gather_columns_ && bloom_filter_ == nullptr; }
+
+  /** The scratch space of one scanning thread. */
+  struct ScanBuffers {
+    ScanBuffers(const Schema *table_schema, const Schema *output_schema)
+        : table_batch_(table_schema), values_(output_schema->GetColumnCount()) {}
+    /** Table tuples that are waiting to be filtered by the compiled predicate. */
+    TupleBatch table_batch_;
+    /** The rows of table_batch_ that passed the compiled predicate. */
+    std::vector<uint32_t> sel_;
+    /** The projected values of one row. */
+    std::vector<Value> values_;
+  };
+
+  /**
+   * Scans a page from a slot on, appending the projections of the qualifying tuples to the batch until it is full.
+   * With a compiled predicate, the tuples are gathered into the table batch of the buffers instead, and filtered once
+   * there are as many as the batch has room for; whatever is left has to be flushed with FlushTableBatch() at the end.
+   * The same goes for gathering the columns of a PAX table.
+   * @param page_id the page to scan
+   * @param[in,out] slot the first slot to visit; on return, the slot to resume from
+   * @param[out] next_page_id the id of the page after this one, set if the scan reached the end of the page
+   * @param buffers the scratch space of the scanning thread
+   * @param batch the batch to append to, which must not be full
+   * @return true if the scan reached the end of the page
+   */
+  bool ScanPageInto(page_id_t page_id, uint32_t *slot, page_id_t *next_page_id, ScanBuffers *buffers,
+                    TupleBatch *batch) {
+    if (*slot == 0 && CanSkipPage(page_id, next_page_id)) {
+      return true;
+    }
+    auto txn = exec_ctx_->GetTransaction();
+    if (compiled_predicate_ == nullptr && !GathersColumns()) {
+      return table_info_->table_->ScanPage(
+          page_id, slot,
+          [&](const Tuple &tuple) {
+            ScanTuple(tuple, &buffers->values_, batch);
+            return !batch->IsFull();
+          },
+          next_page_id, txn);
+    }
+    // Every gathered tuple may pass the filter, so gather no more than the batch has room for.
+    auto &table_batch = buffers->table_batch_;
+    uint32_t room = std::min(batch->GetCapacity() - batch->GetSize(), table_batch.GetCapacity());
+    if (GathersColumns()) {
+      bool page_done =
+          table_info_->table_->ScanColumns(page_id, slot, scan_columns_, &table_batch, room, next_page_id, txn);
+      if (table_batch.GetSize() == room) {
+        FlushTableBatch(buffers, batch);
+      }
+      return page_done;
+    }
+    bool page_done = table_info_->table_->ScanPage(
+        page_id, slot,
+        [&](const Tuple &tuple) {
+          if (bloom_filter_ == nullptr || MayJoin(tuple)) {
+            table_batch.AppendTuple(tuple);
+          }
+          return table_batch.GetSize() < room;
+        },
+        next_page_id, txn);
+    if (table_batch.GetSize() == room) {
+      FlushTableBatch(buffers, batch);
+    }
+    return page_done;
+  }
+
+  /** Filters the gathered table tuples with the compiled predicate, if any, and appends the projections of the rest. */
+  void FlushTableBatch(ScanBuffers *buffers, TupleBatch *batch) {
+    auto &table_batch = buffers->table_batch_;
+    if (table_batch.IsEmpty()) {
+      return;
+    }
+    if (compiled_predicate_ != nullptr) {
+      compiled_predicate_->Filter(table_batch, &buffers->sel_);
+    } else {
+      buffers->sel_.resize(table_batch.GetSize());
+      std::iota(buffers->sel_.begin(), buffers->sel_.end(), 0);
+    }
+    const Schema *output_schema = plan_->OutputSchema();
+    for (auto row : buffers->sel_) {
+      for (uint32_t i = 0; i < buffers->values_.size(); i++) {
+        buffers->values_[i] = output_schema->GetColumn(i).GetExpr()->EvaluateAt(&table_batch, row);
+      }
+      batch->AppendValues(buffers->values_, table_batch.GetRid(row));
+    }
+    table_batch.Reset();
+  }
+
+  /**
+   * Visits the rest of the current page of a serial scan in place, moving on to the next page once it is done.
+   * @param visitor called with every table tuple, returns false to stop the scan after that tuple
+   */
+  void ScanCurrentPage(const std::function<bool(const Tuple &)> &visitor) {
+    page_id_t next_page_id;
+    auto txn = exec_ctx_->GetTransaction();
+    if ((scan_slot_ == 0 && CanSkipPage(scan_page_id_, &next_page_id)) ||
+        table_info_->table_->ScanPage(scan_page_id_, &scan_slot_, visitor, &next_page_id, txn)) {
+      scan_page_id_ = next_page_id;
+      scan_slot_ = 0;
+    }
+  }
+
+  /** Starts the given number of scan workers over a fresh morsel dispenser. */
+  void StartWorkers(uint32_t num_workers) {
+    dispenser_ = std::make_unique<MorselDispenser>(exec_ctx_->GetBufferPoolManager(),
+                                                   table_info_->table_->GetFirstPageId());
+    stopped_ = false;
+    running_workers_ = num_workers;
+    queue_capacity_ = 2 * num_workers;
+    for (uint32_t i = 0; i < num_workers; i++) {
+      workers_.emplace_back(&SeqScanExecutor::RunWorker, this);
+    }
+  }
+
+  /** Stops the scan workers, discarding any batches that have not been consumed yet. */
+  void StopWorkers() {
+    {
+      std::scoped_lock latch{queue_latch_};
+      stopped_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+    workers_.clear();
+    queue_.clear();
+    worker_batch_.reset();
+    worker_batch_idx_ = 0;
+  }
+
+  /** The body of a scan worker: scans morsels until the table is exhausted or the scan is stopped. */
+  void RunWorker() {
+    std::vector<page_id_t> page_ids;
+    ScanBuffers buffers(&table_info_->schema_, plan_->OutputSchema());
+    auto batch = std::make_unique<TupleBatch>(plan_->OutputSchema());
+    bool stopped = false;
+    while (!stopped && dispenser_->Next(&page_ids)) {
+      for (auto page_id : page_ids) {
+        // The batch is only handed over once the page is unlatched again.
+        uint32_t slot = 0;
+        page_id_t next_page_id;
+        bool page_done = false;
+        while (!stopped && !page_done) {
+          page_done = ScanPageInto(page_id, &slot, &next_page_id, &buffers, batch.get());
+          if (batch->IsFull()) {
+            stopped = !PushBatch(&batch);
+          }
+        }
+        if (stopped) {
+          break;
+        }
+      }
+    }
+    if (!stopped) {
+      FlushTableBatch(&buffers, batch.get());
+      if (!batch->IsEmpty()) {
+        PushBatch(&batch);
+      }
+    }
+    {
+      std::scoped_lock latch{queue_latch_};
+      running_workers_--;
+    }
+    queue_cv_.notify_all();
+  }
+
+  /**
+   * Hands a full batch over to the consumer, waiting while the queue is full, and replaces it with an empty one.
+   * @return false if the scan was stopped
+   */
+  bool PushBatch(std::unique_ptr<TupleBatch> *batch) {
+    {
+      std::unique_lock latch{queue_latch_};
+      queue_cv_.wait(latch, [&] { return stopped_ || queue_.size() < queue_capacity_; });
+      if (stopped_) {
+        return false;
+      }
+      queue_.push_back(std::move(*batch));
+    }
+    queue_cv_.notify_all();
+    *batch = std::make_unique<TupleBatch>(plan_->OutputSchema());
+    return true;
+  }
+
+  /**
+   * Makes sure that worker_batch_ has a row left to be consumed, waiting for the workers if necessary.
+   * @return false if the workers are done and every row has been consumed
+   */
+  bool FetchWorkerBatch() {
+    if (worker_batch_ != nullptr && worker_batch_idx_ < worker_batch_->GetSize()) {
+      return true;
+    }
+    {
+      std::unique_lock latch{queue_latch_};
+      queue_cv_.wait(latch, [&] { return !queue_.empty() || running_workers_ == 0; });
+      if (queue_.empty()) {
+        return false;
+      }
+      worker_batch_ = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    queue_cv_.notify_all();
+    worker_batch_idx_ = 0;
+    return true;
+  }
+
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
   const TableMetadata* table_info_;
-  std::unique_ptr<TableIterator> table_iter_;
+  /** The page that a serial scan is on, INVALID_PAGE_ID once it is done, and the next slot to visit on it. */
+  page_id_t scan_page_id_{INVALID_PAGE_ID};
+  uint32_t scan_slot_{0};
+  /** The cursor that NextView() scans the table with, and whether it can produce views of table tuples directly. */
+  std::unique_ptr<TableViewCursor> view_cursor_;
+  bool views_in_place_{false};
+  /** The predicate compiled into batch kernels, or nullptr if it is interpreted one tuple at a time. */
+  std::unique_ptr<CompiledPredicate> compiled_predicate_;
+  /** The scratch space of a serial scan. */
+  std::unique_ptr<ScanBuffers> buffers_;
+  /** Whether the predicate is column op constant, so that pages can be skipped by their zones, and its parts. */
+  bool has_zone_predicate_{false};
+  uint32_t zone_col_idx_{0};
+  ComparisonType zone_cmp_{ComparisonType::Equal};
+  Value zone_value_;
+  /** Whether batches of the PAX table are gathered column by column, and the columns to gather. */
+  bool gather_columns_{false};
+  std::vector<uint32_t> scan_columns_;
+  /** A Bloom filter over the join keys of a consuming hash join, and the keys evaluated on table tuples. */
+  const BlockedBloomFilter *bloom_filter_{nullptr};
+  std::vector<const AbstractExpression *> bloom_keys_;
+
+  /** Hands out morsels of table pages to the workers of a parallel scan. */
+  std::unique_ptr<MorselDispenser> dispenser_;
+  /** The workers of a parallel scan, empty if the scan is serial. */
+  std::vector<std::thread> workers_;
+  /** Protects queue_, running_workers_ and stopped_. */
+  std::mutex queue_latch_;
+  std::condition_variable queue_cv_;
+  /** Full batches produced by the workers that have not been consumed yet. */
+  std::deque<std::unique_ptr<TupleBatch>> queue_;
+  /** The maximum number of batches in queue_, bounding how far the workers can run ahead of the consumer. */
+  size_t queue_capacity_{0};
+  /** The number of workers that are still scanning. */
+  uint32_t running_workers_{0};
+  /** True if the workers should stop producing batches. */
+  bool stopped_{false};
+  /** The worker batch currently being consumed, and the index of its next row. */
+  std::unique_ptr<TupleBatch> worker_batch_;
+  uint32_t worker_batch_idx_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,368 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SortExecutor executes an ORDER BY, optionally with a LIMIT, over the tuples of a child executor.
+ *
+ * A sort with a LIMIT small enough for the memory budget keeps only the best LIMIT tuples in a heap while it drains
+ * its child. Any other sort buffers the child's tuples, and sorts them in memory if they fit in the memory budget.
+ * Otherwise, every budget's worth of tuples is sorted and written to a TmpTupleRun, and the runs are merged in passes
+ * of up to one run per page of the budget until a final merge can produce the tuples directly.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan to be executed
+   * @param child the child executor whose tuples are sorted
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child)
+      : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)) {}
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override {
+    child_->Init();
+    sorted_.clear();
+    next_idx_ = 0;
+    cursors_.clear();
+    merge_heap_.clear();
+    runs_.clear();
+    num_produced_ = 0;
+
+    size_t limit = plan_->GetLimit();
+    size_t entry_size = sizeof(SortEntry) + child_->GetOutputSchema()->GetLength() +
+                        plan_->GetOrderBys().size() * sizeof(Value);
+    if (limit != SortPlanNode::NO_LIMIT && limit <= exec_ctx_->GetMemoryBudget() / entry_size) {
+      TopN(limit);
+    } else {
+      ExternalSort();
+    }
+  }
+
+  bool Next(Tuple *tuple) override {
+    const Tuple *sorted = NextSorted();
+    if (sorted == nullptr) {
+      return false;
+    }
+    // The tuples of an in-memory sort live in the query's pool, so the caller gets a copy that owns its data.
+    *tuple = *sorted;
+    tuple->MakeOwned();
+    return true;
+  }
+
+  bool NextBatch(TupleBatch *batch) override {
+    batch->Reset();
+    const Tuple *sorted;
+    while (!batch->IsFull() && (sorted = NextSorted()) != nullptr) {
+      batch->AppendTuple(*sorted);
+    }
+    return !batch->IsEmpty();
+  }
+
+ private:
+  /** A buffered tuple and its evaluated sort keys. */
+  struct SortEntry {
+    std::vector<Value> keys_;
+    Tuple tuple_;
+    /** The position of the tuple in the child's output, used to keep the sort stable in a Top-N heap. */
+    size_t seq_;
+  };
+
+  /** Reads a run page by page during a merge. */
+  struct RunCursor {
+    explicit RunCursor(TmpTupleRun *run) : run_(run) {}
+
+    TmpTupleRun *run_;
+    size_t page_idx_{0};
+    std::vector<Tuple> tuples_;
+    size_t tuple_idx_{0};
+    /** The sort keys of the current tuple. */
+    std::vector<Value> keys_;
+  };
+
+  /** @return -1, 0 or 1 if a orders before, with or after b, with NULLs ordered first */
+  static int CompareValues(const Value &a, const Value &b) {
+    if (a.IsNull() || b.IsNull()) {
+      return static_cast<int>(b.IsNull()) - static_cast<int>(a.IsNull());
+    }
+    if (a.CompareLessThan(b) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    return a.CompareGreaterThan(b) == CmpBool::CmpTrue ? 1 : 0;
+  }
+
+  /** @return true if the sort keys a order strictly before the sort keys b */
+  bool KeysLess(const std::vector<Value> &a, const std::vector<Value> &b) const {
+    const auto &order_bys = plan_->GetOrderBys();
+    for (size_t i = 0; i < order_bys.size(); i++) {
+      // NULLs come first in either direction, so only the order of non-NULL values is reversed.
+      if (a[i].IsNull() != b[i].IsNull()) {
+        return a[i].IsNull();
+      }
+      int cmp = CompareValues(a[i], b[i]);
+      if (cmp != 0) {
+        return (order_bys[i].first == OrderByType::Ascending) == (cmp < 0);
+      }
+    }
+    return false;
+  }
+
+  /** @return the sort keys of a tuple of the child */
+  std::vector<Value> EvaluateKeys(const Tuple &tuple) {
+    std::vector<Value> keys;
+    keys.reserve(plan_->GetOrderBys().size());
+    for (const auto &[type, expr] : plan_->GetOrderBys()) {
+      keys.emplace_back(expr->Evaluate(&tuple, child_->GetOutputSchema()));
+    }
+    return keys;
+  }
+
+  /**
+   * @return the row_idx'th row of the batch as a sort entry, whose tuple is allocated from the given pool if there is
+   * one
+   */
+  SortEntry MakeEntry(const TupleBatch &batch, uint32_t row_idx, size_t seq, AbstractPool *pool = nullptr) {
+    SortEntry entry{{}, batch.GetTuple(row_idx, pool), seq};
+    entry.tuple_.SetRid(batch.GetRid(row_idx));
+    entry.keys_.reserve(plan_->GetOrderBys().size());
+    for (const auto &[type, expr] : plan_->GetOrderBys()) {
+      entry.keys_.emplace_back(expr->EvaluateAt(&batch, row_idx));
+    }
+    return entry;
+  }
+
+  /** @return the next tuple in sort order, valid until the next call, or nullptr once the sort is done */
+  const Tuple *NextSorted() {
+    if (num_produced_ == plan_->GetLimit()) {
+      return nullptr;
+    }
+    const Tuple *tuple = &merged_tuple_;
+    if (merge_heap_.empty()) {
+      if (next_idx_ == sorted_.size()) {
+        return nullptr;
+      }
+      tuple = &sorted_[next_idx_++].tuple_;
+    } else if (!NextMerged(&merged_tuple_)) {
+      return nullptr;
+    }
+    num_produced_++;
+    return tuple;
+  }
+
+  /** Keeps the best limit tuples of the child in a heap, leaving them sorted in sorted_. */
+  void TopN(size_t limit) {
+    // The heap is ordered by (keys, seq), so its top is the worst tuple kept so far, and a later tuple with equal keys
+    // never displaces an earlier one.
+    auto less = [this](const SortEntry &a, const SortEntry &b) {
+      return KeysLess(a.keys_, b.keys_) || (!KeysLess(b.keys_, a.keys_) && a.seq_ < b.seq_);
+    };
+    TupleBatch batch(child_->GetOutputSchema());
+    size_t seq = 0;
+    while (limit > 0 && child_->NextBatch(&batch)) {
+      for (uint32_t i = 0; i < batch.GetSize(); i++) {
+        SortEntry entry = MakeEntry(batch, i, seq++);
+        if (sorted_.size() < limit) {
+          sorted_.push_back(std::move(entry));
+          std::push_heap(sorted_.begin(), sorted_.end(), less);
+        } else if (less(entry, sorted_.front())) {
+          std::pop_heap(sorted_.begin(), sorted_.end(), less);
+          sorted_.back() = std::move(entry);
+          std::push_heap(sorted_.begin(), sorted_.end(), less);
+        }
+      }
+    }
+    std::sort_heap(sorted_.begin(), sorted_.end(), less);
+  }
+
+  /** Sorts the child's tuples in memory, or into runs that are merged down to a final merge if they do not fit. */
+  void ExternalSort() {
+    size_t budget = exec_ctx_->GetMemoryBudget();
+    size_t buffered_size = 0;
+    TupleBatch batch(child_->GetOutputSchema());
+    while (child_->NextBatch(&batch)) {
+      for (uint32_t i = 0; i < batch.GetSize(); i++) {
+        // Tuples that are sorted in memory live until the end of the query, so they come from the query's pool, which
+        // also makes moving them around while sorting free. Pool memory is only released with the query though, so
+        // once the sort spills, buffered tuples are allocated individually again and freed with their run.
+        AbstractPool *pool = runs_.empty() ? exec_ctx_->GetPool() : nullptr;
+        sorted_.push_back(MakeEntry(batch, i, 0, pool));
+        const auto &entry = sorted_.back();
+        buffered_size += sizeof(SortEntry) + entry.tuple_.GetLength() + entry.keys_.size() * sizeof(Value);
+        if (buffered_size > budget) {
+          SpillRun();
+          buffered_size = 0;
+        }
+      }
+    }
+    if (runs_.empty()) {
+      SortBuffered();
+      return;
+    }
+    if (!sorted_.empty()) {
+      SpillRun();
+    }
+
+    // Merge passes. Runs are merged in groups of consecutive runs, so equal keys keep the child's order.
+    size_t fan_in = std::max<size_t>(2, budget / PAGE_SIZE);
+    while (runs_.size() > fan_in) {
+      std::vector<std::unique_ptr<TmpTupleRun>> merged;
+      for (size_t begin = 0; begin < runs_.size(); begin += fan_in) {
+        size_t end = std::min(begin + fan_in, runs_.size());
+        if (end - begin == 1) {
+          merged.push_back(std::move(runs_[begin]));
+          continue;
+        }
+        OpenCursors(begin, end);
+        auto run = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+        Tuple tuple;
+        while (NextMerged(&tuple)) {
+          Append(run.get(), tuple);
+        }
+        cursors_.clear();
+        for (size_t i = begin; i < end; i++) {
+          runs_[i].reset();
+        }
+        merged.push_back(std::move(run));
+      }
+      runs_ = std::move(merged);
+    }
+    OpenCursors(0, runs_.size());
+  }
+
+  /** Sorts the buffered entries, keeping entries with equal keys in order. */
+  void SortBuffered() {
+    std::stable_sort(sorted_.begin(), sorted_.end(),
+                     [this](const SortEntry &a, const SortEntry &b) { return KeysLess(a.keys_, b.keys_); });
+  }
+
+  /** Sorts the buffered entries and writes them to a new run. */
+  void SpillRun() {
+    SortBuffered();
+    auto run = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+    for (const auto &entry : sorted_) {
+      Append(run.get(), entry.tuple_);
+    }
+    sorted_.clear();
+    runs_.push_back(std::move(run));
+  }
+
+  /** Appends a tuple to a run. */
+  static void Append(TmpTupleRun *run, const Tuple &tuple) {
+    if (!TmpTupleRun::Fits(tuple)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "sort cannot spill: tuple is larger than a page");
+    }
+    if (!run->Append(tuple)) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "sort cannot spill: all pages are pinned");
+    }
+  }
+
+  /** Starts merging the runs in [begin, end). */
+  void OpenCursors(size_t begin, size_t end) {
+    cursors_.clear();
+    merge_heap_.clear();
+    for (size_t i = begin; i < end; i++) {
+      cursors_.emplace_back(runs_[i].get());
+      if (Advance(&cursors_.back())) {
+        merge_heap_.push_back(cursors_.size() - 1);
+        std::push_heap(merge_heap_.begin(), merge_heap_.end(), MergeHeapOrder{this});
+      }
+    }
+  }
+
+  /** Orders the merge heap so that the cursor with the first tuple, or the earliest run on ties, is on top. */
+  struct MergeHeapOrder {
+    const SortExecutor *executor_;
+
+    bool operator()(size_t a, size_t b) const {
+      const auto &keys_a = executor_->cursors_[a].keys_;
+      const auto &keys_b = executor_->cursors_[b].keys_;
+      return executor_->KeysLess(keys_b, keys_a) || (!executor_->KeysLess(keys_a, keys_b) && b < a);
+    }
+  };
+
+  /**
+   * Moves a cursor to the next tuple of its run.
+   * @return false if the run is exhausted
+   */
+  bool Advance(RunCursor *cursor) {
+    cursor->tuple_idx_++;
+    while (cursor->tuple_idx_ >= cursor->tuples_.size()) {
+      if (cursor->page_idx_ == cursor->run_->GetPageCount()) {
+        return false;
+      }
+      cursor->tuples_.clear();
+      cursor->run_->ReadPage(cursor->page_idx_++, &cursor->tuples_);
+      cursor->tuple_idx_ = 0;
+    }
+    cursor->keys_ = EvaluateKeys(cursor->tuples_[cursor->tuple_idx_]);
+    return true;
+  }
+
+  /**
+   * Produces the next tuple of the current merge.
+   * @param[out] tuple the next tuple in sort order
+   * @return false if every merged run is exhausted
+   */
+  bool NextMerged(Tuple *tuple) {
+    if (merge_heap_.empty()) {
+      return false;
+    }
+    std::pop_heap(merge_heap_.begin(), merge_heap_.end(), MergeHeapOrder{this});
+    auto &cursor = cursors_[merge_heap_.back()];
+    *tuple = cursor.tuples_[cursor.tuple_idx_];
+    if (Advance(&cursor)) {
+      std::push_heap(merge_heap_.begin(), merge_heap_.end(), MergeHeapOrder{this});
+    } else {
+      merge_heap_.pop_back();
+    }
+    return true;
+  }
+
+  /** The sort plan node. */
+  const SortPlanNode *plan_;
+  /** The child executor whose tuples are sorted. */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** The buffered entries; once Init() returns, the sorted tuples of an in-memory sort or a Top-N. */
+  std::vector<SortEntry> sorted_;
+  /** The next entry of sorted_ to be produced. */
+  size_t next_idx_{0};
+  /** The sorted runs of an external sort. */
+  std::vector<std::unique_ptr<TmpTupleRun>> runs_;
+  /** The cursors of the runs being merged. */
+  std::vector<RunCursor> cursors_;
+  /** A heap of the indexes of the cursors that are not exhausted, ordered by MergeHeapOrder. */
+  std::vector<size_t> merge_heap_;
+  /** The last tuple produced by the final merge of an external sort. */
+  Tuple merged_tuple_;
+  /** The number of tuples produced so far. */
+  size_t num_produced_{0};
+};
+
+}  // namespace bustub
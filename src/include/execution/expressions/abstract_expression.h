@@ -17,6 +17,7 @@
 
 #include "catalog/schema.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 /**
@@ -39,6 +40,14 @@ class AbstractExpression {
   /** @return the value obtained by evaluating the tuple with the given schema */
   virtual Value Evaluate(const Tuple *tuple, const Schema *schema) const = 0;
 
+  /**
+   * Returns the value obtained by evaluating a single row of a batch.
+   * @param batch the batch containing the row
+   * @param row_idx the index of the row within the batch
+   * @return the value obtained by evaluating the row, using the schema of the batch
+   */
+  virtual Value EvaluateAt(const TupleBatch *batch, uint32_t row_idx) const = 0;
+
   /**
    * Returns the value obtained by evaluating a join.
    * @param left_tuple the left tuple
@@ -37,6 +37,10 @@ class AggregateValueExpression : public AbstractExpression {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
   }
 
+  Value EvaluateAt(const TupleBatch *batch, uint32_t row_idx) const override {
+    BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
+  }
+
   Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
                      const Schema *right_schema) const override {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
@@ -33,8 +33,18 @@ class ColumnValueExpression : public AbstractExpression {
   ColumnValueExpression(uint32_t tuple_idx, uint32_t col_idx, TypeId ret_type)
       : AbstractExpression({}, ret_type), tuple_idx_{tuple_idx}, col_idx_{col_idx} {}
 
+  /** @return the tuple index, 0 for the left side of a join and 1 for the right side */
+  uint32_t GetTupleIdx() const { return tuple_idx_; }
+
+  /** @return the index of the column in the schema */
+  uint32_t GetColIdx() const { return col_idx_; }
+
   Value Evaluate(const Tuple *tuple, const Schema *schema) const override { return tuple->GetValue(schema, col_idx_); }
 
+  Value EvaluateAt(const TupleBatch *batch, uint32_t row_idx) const override {
+    return batch->GetValue(row_idx, col_idx_);
+  }
+
   Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
                      const Schema *right_schema) const override {
     return tuple_idx_ == 0 ? left_tuple->GetValue(left_schema, col_idx_)
@@ -40,6 +40,12 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  Value EvaluateAt(const TupleBatch *batch, uint32_t row_idx) const override {
+    Value lhs = GetChildAt(0)->EvaluateAt(batch, row_idx);
+    Value rhs = GetChildAt(1)->EvaluateAt(batch, row_idx);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
   Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
                      const Schema *right_schema) const override {
     Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
@@ -53,6 +59,9 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  /** @return the type of comparison that this expression performs */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
  private:
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
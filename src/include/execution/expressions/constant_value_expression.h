@@ -27,6 +27,8 @@ class ConstantValueExpression : public AbstractExpression {
 
   Value Evaluate(const Tuple *tuple, const Schema *schema) const override { return val_; }
 
+  Value EvaluateAt(const TupleBatch *batch, uint32_t row_idx) const override { return val_; }
+
   Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
                      const Schema *right_schema) const override {
     return val_;
@@ -36,6 +38,9 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  /** @return the constant value */
+  const Value &GetValue() const { return val_; }
+
  private:
   Value val_;
 };
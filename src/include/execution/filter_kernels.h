@@ -0,0 +1,549 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels.h
+//
+// Identification: src/include/execution/filter_kernels.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "execution/expressions/comparison_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+#if defined(__AVX2__)
+/**
+ * SimdLanes wraps the vector instructions for values of type T: loading and broadcasting values, and comparing two
+ * vectors into a bitmask with one bit per lane. There are AVX-512 versions when the build targets AVX-512BW, and AVX2
+ * versions otherwise.
+ */
+template <typename T>
+struct SimdLanes;
+
+#if defined(__AVX512BW__)
+/** @return the _MM_CMPINT_* predicate of an integer comparison */
+template <ComparisonType CMP>
+constexpr int SimdIntPredicate() {
+  switch (CMP) {
+    case ComparisonType::Equal:
+      return _MM_CMPINT_EQ;
+    case ComparisonType::NotEqual:
+      return _MM_CMPINT_NE;
+    case ComparisonType::LessThan:
+      return _MM_CMPINT_LT;
+    case ComparisonType::LessThanOrEqual:
+      return _MM_CMPINT_LE;
+    case ComparisonType::GreaterThan:
+      return _MM_CMPINT_NLE;
+    case ComparisonType::GreaterThanOrEqual:
+    default:
+      return _MM_CMPINT_NLT;
+  }
+}
+
+template <>
+struct SimdLanes<int8_t> {
+  using Vec = __m512i;
+  static constexpr uint32_t LANES = 64;
+  static Vec Load(const int8_t *values) { return _mm512_loadu_si512(values); }
+  static Vec Broadcast(int8_t value) { return _mm512_set1_epi8(value); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    constexpr int PREDICATE = SimdIntPredicate<CMP>();
+    return _mm512_cmp_epi8_mask(a, b, PREDICATE);
+  }
+};
+
+template <>
+struct SimdLanes<int16_t> {
+  using Vec = __m512i;
+  static constexpr uint32_t LANES = 32;
+  static Vec Load(const int16_t *values) { return _mm512_loadu_si512(values); }
+  static Vec Broadcast(int16_t value) { return _mm512_set1_epi16(value); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    constexpr int PREDICATE = SimdIntPredicate<CMP>();
+    return _mm512_cmp_epi16_mask(a, b, PREDICATE);
+  }
+};
+
+template <>
+struct SimdLanes<int32_t> {
+  using Vec = __m512i;
+  static constexpr uint32_t LANES = 16;
+  static Vec Load(const int32_t *values) { return _mm512_loadu_si512(values); }
+  static Vec Broadcast(int32_t value) { return _mm512_set1_epi32(value); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    constexpr int PREDICATE = SimdIntPredicate<CMP>();
+    return _mm512_cmp_epi32_mask(a, b, PREDICATE);
+  }
+};
+
+template <>
+struct SimdLanes<int64_t> {
+  using Vec = __m512i;
+  static constexpr uint32_t LANES = 8;
+  static Vec Load(const int64_t *values) { return _mm512_loadu_si512(values); }
+  static Vec Broadcast(int64_t value) { return _mm512_set1_epi64(value); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    constexpr int PREDICATE = SimdIntPredicate<CMP>();
+    return _mm512_cmp_epi64_mask(a, b, PREDICATE);
+  }
+};
+
+template <>
+struct SimdLanes<uint64_t> {
+  using Vec = __m512i;
+  static constexpr uint32_t LANES = 8;
+  static Vec Load(const uint64_t *values) { return _mm512_loadu_si512(values); }
+  static Vec Broadcast(uint64_t value) { return _mm512_set1_epi64(static_cast<int64_t>(value)); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    constexpr int PREDICATE = SimdIntPredicate<CMP>();
+    return _mm512_cmp_epu64_mask(a, b, PREDICATE);
+  }
+};
+
+template <>
+struct SimdLanes<double> {
+  using Vec = __m512d;
+  static constexpr uint32_t LANES = 8;
+  static Vec Load(const double *values) { return _mm512_loadu_pd(values); }
+  static Vec Broadcast(double value) { return _mm512_set1_pd(value); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    // Like the scalar operators, comparisons with NaN are false except for "not equal".
+    switch (CMP) {
+      case ComparisonType::Equal:
+        return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+      case ComparisonType::NotEqual:
+        return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ);
+      case ComparisonType::LessThan:
+        return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+      case ComparisonType::LessThanOrEqual:
+        return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ);
+      case ComparisonType::GreaterThan:
+        return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ);
+      case ComparisonType::GreaterThanOrEqual:
+      default:
+        return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ);
+    }
+  }
+};
+#else
+/**
+ * AVX2 only has "equal" and signed "greater than" integer comparisons, so the other comparisons are derived from them.
+ * @return the bitmask of the lanes of a and b for which the comparison holds
+ */
+template <typename Lanes, ComparisonType CMP>
+uint64_t SimdCompareWithEqualAndGreater(typename Lanes::Vec a, typename Lanes::Vec b) {
+  constexpr uint64_t ALL_LANES = (uint64_t{1} << Lanes::LANES) - 1;
+  switch (CMP) {
+    case ComparisonType::Equal:
+      return Lanes::Equal(a, b);
+    case ComparisonType::NotEqual:
+      return ~Lanes::Equal(a, b) & ALL_LANES;
+    case ComparisonType::LessThan:
+      return Lanes::Greater(b, a);
+    case ComparisonType::LessThanOrEqual:
+      return ~Lanes::Greater(a, b) & ALL_LANES;
+    case ComparisonType::GreaterThan:
+      return Lanes::Greater(a, b);
+    case ComparisonType::GreaterThanOrEqual:
+    default:
+      return ~Lanes::Greater(b, a) & ALL_LANES;
+  }
+}
+
+template <>
+struct SimdLanes<int8_t> {
+  using Vec = __m256i;
+  static constexpr uint32_t LANES = 32;
+  static Vec Load(const int8_t *values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)); }
+  static Vec Broadcast(int8_t value) { return _mm256_set1_epi8(value); }
+  static uint64_t Mask(Vec v) { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+  static uint64_t Equal(Vec a, Vec b) { return Mask(_mm256_cmpeq_epi8(a, b)); }
+  static uint64_t Greater(Vec a, Vec b) { return Mask(_mm256_cmpgt_epi8(a, b)); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    return SimdCompareWithEqualAndGreater<SimdLanes, CMP>(a, b);
+  }
+};
+
+template <>
+struct SimdLanes<int16_t> {
+  using Vec = __m256i;
+  static constexpr uint32_t LANES = 16;
+  static Vec Load(const int16_t *values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)); }
+  static Vec Broadcast(int16_t value) { return _mm256_set1_epi16(value); }
+  static uint64_t Mask(Vec v) {
+    // Narrow the 16-bit lanes to bytes first, so that there is one mask bit per lane.
+    __m128i bytes = _mm_packs_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+  }
+  static uint64_t Equal(Vec a, Vec b) { return Mask(_mm256_cmpeq_epi16(a, b)); }
+  static uint64_t Greater(Vec a, Vec b) { return Mask(_mm256_cmpgt_epi16(a, b)); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    return SimdCompareWithEqualAndGreater<SimdLanes, CMP>(a, b);
+  }
+};
+
+template <>
+struct SimdLanes<int32_t> {
+  using Vec = __m256i;
+  static constexpr uint32_t LANES = 8;
+  static Vec Load(const int32_t *values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)); }
+  static Vec Broadcast(int32_t value) { return _mm256_set1_epi32(value); }
+  static uint64_t Mask(Vec v) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(v))); }
+  static uint64_t Equal(Vec a, Vec b) { return Mask(_mm256_cmpeq_epi32(a, b)); }
+  static uint64_t Greater(Vec a, Vec b) { return Mask(_mm256_cmpgt_epi32(a, b)); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    return SimdCompareWithEqualAndGreater<SimdLanes, CMP>(a, b);
+  }
+};
+
+template <>
+struct SimdLanes<int64_t> {
+  using Vec = __m256i;
+  static constexpr uint32_t LANES = 4;
+  static Vec Load(const int64_t *values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)); }
+  static Vec Broadcast(int64_t value) { return _mm256_set1_epi64x(value); }
+  static uint64_t Mask(Vec v) { return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(v))); }
+  static uint64_t Equal(Vec a, Vec b) { return Mask(_mm256_cmpeq_epi64(a, b)); }
+  static uint64_t Greater(Vec a, Vec b) { return Mask(_mm256_cmpgt_epi64(a, b)); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    return SimdCompareWithEqualAndGreater<SimdLanes, CMP>(a, b);
+  }
+};
+
+template <>
+struct SimdLanes<uint64_t> {
+  // Unsigned values are compared as signed ones with their sign bit flipped, which keeps their order.
+  using Vec = __m256i;
+  static constexpr uint32_t LANES = 4;
+  static Vec FlipSign(Vec v) { return _mm256_xor_si256(v, _mm256_set1_epi64x(INT64_MIN)); }
+  static Vec Load(const uint64_t *values) {
+    return FlipSign(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)));
+  }
+  static Vec Broadcast(uint64_t value) { return FlipSign(_mm256_set1_epi64x(static_cast<int64_t>(value))); }
+  static uint64_t Equal(Vec a, Vec b) { return SimdLanes<int64_t>::Equal(a, b); }
+  static uint64_t Greater(Vec a, Vec b) { return SimdLanes<int64_t>::Greater(a, b); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    return SimdCompareWithEqualAndGreater<SimdLanes, CMP>(a, b);
+  }
+};
+
+template <>
+struct SimdLanes<double> {
+  using Vec = __m256d;
+  static constexpr uint32_t LANES = 4;
+  static Vec Load(const double *values) { return _mm256_loadu_pd(values); }
+  static Vec Broadcast(double value) { return _mm256_set1_pd(value); }
+  template <ComparisonType CMP>
+  static uint64_t Compare(Vec a, Vec b) {
+    // Like the scalar operators, comparisons with NaN are false except for "not equal".
+    switch (CMP) {
+      case ComparisonType::Equal:
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+      case ComparisonType::NotEqual:
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ)));
+      case ComparisonType::LessThan:
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)));
+      case ComparisonType::LessThanOrEqual:
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)));
+      case ComparisonType::GreaterThan:
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)));
+      case ComparisonType::GreaterThanOrEqual:
+      default:
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ)));
+    }
+  }
+};
+#endif
+#endif
+
+/**
+ * FilterKernels are the comparison and selection loops that filter columns of fixed-width values, as they are stored
+ * in a TupleBatch: int8_t for BOOLEAN and TINYINT, int16_t for SMALLINT, int32_t for INTEGER, int64_t for BIGINT,
+ * double for DECIMAL and uint64_t for TIMESTAMP.
+ *
+ * The kernels are vectorized with AVX-512 or AVX2, whichever the build targets, and compare a block of rows per
+ * iteration into bitmasks. The rows that do not fill a whole block, and every row on targets without either
+ * instruction set, go through the scalar versions of the same loops.
+ *
+ * Comparisons follow Value semantics: a comparison with a NULL operand is NULL. Constant operands are never NULL.
+ */
+class FilterKernels {
+ public:
+#if defined(__AVX512BW__)
+  /** The number of rows compared per vectorized iteration, or 0 if the kernels are not vectorized. */
+  static constexpr uint32_t BLOCK_SIZE = 64;
+#elif defined(__AVX2__)
+  static constexpr uint32_t BLOCK_SIZE = 32;
+#else
+  static constexpr uint32_t BLOCK_SIZE = 0;
+#endif
+
+  /** @return the value that represents NULL in the serialized form of T */
+  template <typename T>
+  static constexpr T NullOf() {
+    if constexpr (std::is_same_v<T, int8_t>) {
+      return BUSTUB_INT8_NULL;
+    } else if constexpr (std::is_same_v<T, int16_t>) {
+      return BUSTUB_INT16_NULL;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+      return BUSTUB_INT32_NULL;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      return BUSTUB_INT64_NULL;
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+      return BUSTUB_TIMESTAMP_NULL;
+    } else {
+      return BUSTUB_DECIMAL_NULL;
+    }
+  }
+
+  /**
+   * Compares the values of two operands row by row.
+   * @param left the n left values, or the constant left value if LEFT_CONSTANT
+   * @param right the n right values, or the constant right value if RIGHT_CONSTANT
+   * @param[out] out the n results as CmpBool values, i.e. 1, 0 or BUSTUB_BOOLEAN_NULL
+   * @param n the number of rows
+   */
+  template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+  static void Compare(const T *left, const T *right, int8_t *out, uint32_t n) {
+    uint32_t i = 0;
+#if defined(__AVX2__)
+    BlockComparator<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT> comparator(left, right);
+    for (; i + BLOCK_SIZE <= n; i += BLOCK_SIZE) {
+      uint64_t null;
+      uint64_t cmp = comparator.Compare(i, &null);
+      StoreBlock(cmp, null, out + i);
+    }
+#endif
+    CompareScalar<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>(left, right, out, i, n);
+  }
+
+  /**
+   * Compares the values of two operands row by row and selects the rows whose result is not false, i.e. the rows for
+   * which Compare() would write a nonzero value. This fuses Compare() and Select() for predicates of one comparison.
+   * @param left the n left values, or the constant left value if LEFT_CONSTANT
+   * @param right the n right values, or the constant right value if RIGHT_CONSTANT
+   * @param n the number of rows
+   * @param[out] sel the indexes of the selected rows, in increasing order; must have room for n indexes
+   * @return the number of selected rows
+   */
+  template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+  static uint32_t CompareSelect(const T *left, const T *right, uint32_t n, uint32_t *sel) {
+    uint32_t i = 0;
+    uint32_t count = 0;
+#if defined(__AVX2__)
+    BlockComparator<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT> comparator(left, right);
+    for (; i + BLOCK_SIZE <= n; i += BLOCK_SIZE) {
+      uint64_t null;
+      uint64_t cmp = comparator.Compare(i, &null);
+      count = SelectBlock(cmp | null, i, sel, count);
+    }
+#endif
+    for (; i < n; i++) {
+      sel[count] = i;
+      count += static_cast<uint32_t>(CompareOne<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>(left, right, i) != 0);
+    }
+    return count;
+  }
+
+  /**
+   * Selects the rows with a nonzero value.
+   * @param values the n values, e.g. the results of Compare()
+   * @param n the number of rows
+   * @param[out] sel the indexes of the selected rows, in increasing order; must have room for n indexes
+   * @return the number of selected rows
+   */
+  static uint32_t Select(const int8_t *values, uint32_t n, uint32_t *sel) {
+    uint32_t i = 0;
+    uint32_t count = 0;
+#if defined(__AVX2__)
+    for (; i + BLOCK_SIZE <= n; i += BLOCK_SIZE) {
+      count = SelectBlock(NonZero(values + i), i, sel, count);
+    }
+#endif
+    for (; i < n; i++) {
+      sel[count] = i;
+      count += static_cast<uint32_t>(values[i] != 0);
+    }
+    return count;
+  }
+
+  /** The scalar version of Compare(), for the rows in [begin, n). */
+  template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+  static void CompareScalar(const T *left, const T *right, int8_t *out, uint32_t begin, uint32_t n) {
+    for (uint32_t i = begin; i < n; i++) {
+      out[i] = CompareOne<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>(left, right, i);
+    }
+  }
+
+ private:
+  /** @return the CmpBool result of comparing the values of a row */
+  template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+  static int8_t CompareOne(const T *left, const T *right, uint32_t i) {
+    T l = LEFT_CONSTANT ? left[0] : left[i];
+    T r = RIGHT_CONSTANT ? right[0] : right[i];
+    bool is_null = (!LEFT_CONSTANT && l == NullOf<T>()) || (!RIGHT_CONSTANT && r == NullOf<T>());
+    bool result;
+    if constexpr (CMP == ComparisonType::Equal) {
+      result = l == r;
+    } else if constexpr (CMP == ComparisonType::NotEqual) {
+      result = l != r;
+    } else if constexpr (CMP == ComparisonType::LessThan) {
+      result = l < r;
+    } else if constexpr (CMP == ComparisonType::LessThanOrEqual) {
+      result = l <= r;
+    } else if constexpr (CMP == ComparisonType::GreaterThan) {
+      result = l > r;
+    } else {
+      result = l >= r;
+    }
+    return is_null ? BUSTUB_BOOLEAN_NULL : static_cast<int8_t>(result);
+  }
+
+#if defined(__AVX2__)
+  /** BlockComparator compares a block of BLOCK_SIZE rows into a bitmask, keeping constant operands in vectors. */
+  template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+  class BlockComparator {
+    using Lanes = SimdLanes<T>;
+    using Vec = typename Lanes::Vec;
+
+   public:
+    BlockComparator(const T *left, const T *right)
+        : left_(left),
+          right_(right),
+          left_constant_(Lanes::Broadcast(LEFT_CONSTANT ? left[0] : T{})),
+          right_constant_(Lanes::Broadcast(RIGHT_CONSTANT ? right[0] : T{})),
+          null_(Lanes::Broadcast(NullOf<T>())) {}
+
+    /**
+     * Compares the rows in [begin, begin + BLOCK_SIZE).
+     * @param begin the first row of the block
+     * @param[out] null the bitmask of the rows whose result is NULL
+     * @return the bitmask of the rows for which the comparison holds, ignoring NULLs
+     */
+    uint64_t Compare(uint32_t begin, uint64_t *null) const {
+      uint64_t cmp = 0;
+      *null = 0;
+      for (uint32_t j = 0; j < BLOCK_SIZE; j += Lanes::LANES) {
+        Vec l = LEFT_CONSTANT ? left_constant_ : Lanes::Load(left_ + begin + j);
+        Vec r = RIGHT_CONSTANT ? right_constant_ : Lanes::Load(right_ + begin + j);
+        cmp |= Lanes::template Compare<CMP>(l, r) << j;
+        if constexpr (!LEFT_CONSTANT) {
+          *null |= Lanes::template Compare<ComparisonType::Equal>(l, null_) << j;
+        }
+        if constexpr (!RIGHT_CONSTANT) {
+          *null |= Lanes::template Compare<ComparisonType::Equal>(r, null_) << j;
+        }
+      }
+      return cmp;
+    }
+
+   private:
+    const T *left_;
+    const T *right_;
+    Vec left_constant_;
+    Vec right_constant_;
+    Vec null_;
+  };
+
+#if defined(__AVX512BW__)
+  /** Writes the CmpBool results of a block, given the bitmasks of its true and NULL results. */
+  static void StoreBlock(uint64_t cmp, uint64_t null, int8_t *out) {
+    __m512i values =
+        _mm512_mask_blend_epi8(null, _mm512_maskz_set1_epi8(cmp, 1), _mm512_set1_epi8(BUSTUB_BOOLEAN_NULL));
+    _mm512_storeu_si512(out, values);
+  }
+
+  /** @return the bitmask of the nonzero values of a block */
+  static uint64_t NonZero(const int8_t *values) {
+    __m512i v = _mm512_loadu_si512(values);
+    return _mm512_test_epi8_mask(v, v);
+  }
+
+  /**
+   * Appends the rows of a block whose bit is set to a selection vector.
+   * @param mask the bitmask of the rows of the block to select
+   * @param begin the first row of the block
+   * @param[out] sel the selection vector
+   * @param count the number of rows in the selection vector
+   * @return the new number of rows in the selection vector
+   */
+  static uint32_t SelectBlock(uint64_t mask, uint32_t begin, uint32_t *sel, uint32_t count) {
+    __m512i rows = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int32_t>(begin)),
+                                    _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    for (uint32_t j = 0; j < BLOCK_SIZE; j += 16) {
+      auto part = static_cast<__mmask16>(mask >> j);
+      _mm512_mask_compressstoreu_epi32(sel + count, part, rows);
+      count += static_cast<uint32_t>(__builtin_popcount(part));
+      rows = _mm512_add_epi32(rows, _mm512_set1_epi32(16));
+    }
+    return count;
+  }
+#else
+  /** @return a vector whose byte i is 0xFF if bit i of mask is set, and 0 otherwise */
+  static __m256i ExpandBits(uint64_t mask) {
+    // Copy mask byte k into bytes 8k to 8k+7, then keep only bit i % 8 of byte i.
+    __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int32_t>(mask)),
+                                        _mm256_setr_epi64x(0x0000000000000000, 0x0101010101010101,
+                                                           0x0202020202020202, 0x0303030303030303));
+    __m256i bits = _mm256_set1_epi64x(static_cast<int64_t>(0x8040201008040201));
+    return _mm256_cmpeq_epi8(_mm256_and_si256(bytes, bits), bits);
+  }
+
+  /** Writes the CmpBool results of a block, given the bitmasks of its true and NULL results. */
+  static void StoreBlock(uint64_t cmp, uint64_t null, int8_t *out) {
+    __m256i values = _mm256_and_si256(ExpandBits(cmp), _mm256_set1_epi8(1));
+    values = _mm256_blendv_epi8(values, _mm256_set1_epi8(BUSTUB_BOOLEAN_NULL), ExpandBits(null));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), values);
+  }
+
+  /** @return the bitmask of the nonzero values of a block */
+  static uint64_t NonZero(const int8_t *values) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+  }
+
+  /**
+   * Appends the rows of a block whose bit is set to a selection vector.
+   * @param mask the bitmask of the rows of the block to select
+   * @param begin the first row of the block
+   * @param[out] sel the selection vector
+   * @param count the number of rows in the selection vector
+   * @return the new number of rows in the selection vector
+   */
+  static uint32_t SelectBlock(uint64_t mask, uint32_t begin, uint32_t *sel, uint32_t count) {
+    while (mask != 0) {
+      sel[count++] = begin + static_cast<uint32_t>(__builtin_ctzll(mask));
+      mask &= mask - 1;
+    }
+    return count;
+  }
+#endif
+#endif
+};
+
+}  // namespace bustub
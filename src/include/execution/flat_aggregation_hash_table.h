@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_aggregation_hash_table.h
+//
+// Identification: src/include/execution/flat_aggregation_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/plans/aggregation_plan.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+/**
+ * FlatAggregationHashTable is an aggregation hash table for group keys and aggregate inputs that fit in 64-bit
+ * integers.
+ *
+ * Every group is a slot of an open-addressing array with linear probing. A slot holds a tag word (the group's hash
+ * with the lowest bit set, or 0 if the slot is free), followed by the group's key words and its accumulators, so a
+ * lookup touches a single contiguous run of memory and adding a group never allocates. The array doubles when it gets
+ * half full.
+ *
+ * The accumulators follow SimpleAggregationHashTable: a count starts at 0 and increases by one for every row, a sum
+ * starts at 0, a min starts at BUSTUB_INT32_MAX and a max starts at BUSTUB_INT32_MIN.
+ */
+class FlatAggregationHashTable {
+ public:
+  /**
+   * Creates a new flat aggregation hash table.
+   * @param num_keys the number of group-by keys
+   * @param agg_types the types of aggregations
+   * @param initial_capacity the initial number of slots, rounded up to a power of two
+   */
+  FlatAggregationHashTable(uint32_t num_keys, std::vector<AggregationType> agg_types, size_t initial_capacity = 1024)
+      : num_keys_(num_keys), agg_types_(std::move(agg_types)), stride_(1 + num_keys_ + agg_types_.size()) {
+    size_t capacity = 1;
+    while (capacity < initial_capacity) {
+      capacity <<= 1;
+    }
+    Resize(capacity);
+  }
+
+  /** @return the hash of a group key */
+  hash_t Hash(const int64_t *key) const {
+    return HashUtil::HashBytes(reinterpret_cast<const char *>(key), num_keys_ * sizeof(int64_t));
+  }
+
+  /**
+   * Combines one row into the accumulators of its group, adding the group if it is not in the table yet.
+   * @param key the group key of the row, num_keys words
+   * @param hash the hash of the group key, as returned by Hash()
+   * @param inputs the aggregate inputs of the row, one word per aggregation
+   */
+  void InsertCombine(const int64_t *key, hash_t hash, const int64_t *inputs) {
+    int64_t *accumulators = FindOrInsert(key, hash) + num_keys_;
+    for (size_t i = 0; i < agg_types_.size(); i++) {
+      switch (agg_types_[i]) {
+        case AggregationType::CountAggregate:
+          accumulators[i]++;
+          break;
+        case AggregationType::SumAggregate:
+          accumulators[i] += inputs[i];
+          break;
+        case AggregationType::MinAggregate:
+          accumulators[i] = std::min(accumulators[i], inputs[i]);
+          break;
+        case AggregationType::MaxAggregate:
+          accumulators[i] = std::max(accumulators[i], inputs[i]);
+          break;
+      }
+    }
+  }
+
+  /** @return the number of groups in the table */
+  size_t Size() const { return size_; }
+
+  /**
+   * Calls f(key, accumulators) for every group, in no particular order.
+   * @param f the function to call with pointers to the key words and the accumulators of a group
+   */
+  template <typename F>
+  void ForEach(const F &f) const {
+    for (size_t slot = 0; slot < slots_.size(); slot += stride_) {
+      if (slots_[slot] != 0) {
+        f(&slots_[slot + 1], &slots_[slot + 1 + num_keys_]);
+      }
+    }
+  }
+
+ private:
+  /** @return the key words of the key's group, followed by its accumulators */
+  int64_t *FindOrInsert(const int64_t *key, hash_t hash) {
+    auto tag = static_cast<int64_t>(hash | 1);
+    size_t key_bytes = num_keys_ * sizeof(int64_t);
+    for (size_t idx = HomeSlot(tag);; idx = (idx + 1) & mask_) {
+      int64_t *slot = &slots_[idx * stride_];
+      if (slot[0] == tag && std::memcmp(slot + 1, key, key_bytes) == 0) {
+        return slot + 1;
+      }
+      if (slot[0] == 0) {
+        if (2 * (size_ + 1) > mask_ + 1) {
+          Resize(2 * (mask_ + 1));
+          return FindOrInsert(key, hash);
+        }
+        slot[0] = tag;
+        std::memcpy(slot + 1, key, key_bytes);
+        InitAccumulators(slot + 1 + num_keys_);
+        size_++;
+        return slot + 1;
+      }
+    }
+  }
+
+  /** @return the first slot to probe for a group with the given tag; the lowest bit of a tag is always set */
+  size_t HomeSlot(int64_t tag) const { return (static_cast<uint64_t>(tag) >> 1) & mask_; }
+
+  /** Sets the accumulators of a new group to their initial values. */
+  void InitAccumulators(int64_t *accumulators) const {
+    for (size_t i = 0; i < agg_types_.size(); i++) {
+      switch (agg_types_[i]) {
+        case AggregationType::CountAggregate:
+        case AggregationType::SumAggregate:
+          accumulators[i] = 0;
+          break;
+        case AggregationType::MinAggregate:
+          accumulators[i] = BUSTUB_INT32_MAX;
+          break;
+        case AggregationType::MaxAggregate:
+          accumulators[i] = BUSTUB_INT32_MIN;
+          break;
+      }
+    }
+  }
+
+  /** Rehashes every group into a slot array of the given number of slots. */
+  void Resize(size_t capacity) {
+    std::vector<int64_t> old_slots(capacity * stride_, 0);
+    slots_.swap(old_slots);
+    mask_ = capacity - 1;
+    for (size_t slot = 0; slot < old_slots.size(); slot += stride_) {
+      if (old_slots[slot] == 0) {
+        continue;
+      }
+      size_t idx = HomeSlot(old_slots[slot]);
+      while (slots_[idx * stride_] != 0) {
+        idx = (idx + 1) & mask_;
+      }
+      std::copy(&old_slots[slot], &old_slots[slot] + stride_, &slots_[idx * stride_]);
+    }
+  }
+
+  /** The number of key words of a group. */
+  uint32_t num_keys_;
+  /** The types of aggregations, one accumulator word each. */
+  std::vector<AggregationType> agg_types_;
+  /** The number of words in a slot. */
+  size_t stride_;
+  /** The slot array. */
+  std::vector<int64_t> slots_;
+  /** The number of slots minus one; the number of slots is a power of two. */
+  size_t mask_{0};
+  /** The number of groups. */
+  size_t size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_key.h
+//
+// Identification: src/include/execution/join_key.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "common/macros.h"
+#include "common/util/hash_util.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * JoinKey is the evaluated equi-join key of a row: the combined hash of its key values, and the key values themselves
+ * in a normalized binary form that is equal for two rows exactly when their keys are equal.
+ */
+struct JoinKey {
+  /** The hash of the key values, combined the same way as HashJoinExecutor::HashValues() does. */
+  hash_t hash_{0};
+  /** The key values, with integers widened to 64 bits and strings prefixed by their length. */
+  std::string bytes_;
+
+  /**
+   * Combines the hash of one key value into the hash of a key, for callers that need the hash but not the bytes.
+   * @param val the key value
+   * @param[in,out] hash the hash of the key so far
+   * @return false if the value is NULL, in which case the row cannot join with anything
+   */
+  static bool AppendHash(const Value &val, hash_t *hash) {
+    if (val.IsNull()) {
+      return false;
+    }
+    *hash = HashUtil::CombineHashes(*hash, HashUtil::HashValue(&val));
+    return true;
+  }
+
+  /**
+   * Appends one key value to this key.
+   * @param val the key value
+   * @return false if the value is NULL, in which case the row cannot join with anything
+   */
+  bool Append(const Value &val) {
+    if (!AppendHash(val, &hash_)) {
+      return false;
+    }
+    auto append = [this](const auto &raw) { bytes_.append(reinterpret_cast<const char *>(&raw), sizeof(raw)); };
+    switch (val.GetTypeId()) {
+      case TypeId::TINYINT:
+        append(static_cast<int64_t>(val.GetAs<int8_t>()));
+        break;
+      case TypeId::SMALLINT:
+        append(static_cast<int64_t>(val.GetAs<int16_t>()));
+        break;
+      case TypeId::INTEGER:
+        append(static_cast<int64_t>(val.GetAs<int32_t>()));
+        break;
+      case TypeId::BIGINT:
+        append(val.GetAs<int64_t>());
+        break;
+      case TypeId::BOOLEAN:
+        append(val.GetAs<int8_t>());
+        break;
+      case TypeId::DECIMAL:
+        append(val.GetAs<double>());
+        break;
+      case TypeId::TIMESTAMP:
+        append(val.GetAs<uint64_t>());
+        break;
+      case TypeId::VARCHAR:
+        append(val.GetLength());
+        bytes_.append(val.GetData(), val.GetLength());
+        break;
+      default:
+        UNREACHABLE("Unsupported join key type.");
+    }
+    return true;
+  }
+};
+
+}  // namespace bustub
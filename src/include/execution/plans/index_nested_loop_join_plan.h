@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_nested_loop_join_plan.h
+//
+// Identification: src/include/execution/plans/index_nested_loop_join_plan.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/simple_catalog.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * IndexNestedLoopJoinPlanNode joins the tuples of its single child (the outer side) with the tuples of a table (the
+ * inner side) by looking up the join key of every outer tuple in an index on that table.
+ *
+ * The predicate and the output columns are evaluated with EvaluateJoin(), with the outer tuple on the left and the
+ * inner table tuple, in the table's schema, on the right.
+ */
+class IndexNestedLoopJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new index nested loop join plan node.
+   * @param output_schema the output format of this plan node
+   * @param outer the child plan whose tuples are looked up in the index
+   * @param predicate the join predicate, or nullptr if every pair of tuples with equal keys should be joined
+   * @param index_oid the identifier of the index on the inner table
+   * @param outer_keys the expressions that make up the key of an outer tuple, one per column of the index's key schema
+   */
+  IndexNestedLoopJoinPlanNode(const Schema *output_schema, const AbstractPlanNode *outer,
+                              const AbstractExpression *predicate, index_oid_t index_oid,
+                              std::vector<const AbstractExpression *> &&outer_keys)
+      : AbstractPlanNode(output_schema, {outer}),
+        predicate_(predicate),
+        index_oid_(index_oid),
+        outer_keys_(std::move(outer_keys)) {}
+
+  PlanType GetType() const override { return PlanType::IndexNestedLoopJoin; }
+
+  /** @return the join predicate, or nullptr */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the outer plan node of the join */
+  const AbstractPlanNode *GetOuterPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Index nested loop joins should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the identifier of the index on the inner table */
+  index_oid_t GetIndexOid() const { return index_oid_; }
+
+  /** @return the expressions that make up the key of an outer tuple */
+  const std::vector<const AbstractExpression *> &GetOuterKeys() const { return outer_keys_; }
+
+ private:
+  /** The join predicate. */
+  const AbstractExpression *predicate_;
+  /** The index on the inner table. */
+  index_oid_t index_oid_;
+  /** The outer child's key expressions. */
+  std::vector<const AbstractExpression *> outer_keys_;
+};
+
+}  // namespace bustub
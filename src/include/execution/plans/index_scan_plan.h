@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_plan.h
+//
+// Identification: src/include/execution/plans/index_scan_plan.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/simple_catalog.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * IndexScanPlanNode identifies the tuples of a table whose index key equals one of a list of keys, with an optional
+ * predicate that the tuples must also satisfy.
+ */
+class IndexScanPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new index scan plan node.
+   * @param output the output format of this scan plan node
+   * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) = true or predicate = nullptr
+   * @param index_oid the identifier of the index to look the keys up in
+   * @param keys the keys to look up, each holding one value per column of the index's key schema
+   */
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid,
+                    std::vector<std::vector<Value>> &&keys)
+      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid), keys_(std::move(keys)) {}
+
+  PlanType GetType() const override { return PlanType::IndexScan; }
+
+  /** @return the predicate to test tuples against; tuples should only be returned if they evaluate to true */
+  const AbstractExpression *GetPredicate() const { return predicate_; }
+
+  /** @return the identifier of the index that should be scanned */
+  index_oid_t GetIndexOid() const { return index_oid_; }
+
+  /** @return the keys to look up */
+  const std::vector<std::vector<Value>> &GetKeys() const { return keys_; }
+
+ private:
+  /** The predicate that all returned tuples must satisfy. */
+  const AbstractExpression *predicate_;
+  /** The index whose keys should be looked up. */
+  index_oid_t index_oid_;
+  /** The keys to look up. */
+  std::vector<std::vector<Value>> keys_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType enumerates the directions that a sort key can be ordered in. */
+enum class OrderByType { Ascending, Descending };
+
+/**
+ * SortPlanNode represents an ORDER BY clause, optionally followed by a LIMIT.
+ * The sort produces the tuples of its single child unchanged, so its output schema must be the child's output schema.
+ * NULLs are ordered before every other value for both directions, and tuples with equal keys keep the order in which
+ * the child produced them.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /** The limit of a sort without a LIMIT clause. */
+  static constexpr size_t NO_LIMIT = std::numeric_limits<size_t>::max();
+
+  /**
+   * Creates a new SortPlanNode.
+   * @param output_schema the output format of this plan node, the same as the child's
+   * @param child the child plan whose tuples are sorted
+   * @param order_bys the sort keys, most significant first, evaluated against the child's output schema
+   * @param limit the maximum number of tuples to produce, or NO_LIMIT
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> &&order_bys, size_t limit = NO_LIMIT)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), limit_(limit) {}
+
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return the child of this sort plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort expected to only have one child.");
+    return GetChildAt(0);
+  }
+
+  /** @return the sort keys, most significant first */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+  /** @return the maximum number of tuples to produce, or NO_LIMIT */
+  size_t GetLimit() const { return limit_; }
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  size_t limit_;
+};
+
+}  // namespace bustub
@@ -32,6 +32,8 @@ enum class LogRecordType {
   ABORT,
   /** Creating a new page in the table heap. */
   NEWPAGE,
+  /** Filling a new page of the table heap with tuples in one go. */
+  BULKINSERT,
 };
 
 /**
@@ -57,6 +59,10 @@ enum class LogRecordType {
  *--------------------------
  * | HEADER | prev_page_id |
  *--------------------------
+ * For bulk insert type log record, which stands in for the insert records of every tuple on a new page
+ *------------------------------------------
+ * | HEADER | page_id | page_data (PAGE_SIZE) |
+ *------------------------------------------
  */
 class LogRecord {
   friend class LogManager;
@@ -109,6 +115,17 @@ class LogRecord {
     size_ = HEADER_SIZE + sizeof(page_id_t);
   }
 
+  // constructor for BULKINSERT type, the page data must stay unchanged until the record is appended
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, page_id_t page_id, const char *page_data)
+      : txn_id_(txn_id),
+        prev_lsn_(prev_lsn),
+        log_record_type_(log_record_type),
+        bulk_page_id_(page_id),
+        bulk_page_data_(page_data) {
+    // calculate log record size
+    size_ = HEADER_SIZE + sizeof(page_id_t) + PAGE_SIZE;
+  }
+
   ~LogRecord() = default;
 
   inline RID &GetDeleteRID() { return delete_rid_; }
@@ -119,6 +136,10 @@ class LogRecord {
 
   inline page_id_t GetNewPageRecord() { return prev_page_id_; }
 
+  inline page_id_t GetBulkInsertPageId() { return bulk_page_id_; }
+
+  inline const char *GetBulkInsertPageData() { return bulk_page_data_; }
+
   inline int32_t GetSize() { return size_; }
 
   inline lsn_t GetLSN() { return lsn_; }
@@ -166,6 +187,10 @@ class LogRecord {
 
   // case4: for new page opeartion
   page_id_t prev_page_id_{INVALID_PAGE_ID};
+
+  // case5: for bulk insert operation, the data points into the latched page
+  page_id_t bulk_page_id_{INVALID_PAGE_ID};
+  const char *bulk_page_data_{nullptr};
   static const int HEADER_SIZE = 20;
 };  // namespace bustub
 
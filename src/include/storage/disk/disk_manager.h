@@ -15,7 +15,9 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
+#include <map>
 #include <string>
+#include <unordered_map>
 
 #include "common/config.h"
 
@@ -30,8 +32,10 @@ class DiskManager {
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param compress_pages whether pages are compressed with PageCodec and stored in slots of their compressed size on
+   * disk; the database file must always be opened with the setting it was created with
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool compress_pages = false);
 
   ~DiskManager() = default;
 
@@ -51,8 +55,9 @@ class DiskManager {
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
+   * @return false if the page is corrupt in a compressed database file, in which case page_data is undefined
    */
-  void ReadPage(page_id_t page_id, char *page_data);
+  bool ReadPage(page_id_t page_id, char *page_data);
 
   /**
    * Append a log entry to the log file.
@@ -77,7 +82,7 @@ class DiskManager {
   page_id_t AllocatePage();
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk. In a compressed database file, the space of the page is reused for other pages.
    * @param page_id id of the page to deallocate
    */
   void DeallocatePage(page_id_t page_id);
@@ -91,6 +96,12 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return the number of bytes of page data written to the database file */
+  size_t GetNumBytesWritten() const;
+
+  /** @return the number of bytes of page data read from the database file */
+  size_t GetNumBytesRead() const;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -101,7 +112,47 @@ class DiskManager {
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
  private:
+  /** The header of a slot of a compressed database file. */
+  struct SlotHeader {
+    /** When the page was written; of two slots of the same page, the one with the larger number is current. */
+    uint64_t sequence_;
+    /** The page stored in the slot, or INVALID_PAGE_ID if the slot is free. */
+    page_id_t page_id_;
+    /** The number of bytes stored after the header; PAGE_SIZE if the page did not compress and is stored as is. */
+    uint32_t stored_size_;
+    /** The size of the whole slot, including the header. */
+    uint32_t slot_size_;
+  };
+
+  /** Where a slot of a compressed database file is. */
+  struct Slot {
+    size_t offset_;
+    uint32_t size_;
+  };
+
+  /** Slots are sized in multiples of this many bytes, so that a page that grows a little keeps its slot. */
+  static constexpr uint32_t SLOT_ALIGNMENT = 512;
+  /** The size of the largest slot, which holds a page that did not compress. */
+  static constexpr uint32_t MAX_SLOT_SIZE =
+      (sizeof(SlotHeader) + PAGE_SIZE + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
   int GetFileSize(const std::string &file_name);
+
+  /** @return the offset of a page in an uncompressed database file */
+  size_t GetPageOffset(page_id_t page_id) const;
+
+  /**
+   * Rebuilds slots_, free_slots_, file_end_ and next_sequence_ by reading the header of every slot of a compressed
+   * database file. Slots with an older copy of a page, or with a copy that was not completely written, are freed.
+   */
+  void ReadSlots();
+
+  /** @return a slot of at least the given size, taken from the free slots or else appended to the file */
+  Slot AllocateSlot(uint32_t size);
+
+  /** Marks a slot as free on disk and makes it available to AllocateSlot(). */
+  void FreeSlot(const Slot &slot);
+
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -111,6 +162,26 @@ class DiskManager {
   std::atomic<page_id_t> next_page_id_;
   int num_flushes_;
   int num_writes_;
+  size_t num_bytes_written_{0};
+  size_t num_bytes_read_{0};
+  /**
+   * A compressed database file is a sequence of slots of variable size, each a SlotHeader followed by a stored page.
+   * Pages are placed anywhere in the file: a page that outgrows its slot moves to a free slot or the end of the file,
+   * and its old slot is freed. Since every slot has a header, the location of every page is found again by reading
+   * the headers when the file is opened. If the old slot of a page was not freed, e.g. because the process stopped
+   * in between, the sequence numbers of the slots tell which copy of the page is current.
+   */
+  bool compress_pages_;
+  /** The slot of every page of a compressed database file. */
+  std::unordered_map<page_id_t, Slot> slots_;
+  /** The offsets of the free slots of a compressed database file, by slot size. */
+  std::multimap<uint32_t, size_t> free_slots_;
+  /** The end of the last slot of a compressed database file. */
+  size_t file_end_{0};
+  /** The sequence number of the next slot write of a compressed database file. */
+  uint64_t next_sequence_{0};
+  /** Whether a corrupt slot header hid the slots after it, so that a page without a slot may have been lost. */
+  bool lost_slots_{false};
   bool flush_log_;
   std::future<void> *flush_log_f_;
 };
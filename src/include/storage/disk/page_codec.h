@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_codec.h
+//
+// Identification: src/include/storage/disk/page_codec.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * PageCodec compresses page images on their way to disk. It works on raw bytes, since the disk manager does not know
+ * what kind of page it is writing, and uses the LZ4 block format: a sequence of literal runs, each followed by a
+ * back-reference of at least MIN_MATCH bytes into the last 64KB of output.
+ *
+ * This suits table pages well even without knowing their schema. The free space in the middle of a page is one long
+ * run of zeroes, integers with narrow ranges repeat their high-order bytes in every tuple, and the minipages of a PAX
+ * page keep the values of a column next to each other.
+ */
+class PageCodec {
+ public:
+  /** The shortest back-reference that the format can express. */
+  static constexpr size_t MIN_MATCH = 4;
+
+  /**
+   * Compress a buffer.
+   * @param src the data to compress
+   * @param src_size the size of the data
+   * @param[out] dst the buffer to write the compressed data into
+   * @param dst_capacity the size of dst
+   * @return the size of the compressed data, or 0 if it does not fit into dst
+   */
+  static size_t Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity);
+
+  /**
+   * Decompress a buffer that was written by Compress().
+   * @param src the compressed data
+   * @param src_size the size of the compressed data
+   * @param[out] dst the buffer to write the original data into
+   * @param dst_size the size of the original data
+   * @return false if the compressed data is corrupt or does not decompress to exactly dst_size bytes
+   */
+  static bool Decompress(const char *src, size_t src_size, char *dst, size_t dst_size);
+
+ private:
+  /** The number of bits of the hash table that finds back-references. */
+  static constexpr uint32_t HASH_BITS = 12;
+  /** The last LAST_LITERALS bytes are always literals, and a match never starts in the last MATCH_LIMIT bytes. */
+  static constexpr size_t LAST_LITERALS = 5;
+  static constexpr size_t MATCH_LIMIT = 12;
+  /** The largest distance that a back-reference can span. */
+  static constexpr size_t MAX_OFFSET = 65535;
+
+  /** @return the hash table slot of the MIN_MATCH bytes at p */
+  static uint32_t Hash(const char *p);
+
+  /** Write a length that did not fit into its 4 bits of the token. Returns false if it does not fit into dst. */
+  static bool WriteLength(size_t length, char *dst, size_t dst_capacity, size_t *pos);
+
+  /** Read a length whose 4 bits in the token were all ones. Returns false if src ends first. */
+  static bool ReadLength(const char *src, size_t src_size, size_t *pos, size_t *length);
+};
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMapPage format:
+ *
+ * Sizes are in bytes.
+ * | PageId (4) | LSN (4) | NextPageId (4) | EntryCount (4) | TablePageId_0 ... TablePageId_n-1 | Category_0 ... |
+ *
+ * Every entry records the free space of one table page as a one-byte category, see FreeSpaceMap. The page ids and the
+ * categories are kept in separate arrays, so that looking for a page with enough space only reads the categories.
+ */
+class FreeSpaceMapPage : public Page {
+ public:
+  /** The number of entries that fit into one page. */
+  static constexpr uint32_t CAPACITY = (PAGE_SIZE - 16) / (sizeof(page_id_t) + sizeof(uint8_t));
+
+  /**
+   * Initializes an empty free space map page.
+   * @param page_id the page id of this page
+   */
+  void Init(page_id_t page_id) {
+    memcpy(GetData() + OFFSET_PAGE_START, &page_id, sizeof(page_id_t));
+    SetLSN(INVALID_LSN);
+    SetNextPageId(INVALID_PAGE_ID);
+    SetEntryCount(0);
+  }
+
+  /** @return the id of the next free space map page, or INVALID_PAGE_ID if this is the last one */
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Sets the id of the next free space map page. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of entries on this page */
+  uint32_t GetEntryCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_ENTRY_COUNT); }
+
+  /** @return the id of the table page of an entry */
+  page_id_t GetTablePageId(uint32_t idx) {
+    return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_TABLE_PAGE_IDS + sizeof(page_id_t) * idx);
+  }
+
+  /** @return the free space category of an entry */
+  uint8_t GetCategory(uint32_t idx) { return *reinterpret_cast<uint8_t *>(GetData() + OFFSET_CATEGORIES + idx); }
+
+  /** Sets the free space category of an entry. */
+  void SetCategory(uint32_t idx, uint8_t category) {
+    *reinterpret_cast<uint8_t *>(GetData() + OFFSET_CATEGORIES + idx) = category;
+  }
+
+  /**
+   * Adds an entry for a table page.
+   * @param table_page_id the id of the table page
+   * @param category the free space category of the table page
+   * @return false if this page is full
+   */
+  bool Append(page_id_t table_page_id, uint8_t category) {
+    uint32_t idx = GetEntryCount();
+    if (idx == CAPACITY) {
+      return false;
+    }
+    memcpy(GetData() + OFFSET_TABLE_PAGE_IDS + sizeof(page_id_t) * idx, &table_page_id, sizeof(page_id_t));
+    SetCategory(idx, category);
+    SetEntryCount(idx + 1);
+    return true;
+  }
+
+  /**
+   * @param min_category the smallest category to look for
+   * @return the index of the first entry with at least that category, or CAPACITY if there is none
+   */
+  uint32_t Find(uint8_t min_category) {
+    auto categories = reinterpret_cast<uint8_t *>(GetData() + OFFSET_CATEGORIES);
+    auto end = categories + GetEntryCount();
+    auto it = std::find_if(categories, end, [min_category](uint8_t category) { return category >= min_category; });
+    return it == end ? CAPACITY : static_cast<uint32_t>(it - categories);
+  }
+
+  /** @return the largest category of the entries on this page, 0 if there are none */
+  uint8_t GetMaxCategory() {
+    auto categories = reinterpret_cast<uint8_t *>(GetData() + OFFSET_CATEGORIES);
+    return GetEntryCount() == 0 ? 0 : *std::max_element(categories, categories + GetEntryCount());
+  }
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_ENTRY_COUNT = 12;
+  static constexpr size_t OFFSET_TABLE_PAGE_IDS = 16;
+  static constexpr size_t OFFSET_CATEGORIES = OFFSET_TABLE_PAGE_IDS + sizeof(page_id_t) * CAPACITY;
+
+  void SetEntryCount(uint32_t entry_count) {
+    memcpy(GetData() + OFFSET_ENTRY_COUNT, &entry_count, sizeof(uint32_t));
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_page.h
+//
+// Identification: src/include/storage/page/pax_table_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "storage/page/table_page.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * PaxLayout describes how the tuples of one schema are spread over the column minipages of a PaxTablePage. It is
+ * computed once per table and handed to every page operation, since the pages themselves do not know their schema.
+ */
+class PaxLayout {
+ public:
+  /**
+   * The number of bytes of VARCHAR data per value that a page reserves room for when its capacity is chosen. Longer
+   * strings simply fill the page up before all of its slots are used.
+   */
+  static constexpr uint32_t VARLEN_RESERVE = 16;
+
+  /**
+   * Computes the layout of the pages of a table.
+   * @param schema the schema of the table
+   */
+  explicit PaxLayout(const Schema &schema);
+
+  /** @return the schema of the table */
+  const Schema &GetSchema() const { return schema_; }
+
+  /** @return the number of slots of every page */
+  uint32_t GetCapacity() const { return capacity_; }
+
+  /** @return the offset of the minipage of a column within the page */
+  uint32_t GetMinipageOffset(uint32_t col_idx) const { return minipage_offsets_[col_idx]; }
+
+  /** @return the offset of the first byte after the minipages, which the VARCHAR data may grow down to */
+  uint32_t GetDataEnd() const { return data_end_; }
+
+  /** @return the size of the largest tuple that fits into an empty page */
+  uint32_t GetMaxTupleSize() const { return schema_.GetLength() + PAGE_SIZE - data_end_; }
+
+ private:
+  Schema schema_;
+  uint32_t capacity_;
+  std::vector<uint32_t> minipage_offsets_;
+  uint32_t data_end_;
+};
+
+/**
+ * PAX (Partition Attributes Across) page format:
+ *  ------------------------------------------------------------------------------------------------
+ *  | HEADER | SLOTS | MINIPAGE 0 | ... | MINIPAGE n-1 | ... FREE SPACE ... | ... VARCHAR DATA ... |
+ *  ------------------------------------------------------------------------------------------------
+ *                                                                          ^
+ *                                                                          free space pointer
+ *
+ * The header and the slot array have the same format as in a TablePage, so the two kinds of pages share everything
+ * that only looks at the page chain or the slots: the page ids, MarkDelete(), RollbackDelete(), GetFirstTupleRid()
+ * and GetNextTupleRid(). The slot array has room for GetCapacity() slots, and a slot holds the size of its tuple and
+ * the offset of the tuple's VARCHAR data.
+ *
+ * Minipage i holds the fixed-length part of column i for every slot back to back, so a scan that only needs a few
+ * columns reads only their minipages instead of every tuple in full. VARCHAR columns store the offset of their data
+ * relative to the start of the tuple, just like a tuple does, and the VARCHAR data of every tuple is kept in one piece
+ * at the end of the page. Reading a whole tuple therefore reassembles it into a copy.
+ */
+class PaxTablePage : public TablePage {
+ public:
+  /**
+   * Insert a tuple into the table.
+   * @param layout the layout of the table
+   * @param tuple tuple to insert
+   * @param[out] rid rid of the inserted tuple
+   * @param txn transaction performing the insert
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return true if the insert is successful (i.e. there is a free slot and enough space)
+   */
+  bool InsertTuple(const PaxLayout &layout, const Tuple &tuple, RID *rid, Transaction *txn,
+                   LockManager *lock_manager, LogManager *log_manager);
+
+  /**
+   * Pack tuples into this new, empty page, writing a single log record for all of them.
+   * @param layout the layout of the table
+   * @param tuples the tuples to insert
+   * @param begin the index of the first tuple to insert; the following ones are inserted until the page is full
+   * @param txn transaction performing the insert
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return the number of tuples that were inserted, which take up the first slots of the page
+   */
+  uint32_t PackTuples(const PaxLayout &layout, const std::vector<Tuple> &tuples, size_t begin, Transaction *txn,
+                      LockManager *lock_manager, LogManager *log_manager);
+
+  /**
+   * Update a tuple.
+   * @param layout the layout of the table
+   * @param new_tuple new value of the tuple
+   * @param[out] old_tuple old value of the tuple
+   * @param rid rid of the tuple
+   * @param txn transaction performing the update
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return true if updating the tuple succeeded
+   */
+  bool UpdateTuple(const PaxLayout &layout, const Tuple &new_tuple, Tuple *old_tuple, const RID &rid,
+                   Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  /**
+   * To be called on commit or abort. Actually perform the delete or rollback an insert.
+   * @param layout the layout of the table
+   * @param rid rid of the tuple to delete
+   * @param txn transaction performing the delete
+   * @param log_manager the log manager
+   * @param[out] deleted_tuple if not nullptr, the tuple that was deleted
+   */
+  void ApplyDelete(const PaxLayout &layout, const RID &rid, Transaction *txn, LogManager *log_manager,
+                   Tuple *deleted_tuple = nullptr);
+
+  /**
+   * Read a tuple from a table, reassembling it from the minipages.
+   * @param layout the layout of the table
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTuple(const PaxLayout &layout, const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
+
+  /**
+   * Copy some columns of the tuples of this page into a batch, one minipage at a time. The other columns of the
+   * appended rows are left unset.
+   * @param layout the layout of the table
+   * @param[in,out] slot the first slot to visit; on return, the slot to resume from
+   * @param column_idxs the columns to copy
+   * @param batch the batch to append to, with the schema of the table
+   * @param limit the number of rows that the batch may hold at most when this returns
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return true if every slot of this page has been visited
+   */
+  bool ScanColumns(const PaxLayout &layout, uint32_t *slot, const std::vector<uint32_t> &column_idxs,
+                   TupleBatch *batch, uint32_t limit, Transaction *txn, LockManager *lock_manager);
+
+  /**
+   * @param layout the layout of the table
+   * @return the size of the largest tuple that can be inserted into this page, 0 if all of its slots are taken
+   */
+  uint32_t GetInsertSpace(const PaxLayout &layout);
+
+ private:
+  friend class PaxLayout;
+
+  /** Copy the tuple of size tuple_size at slot slot_num out of the page into tuple. */
+  void Reassemble(const PaxLayout &layout, uint32_t slot_num, uint32_t tuple_size, Tuple *tuple);
+
+  /** Copy the fixed-length part of a tuple into the minipages at slot slot_num. */
+  void Scatter(const PaxLayout &layout, uint32_t slot_num, const char *tuple_data);
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/lock_manager.h"
@@ -83,6 +84,18 @@ class TablePage : public Page {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
+  /**
+   * Pack tuples into this new, empty page back to back, writing a single log record for all of them.
+   * @param tuples the tuples to insert
+   * @param begin the index of the first tuple to insert; the following ones are inserted until the page is full
+   * @param txn transaction performing the insert
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return the number of tuples that were inserted, which take up the first slots of the page
+   */
+  uint32_t PackTuples(const std::vector<Tuple> &tuples, size_t begin, Transaction *txn, LockManager *lock_manager,
+                      LogManager *log_manager);
+
   /**
    * Mark a tuple as deleted. This does not actually delete the tuple.
    * @param rid rid of the tuple to mark as deleted
@@ -106,8 +119,14 @@ class TablePage : public Page {
   bool UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
                    LockManager *lock_manager, LogManager *log_manager);
 
-  /** To be called on commit or abort. Actually perform the delete or rollback an insert. */
-  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
+  /**
+   * To be called on commit or abort. Actually perform the delete or rollback an insert.
+   * @param rid rid of the tuple to delete
+   * @param txn transaction performing the delete
+   * @param log_manager the log manager
+   * @param[out] deleted_tuple if not nullptr, the tuple that was deleted
+   */
+  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple = nullptr);
 
   /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
   void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
@@ -122,6 +141,17 @@ class TablePage : public Page {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Read a tuple from a table without copying it: the tuple is left pointing into this page, and is only valid while
+   * the page stays latched and pinned.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read, which does not own its data
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTupleView(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -137,7 +167,13 @@ class TablePage : public Page {
    */
   bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
 
- private:
+  /** @return the size of the largest tuple that can be inserted into this page */
+  uint32_t GetInsertSpace() {
+    uint32_t free_space = GetFreeSpaceRemaining();
+    return free_space > SIZE_TUPLE ? free_space - SIZE_TUPLE : 0;
+  }
+
+ protected:
   static_assert(sizeof(page_id_t) == 4);
 
   static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
@@ -198,5 +234,25 @@ class TablePage : public Page {
 
   /** @return tuple size with the deleted flag unset */
   static uint32_t UnsetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size & (~DELETE_MASK)); }
+
+  /**
+   * Looks up a tuple that is about to be read or modified, aborting the transaction if it does not exist.
+   * @param rid rid of the tuple
+   * @param txn transaction performing the access
+   * @return the size of the tuple, or 0 if the slot is invalid or the tuple is deleted
+   */
+  uint32_t GetLiveTupleSize(const RID &rid, Transaction *txn);
+
+  /** Acquires at least a shared lock on a tuple. @return true if the lock is held */
+  static bool LockShared(const RID &rid, Transaction *txn, LockManager *lock_manager);
+
+  /** Acquires an exclusive lock on a tuple, upgrading from a shared lock if necessary. @return true if it is held */
+  static bool LockExclusive(const RID &rid, Transaction *txn, LockManager *lock_manager);
+
+  /** Locks the first tuple_count tuples of a new page and appends one log record for all of them. */
+  void LogPackedTuples(uint32_t tuple_count, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  /** Appends a log record for a change to this page and stamps the page with its LSN. */
+  void AppendLogRecord(LogRecord *log_record, Transaction *txn, LogManager *log_manager);
 };
 }  // namespace bustub
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstring>
+#include <vector>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
@@ -20,14 +23,80 @@ namespace bustub {
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  /**
+   * Initializes an empty tmp tuple page.
+   * @param page_id the page id of this page
+   * @param page_size the size of this page in bytes
+   */
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData() + OFFSET_PAGE_START, &page_id, sizeof(page_id_t));
+    SetLSN(INVALID_LSN);
+    SetFreeSpacePointer(page_size);
+  }
+
+  /** @return the size of the largest tuple that fits on an empty page of the given size */
+  static uint32_t GetMaxTupleSize(uint32_t page_size = PAGE_SIZE) {
+    return page_size - SIZE_TMP_PAGE_HEADER - sizeof(uint32_t);
+  }
+
+  /** @return the page id of this page */
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PAGE_START); }
+
+  /**
+   * Inserts a tuple into this page.
+   * @param tuple the tuple to be inserted
+   * @param[out] out the location of the inserted tuple
+   * @return true if the insert succeeded, false if the page is out of space
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t entry_size = sizeof(uint32_t) + tuple.GetLength();
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_PAGE_HEADER + entry_size) {
+      return false;
+    }
+    free_space_pointer -= entry_size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
+  }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /**
+   * Reads a tuple that was inserted into this page.
+   * @param tmp_tuple the location returned by Insert()
+   * @param[out] tuple the tuple that was stored there
+   */
+  void Get(const TmpTuple &tmp_tuple, Tuple *tuple) { tuple->DeserializeFrom(GetData() + tmp_tuple.GetOffset()); }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /**
+   * Reads every tuple on this page.
+   * @param[out] tuples the tuples on this page are appended here, in insertion order
+   * @param page_size the size of this page in bytes
+   */
+  void GetTuples(std::vector<Tuple> *tuples, uint32_t page_size = PAGE_SIZE) {
+    // Tuples grow down from the end of the page, so walking up from the free space pointer visits the newest first.
+    std::vector<uint32_t> offsets;
+    for (uint32_t offset = GetFreeSpacePointer(); offset < page_size;
+         offset += sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset)) {
+      offsets.push_back(offset);
+    }
+    for (auto it = offsets.rbegin(); it != offsets.rend(); ++it) {
+      tuples->emplace_back();
+      tuples->back().DeserializeFrom(GetData() + *it);
+    }
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+  static constexpr size_t SIZE_TMP_PAGE_HEADER = 12;
+
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap records how much room every page of a table heap has left, so that an insert can go straight to a page
+ * that fits its tuple instead of trying every page of the table in turn.
+ *
+ * The free space of a page is stored as a one-byte category in a chain of FreeSpaceMapPages: a page in category c has
+ * room for a tuple of at least c * CATEGORY_SIZE bytes. Since pages are only ever appended to a table, the last entry
+ * of the map is also the last page of the table. In memory, the map additionally keeps the largest category of every
+ * map page, so that a lookup only fetches a map page that is known to hold a page with enough room.
+ *
+ * The map is a hint and is not logged. A page may have less room than its entry says, in which case the insert
+ * corrects the entry and looks again, or more room, which only means that it is not used until its entry is updated.
+ * Without a free buffer pool frame for a page of the map, an update leaves the entry stale, a new page is only found
+ * by following the chain until its entry is updated again, and a lookup fails, so that the insert walks the chain.
+ * All functions are thread-safe.
+ */
+class FreeSpaceMap {
+ public:
+  /** The number of bytes of free space per category. */
+  static constexpr uint32_t CATEGORY_SIZE = PAGE_SIZE / 256;
+
+  /**
+   * Creates a new, empty free space map. Check IsOpen() to see whether its first page could be created.
+   * @param buffer_pool_manager the buffer pool manager
+   */
+  explicit FreeSpaceMap(BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * Opens an existing free space map. Check IsOpen() to see whether its pages could be read.
+   * @param buffer_pool_manager the buffer pool manager
+   * @param first_page_id the id of the first page of the map
+   */
+  FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id);
+
+  /** @return false if the pages of the map could not be created or read, in which case the map cannot be used */
+  bool IsOpen() const { return !map_page_ids_.empty(); }
+
+  /** @return the id of the first page of the map */
+  page_id_t GetFirstPageId() const { return map_page_ids_.front(); }
+
+  /**
+   * Records the free space of a table page. A page that the map has not seen yet is added as the last page.
+   * @param page_id the id of the table page
+   * @param free_space the size of the largest tuple that fits into the page
+   * @return false if a page of the map could not be fetched or created, in which case the entry is left as it was
+   */
+  bool SetFreeSpace(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Looks for a table page with enough room for a tuple.
+   * @param tuple_size the size of the tuple
+   * @param[out] page_id the id of the first page with enough room, or INVALID_PAGE_ID if there is none
+   * @return false if a page of the map could not be fetched, in which case nothing is known about the table's pages
+   */
+  bool FindPage(uint32_t tuple_size, page_id_t *page_id);
+
+  /** @return the id of the last table page in the map, or INVALID_PAGE_ID if the map is empty */
+  page_id_t GetLastPageId();
+
+ private:
+  /** @return the category of a page with free_space bytes of room */
+  static uint8_t ToCategory(uint32_t free_space) { return std::min<uint32_t>(free_space / CATEGORY_SIZE, 255); }
+
+  /** Fetch a page of the map, or nullptr if there is no free buffer pool frame for it. The caller unpins it. */
+  FreeSpaceMapPage *FetchMapPage(size_t map_page_idx);
+
+  BufferPoolManager *buffer_pool_manager_;
+  /** Protects everything below, and the contents of the map pages. */
+  std::mutex latch_;
+  /** The ids of the pages of the map, in chain order. */
+  std::vector<page_id_t> map_page_ids_;
+  /** The largest category of every page of the map. */
+  std::vector<uint8_t> max_categories_;
+  /** Where the entry of every table page is, as its index over all pages of the map. */
+  std::unordered_map<page_id_t, uint32_t> entries_;
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
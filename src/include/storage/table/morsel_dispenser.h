@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.h
+//
+// Identification: src/include/storage/table/morsel_dispenser.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * MorselDispenser hands out the pages of a table heap to parallel scan workers.
+ *
+ * A morsel is a run of up to SCAN_MORSEL_SIZE consecutive pages of the page chain. Workers repeatedly claim the next
+ * morsel until the chain is exhausted, so fast workers naturally pick up more of the table than slow ones.
+ */
+class MorselDispenser {
+ public:
+  /**
+   * Creates a new morsel dispenser.
+   * @param bpm the buffer pool manager holding the table's pages
+   * @param first_page_id the id of the first page of the table heap
+   * @param morsel_size the maximum number of pages in a morsel
+   */
+  MorselDispenser(BufferPoolManager *bpm, page_id_t first_page_id, uint32_t morsel_size = SCAN_MORSEL_SIZE);
+
+  /**
+   * Claims the next morsel. This function is thread-safe.
+   * @param[out] page_ids the ids of the pages in the claimed morsel, in page chain order
+   * @return true if a morsel was claimed, false if the whole table has already been handed out
+   */
+  bool Next(std::vector<page_id_t> *page_ids);
+
+ private:
+  BufferPoolManager *bpm_;
+  uint32_t morsel_size_;
+  /** Protects next_page_id_. */
+  std::mutex latch_;
+  /** The first page that has not been handed out yet. */
+  page_id_t next_page_id_;
+};
+
+}  // namespace bustub
@@ -12,14 +12,33 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/page/pax_table_page.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
+#include "storage/table/table_view_cursor.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
+/** The format of the pages of a table. */
+enum class TableLayout {
+  /** Slotted pages that store every tuple in one piece, see TablePage. */
+  ROW,
+  /** Pages that store every column of their tuples in a minipage of its own, see PaxTablePage. */
+  PAX
+};
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
@@ -27,6 +46,8 @@ namespace bustub {
 class TableHeap {
   friend class TableIterator;
 
+  friend class TableViewCursor;
+
  public:
   ~TableHeap() = default;
 
@@ -36,9 +57,14 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param layout the format of the pages of the table
+   * @param schema the schema of the table, required for the PAX layout
+   * @param free_space_map_page_id the id of the first page of the free space map of the table. Without one, inserts
+   * look for room page by page.
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, TableLayout layout = TableLayout::ROW, const Schema *schema = nullptr,
+            page_id_t free_space_map_page_id = INVALID_PAGE_ID);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,9 +72,12 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param layout the format of the pages of the table
+   * @param schema the schema of the table, required for the PAX layout. Tables created with a schema keep a zone map.
+   * Every created table keeps a free space map.
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, TableLayout layout = TableLayout::ROW, const Schema *schema = nullptr);
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
@@ -59,6 +88,45 @@ class TableHeap {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn);
 
+  /**
+   * Insert many tuples at once. The tuples are packed back to back into new pages, which are linked to the end of the
+   * table in one go, with one log record and one write record per page instead of one per tuple. If a tuple is too
+   * large, nothing is inserted.
+   * @param tuples the tuples to insert
+   * @param[out] rids the rids of the inserted tuples are appended here, in the order of the tuples
+   * @param txn the transaction performing the insert
+   * @return true iff the insert is successful
+   */
+  bool BulkInsert(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn);
+
+  /**
+   * Called on abort to rollback a bulk insert into one page.
+   * @param rid the page id of the page and, as the slot number, the number of tuples that were packed into it
+   * @param txn transaction performing the rollback
+   */
+  void RollbackBulkInsert(const RID &rid, Transaction *txn);
+
+  /**
+   * Switch between inserting into shared pages and into private insert pages. With private insert pages, every
+   * transaction that inserts into this table is handed a page of its own, which is linked to the end of the table under
+   * a short latch of the last page, and is the only one to insert there until the page is full or the transaction
+   * ends. Concurrent inserts then no longer wait for each other's page latches, at the cost of one partially filled
+   * page per transaction, whose room goes back to the free space map in ReleaseInsertPage(). Requires a free space map,
+   * and should be set before inserts run.
+   * @param enabled true to give every transaction a private insert page
+   */
+  void SetPrivateInsertPages(bool enabled) {
+    BUSTUB_ASSERT(!enabled || free_space_map_ != nullptr, "Private insert pages need a free space map.");
+    private_insert_pages_ = enabled;
+  }
+
+  /**
+   * Give up the private insert page of a transaction, if it has one, so that other inserts may use its remaining room.
+   * Called when the transaction commits or aborts.
+   * @param txn the transaction
+   */
+  void ReleaseInsertPage(Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -99,6 +167,51 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Read every tuple stored on one page of the table.
+   * @param page_id id of the page to read, must belong to this table
+   * @param[out] tuples the tuples on the page are appended here in slot order
+   * @param txn transaction performing the read
+   */
+  void GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn);
+
+  /**
+   * Read the tuples with the given RIDs, fetching and latching every page only once.
+   * @param rids the RIDs of the tuples to read, sorted so that the RIDs of a page are next to each other
+   * @param[out] tuples the tuples that could be read are appended here in RID order
+   * @param txn transaction performing the read
+   */
+  void GetTuples(const std::vector<RID> &rids, std::vector<Tuple> *tuples, Transaction *txn);
+
+  /**
+   * Visit the tuples of one page in place while the page is latched, so that a scan can filter and project tuples
+   * without copying every tuple out of the page first.
+   * @param page_id id of the page to scan, must belong to this table
+   * @param[in,out] slot the first slot to visit; on return, the slot to resume the scan of this page from
+   * @param visitor called with every tuple in slot order. The tuple points into the page, or is reassembled from a PAX
+   * page, and is only valid during the call. Returning false stops the scan after that tuple.
+   * @param[out] next_page_id the id of the page after this one, set if the scan reached the end of the page
+   * @param txn transaction performing the read
+   * @return true if the scan reached the end of the page
+   */
+  bool ScanPage(page_id_t page_id, uint32_t *slot, const std::function<bool(const Tuple &)> &visitor,
+                page_id_t *next_page_id, Transaction *txn);
+
+  /**
+   * Copy some columns of the tuples of one page into a batch, column by column, while the page is latched. Only the
+   * minipages of those columns are read, and the other columns of the appended rows are left unset. PAX tables only.
+   * @param page_id id of the page to scan, must belong to this table
+   * @param[in,out] slot the first slot to visit; on return, the slot to resume the scan of this page from
+   * @param column_idxs the columns to copy
+   * @param batch the batch to append to, with the schema of this table
+   * @param limit the number of rows that the batch may hold at most when this returns
+   * @param[out] next_page_id the id of the page after this one, set if the scan reached the end of the page
+   * @param txn transaction performing the read
+   * @return true if the scan reached the end of the page
+   */
+  bool ScanColumns(page_id_t page_id, uint32_t *slot, const std::vector<uint32_t> &column_idxs, TupleBatch *batch,
+                   uint32_t limit, page_id_t *next_page_id, Transaction *txn);
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -108,11 +221,98 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the id of the first page of the free space map of this table, INVALID_PAGE_ID if it keeps none */
+  inline page_id_t GetFreeSpaceMapPageId() const {
+    return free_space_map_ == nullptr ? INVALID_PAGE_ID : free_space_map_->GetFirstPageId();
+  }
+
+  /** @return the format of the pages of this table */
+  inline TableLayout GetLayout() const { return layout_; }
+
+  /**
+   * Look up the zone of a column of a page, so that a scan can rule out the page without fetching it.
+   * @param page_id id of the page, must belong to this table
+   * @param col_idx the index of the column
+   * @param[out] zone the zone of the column on the page
+   * @param[out] next_page_id the id of the page after this one
+   * @return false if the table keeps no zone map, i.e. it was not created with a schema
+   */
+  inline bool GetZone(page_id_t page_id, uint32_t col_idx, ColumnZone *zone, page_id_t *next_page_id) const {
+    return zone_map_ != nullptr && zone_map_->GetZone(page_id, col_idx, zone, next_page_id);
+  }
+
  private:
+  /**
+   * Read a tuple from a latched page of this table.
+   * @param page the page, which holds the tuple
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read
+   * @param copy whether the tuple must own its data. Otherwise tuples in row pages are only pointed at, while tuples
+   * in PAX pages are always reassembled into a copy.
+   * @param txn transaction performing the read
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTupleFromPage(TablePage *page, const RID &rid, Tuple *tuple, bool copy, Transaction *txn);
+
+  /** Insert a tuple into a write-latched page of this table. Returns false if it does not fit. */
+  bool InsertIntoPage(TablePage *page, const Tuple &tuple, RID *rid, Transaction *txn);
+
+  /** Insert a tuple into the private insert page of a transaction, or into a new one if it has none or it is full. */
+  bool InsertIntoPrivatePage(const Tuple &tuple, RID *rid, Transaction *txn);
+
+  /** @return the size of the largest tuple that fits into a page of this table */
+  uint32_t GetMaxTupleSize() const {
+    return pax_layout_ == nullptr ? PAGE_SIZE - 32 : pax_layout_->GetMaxTupleSize();
+  }
+
+  /** @return the last page of this table, pinned and write-latched, or nullptr if it could not be fetched */
+  TablePage *FetchLastPage();
+
+  /**
+   * Link a new page to the end of this table.
+   * @param txn the transaction that links the page
+   * @param is_private whether the page becomes the private insert page of txn, which nobody else inserts into and
+   * which the free space map sees as full until it is released
+   * @return the new page, pinned and write-latched, or nullptr if no page could be created
+   */
+  TablePage *AppendPage(Transaction *txn, bool is_private);
+
+  /** @return true if the page is the private insert page of some transaction */
+  bool IsPrivateInsertPage(page_id_t page_id);
+
+  /** Records the free space of a latched page in the free space map, unless the page is a private insert page. */
+  void UpdateFreeSpace(TablePage *page);
+
+  /** @return the size of the largest tuple that can be inserted into a latched page of this table */
+  uint32_t GetInsertSpace(TablePage *page);
+
+  /**
+   * Asks the free space map which page of this table an insert should try first.
+   * @param tuple_size the size of the tuple to insert
+   * @param[out] page_id the page to try first, or INVALID_PAGE_ID if the insert should go to a new page at the end of
+   * the table
+   * @return false if the free space map could not be read, in which case the insert should walk the table instead
+   */
+  bool FindInsertPage(uint32_t tuple_size, page_id_t *page_id);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  TableLayout layout_;
+  /** The layout of the pages of a PAX table, nullptr for row tables. */
+  std::unique_ptr<PaxLayout> pax_layout_;
+  /** The zones of every page, kept up to date under the page latches. nullptr if the table keeps no zone map. */
+  std::unique_ptr<ZoneMap> zone_map_;
+  /** The free space of every page, kept up to date under the page latches. nullptr if the table keeps none. */
+  std::unique_ptr<FreeSpaceMap> free_space_map_;
+  bool private_insert_pages_{false};
+  /** Protects insert_pages_ and private_page_ids_. */
+  std::mutex insert_pages_latch_;
+  /** The private insert page of every transaction that has one. */
+  std::unordered_map<txn_id_t, page_id_t> insert_pages_;
+  /** The pages in insert_pages_, which shared inserts and free space updates stay away from. */
+  std::unordered_set<page_id_t> private_page_ids_;
 };
 
 }  // namespace bustub
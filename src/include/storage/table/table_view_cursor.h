@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_view_cursor.h
+//
+// Identification: src/include/storage/table/table_view_cursor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "concurrency/transaction.h"
+#include "storage/page/table_page.h"
+#include "storage/table/tuple_view.h"
+
+namespace bustub {
+
+class TableHeap;
+
+/**
+ * TableViewCursor scans a TableHeap in place: unlike TableIterator, it produces views of the tuples in their pages
+ * instead of copies. Tuples of PAX tables are not stored in one piece, so for them the view is of a reassembled copy.
+ *
+ * The page of the last view stays pinned and read-latched until the cursor moves on to the next page or is destroyed,
+ * so a view is valid until the view after it is produced. The consumer must therefore not write to the table that is
+ * being scanned.
+ */
+class TableViewCursor {
+ public:
+  /**
+   * Creates a cursor positioned before the first tuple of a table.
+   * @param table_heap the table to scan
+   * @param txn the transaction performing the scan
+   */
+  TableViewCursor(TableHeap *table_heap, Transaction *txn);
+
+  ~TableViewCursor() { Release(); }
+
+  TableViewCursor(const TableViewCursor &) = delete;
+  TableViewCursor &operator=(const TableViewCursor &) = delete;
+
+  /**
+   * Advances to the next tuple of the table.
+   * @param[out] view a view of the tuple in its page
+   * @return false if every tuple has been produced
+   */
+  bool Next(TupleView *view);
+
+ private:
+  /** Unlatches and unpins the page that the cursor is on, if any. */
+  void Release();
+
+  TableHeap *table_heap_;
+  Transaction *txn_;
+  /** The page that the cursor is on, or INVALID_PAGE_ID once the table is exhausted. */
+  page_id_t page_id_;
+  /** The page_id_ page if it is pinned and latched, nullptr otherwise. */
+  TablePage *page_{nullptr};
+  /** The next slot of the page to visit. */
+  uint32_t slot_{0};
+  /** The last tuple produced, which points into the page, or is a copy of a tuple in a PAX page. */
+  Tuple tuple_;
+};
+
+}  // namespace bustub
@@ -4,8 +4,10 @@
 
 namespace bustub {
 
-// Document this class! What does it represent?
-
+/**
+ * TmpTuple is the location of a tuple that was stored in a TmpTuplePage: the page id of that page, and the offset of
+ * the tuple's size-prefixed data within the page.
+ */
 class TmpTuple {
  public:
   TmpTuple(page_id_t page_id, size_t offset) : page_id_(page_id), offset_(offset) {}
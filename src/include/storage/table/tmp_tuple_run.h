@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.h
+//
+// Identification: src/include/storage/table/tmp_tuple_run.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleRun is an append-only sequence of tuples that executors spill through the buffer pool when their working
+ * set exceeds the memory budget. The tuples are stored in a chain of TmpTuplePages that is deleted with the run.
+ */
+class TmpTupleRun {
+ public:
+  /**
+   * Creates a new, empty run.
+   * @param bpm the buffer pool manager that the pages of this run are allocated from
+   */
+  explicit TmpTupleRun(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleRun);
+
+  ~TmpTupleRun() { Clear(); }
+
+  /**
+   * Appends a tuple to the end of this run.
+   * @param tuple the tuple to be appended
+   * @return false if the tuple does not fit on a page (see Fits()) or the buffer pool has no free frame
+   */
+  bool Append(const Tuple &tuple);
+
+  /** @return true if the tuple fits on a page of a run; a tuple that does not can never be appended */
+  static bool Fits(const Tuple &tuple);
+
+  /** @return the number of tuples in this run */
+  size_t GetTupleCount() const { return tuple_count_; }
+
+  /** @return the number of pages in this run */
+  size_t GetPageCount() const { return page_ids_.size(); }
+
+  /**
+   * Reads the tuples stored on one page of this run.
+   * @param page_idx the index of the page within this run
+   * @param[out] tuples the tuples of the page are appended here, in the order they were appended to the run
+   */
+  void ReadPage(size_t page_idx, std::vector<Tuple> *tuples);
+
+  /** Deletes every page of this run, leaving it empty. */
+  void Clear();
+
+ private:
+  BufferPoolManager *bpm_;
+  std::vector<page_id_t> page_ids_;
+  size_t tuple_count_{0};
+};
+
+}  // namespace bustub
@@ -30,10 +30,14 @@ namespace bustub {
 class Tuple {
   friend class TablePage;
 
+  friend class PaxTablePage;
+
   friend class TableHeap;
 
   friend class TableIterator;
 
+  friend class TupleView;
+
  public:
   // Default constructor (to create a dummy tuple)
   Tuple() = default;
@@ -41,8 +45,10 @@ class Tuple {
   // constructor for table heap tuple
   explicit Tuple(RID rid) : rid_(rid) {}
 
-  // constructor for creating a new tuple based on input value
-  Tuple(std::vector<Value> values, const Schema *schema);
+  // constructor for creating a new tuple based on input value. If a pool is
+  // given, the tuple data is allocated from it rather than owned by the tuple,
+  // so copies of the tuple are shallow and none of them may outlive the pool.
+  Tuple(std::vector<Value> values, const Schema *schema, AbstractPool *pool = nullptr);
 
   // copy constructor, deep copy
   Tuple(const Tuple &other);
@@ -63,9 +69,16 @@ class Tuple {
   // deserialize tuple data(deep copy)
   void DeserializeFrom(const char *storage);
 
+  // make the tuple own its data, copying it out of the pool it was allocated
+  // from if there is one, so that the tuple may outlive the pool
+  void MakeOwned();
+
   // return RID of current tuple
   inline RID GetRid() const { return rid_; }
 
+  // set RID
+  inline void SetRid(const RID &rid) { rid_ = rid; }
+
   // Get the address of this tuple in the table's backing store
   inline char *GetData() const { return data_; }
 
@@ -81,7 +94,16 @@ class Tuple {
     Value value = GetValue(schema, column_idx);
     return value.IsNull();
   }
-  inline bool IsAllocated() { return allocated_; }
+  inline bool IsAllocated() const { return allocated_; }
+
+  /**
+   * Generates the index key of this tuple.
+   * @param schema the schema of this tuple
+   * @param key_schema the schema of the index key
+   * @param key_attrs the indexes of the columns of this tuple that make up the key, in key schema order
+   * @return a tuple of the key schema holding this tuple's key values
+   */
+  Tuple KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const;
 
   std::string ToString(const Schema *schema) const;
 
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/storage/table/tuple_batch.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ColumnVector holds the values of one column for every row of a TupleBatch.
+ *
+ * Fixed-width values are stored back to back in their serialized form, so e.g. an INTEGER column is a plain int32_t
+ * array that can be read with GetData<int32_t>(). Variable-length values are kept as Values that own their data.
+ */
+class ColumnVector {
+ public:
+  /**
+   * Creates a new column vector.
+   * @param type_id the type of the values in this column
+   * @param capacity the maximum number of values this column can hold
+   */
+  ColumnVector(TypeId type_id, uint32_t capacity);
+
+  /** @return the type of the values in this column */
+  TypeId GetTypeId() const { return type_id_; }
+
+  /** @return true if the values of this column are stored inline as raw fixed-width data */
+  bool IsInlined() const { return type_id_ != TypeId::VARCHAR; }
+
+  /** @return the width in bytes of one inlined value, 0 for variable-length columns */
+  uint32_t GetWidth() const { return width_; }
+
+  /** @return the raw fixed-width values of this column */
+  template <typename T>
+  const T *GetData() const {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  /** @return the raw fixed-width values of this column */
+  template <typename T>
+  T *GetData() {
+    return reinterpret_cast<T *>(data_.data());
+  }
+
+  /** @return the value at index idx */
+  Value GetValue(uint32_t idx) const;
+
+  /** Sets the value at index idx, casting it to the type of this column if necessary. */
+  void SetValue(uint32_t idx, const Value &val);
+
+  /** Sets the inlined value at index idx by copying GetWidth() serialized bytes from src. */
+  void SetRaw(uint32_t idx, const char *src) { memcpy(data_.data() + idx * width_, src, width_); }
+
+ private:
+  TypeId type_id_;
+  uint32_t width_;
+  /** Serialized fixed-width values, empty for variable-length columns. */
+  std::vector<char> data_;
+  /** Variable-length values, empty for fixed-width columns. */
+  std::vector<Value> varlen_;
+};
+
+/**
+ * TupleBatch holds up to GetCapacity() rows in columnar form, one ColumnVector per column of its schema.
+ * Batches are produced by AbstractExecutor::NextBatch() and are meant to be reused across calls.
+ */
+class TupleBatch {
+ public:
+  /**
+   * Creates a new, empty tuple batch.
+   * @param schema the schema of the rows in this batch
+   * @param capacity the maximum number of rows in this batch
+   */
+  explicit TupleBatch(const Schema *schema, uint32_t capacity = TUPLE_BATCH_SIZE);
+
+  /** @return the schema of the rows in this batch */
+  const Schema *GetSchema() const { return schema_; }
+
+  /** @return the number of rows in this batch */
+  uint32_t GetSize() const { return size_; }
+
+  /** @return the maximum number of rows in this batch */
+  uint32_t GetCapacity() const { return capacity_; }
+
+  /** @return true if this batch holds no rows */
+  bool IsEmpty() const { return size_ == 0; }
+
+  /** @return true if no more rows can be appended to this batch */
+  bool IsFull() const { return size_ == capacity_; }
+
+  /** Removes all rows from this batch. */
+  void Reset() { size_ = 0; }
+
+  /** @return the column at index col_idx */
+  const ColumnVector &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /** @return the column at index col_idx */
+  ColumnVector &GetColumn(uint32_t col_idx) { return columns_[col_idx]; }
+
+  /** @return the value at the given row and column */
+  Value GetValue(uint32_t row_idx, uint32_t col_idx) const { return columns_[col_idx].GetValue(row_idx); }
+
+  /** @return the RID of the given row, invalid if the row did not come from a table */
+  RID GetRid(uint32_t row_idx) const { return rids_[row_idx]; }
+
+  /**
+   * Appends a tuple to this batch. The tuple must be laid out according to the schema of this batch.
+   * @param tuple the tuple to be appended
+   */
+  void AppendTuple(const Tuple &tuple);
+
+  /**
+   * Appends a row of values to this batch.
+   * @param values one value for each column of the schema of this batch
+   * @param rid the RID of the row, if any
+   */
+  void AppendValues(const std::vector<Value> &values, RID rid = RID{});
+
+  /**
+   * Appends a row of another batch with the same schema to this batch.
+   * @param other the batch to copy the row from
+   * @param row_idx index of the row within other
+   */
+  void AppendRow(const TupleBatch &other, uint32_t row_idx);
+
+  /**
+   * Appends rows whose values are left unset, to be filled in column by column, e.g. with ColumnVector::SetRaw().
+   * @param rids the RIDs of the new rows
+   */
+  void AppendRows(const std::vector<RID> &rids);
+
+  /** @return the values of the given row */
+  std::vector<Value> GetValues(uint32_t row_idx) const;
+
+  /**
+   * @return the given row materialized as a tuple with the schema of this batch, whose data is allocated from the
+   * given pool if there is one
+   */
+  Tuple GetTuple(uint32_t row_idx, AbstractPool *pool = nullptr) const {
+    return Tuple(GetValues(row_idx), schema_, pool);
+  }
+
+ private:
+  const Schema *schema_;
+  uint32_t capacity_;
+  uint32_t size_{0};
+  std::vector<ColumnVector> columns_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.h
+//
+// Identification: src/include/storage/table/tuple_view.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleView is a non-owning reference to the bytes of a tuple, in the same format as Tuple. A view is usually into a
+ * table page that a scan keeps pinned, so reading its values costs no allocation or copy of the tuple. Whoever hands
+ * out a view decides how long the bytes stay valid; call ToTuple() to keep a tuple beyond that.
+ */
+class TupleView {
+ public:
+  /** Creates an empty view. */
+  TupleView() = default;
+
+  /**
+   * Creates a view of tuple bytes.
+   * @param data the tuple bytes
+   * @param size the length of the tuple in bytes
+   * @param rid the RID of the tuple, if it is stored in a table
+   */
+  TupleView(const char *data, uint32_t size, RID rid) : data_(data), size_(size), rid_(rid) {}
+
+  /** Creates a view of the bytes of a tuple, valid as long as the tuple is neither modified nor destroyed. */
+  explicit TupleView(const Tuple &tuple) : TupleView(tuple.GetData(), tuple.GetLength(), tuple.GetRid()) {}
+
+  /** @return the RID of the tuple */
+  RID GetRid() const { return rid_; }
+
+  /** @return the tuple bytes */
+  const char *GetData() const { return data_; }
+
+  /** @return the length of the tuple in bytes */
+  uint32_t GetLength() const { return size_; }
+
+  /** @return the value of a column, read straight from the tuple bytes */
+  Value GetValue(const Schema *schema, uint32_t column_idx) const {
+    assert(data_ != nullptr);
+    const auto &col = schema->GetColumn(column_idx);
+    const char *data_ptr = data_ + col.GetOffset();
+    if (!col.IsInlined()) {
+      // VARCHAR data is stored at a relative offset from the start of the tuple.
+      data_ptr = data_ + *reinterpret_cast<const int32_t *>(data_ptr);
+    }
+    return Value::DeserializeFrom(data_ptr, col.GetType());
+  }
+
+  /**
+   * @return a tuple that shares the bytes of this view, e.g. to evaluate expressions on it. Copies of the returned
+   * tuple share the bytes as well, so none of them may outlive the view.
+   */
+  Tuple AsTuple() const {
+    Tuple tuple(rid_);
+    tuple.data_ = const_cast<char *>(data_);
+    tuple.size_ = size_;
+    return tuple;
+  }
+
+  /** @return a tuple that owns a copy of the bytes of this view */
+  Tuple ToTuple() const {
+    Tuple tuple(rid_);
+    tuple.allocated_ = true;
+    tuple.size_ = size_;
+    tuple.data_ = new char[size_];
+    std::memcpy(tuple.data_, data_, size_);
+    return tuple;
+  }
+
+ private:
+  const char *data_{nullptr};
+  uint32_t size_{0};
+  RID rid_{};
+};
+
+}  // namespace bustub
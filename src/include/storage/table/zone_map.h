@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ColumnZone summarizes the values of one column of the tuples on one page.
+ */
+struct ColumnZone {
+  /** The smallest and largest non-NULL value, both NULL if there is none. */
+  Value min_;
+  Value max_;
+  /** The number of NULL values. */
+  uint32_t null_count_{0};
+  /** The number of tuples on the page. */
+  uint32_t tuple_count_{0};
+};
+
+/**
+ * ZoneMap keeps a ColumnZone for every column of every page of a table heap, so that a scan can rule out whole pages
+ * from the zones alone, without fetching them. It also remembers the page chain for that reason.
+ *
+ * Zones are conservative: the bounds of a column only ever widen while its page holds tuples, so deleting the
+ * smallest or largest value of a page leaves its zone wider than necessary until the page is emptied. A zone therefore
+ * never excludes a value that is on its page.
+ *
+ * The zone map lives in memory only, so it has to see every change to its table from the moment the table is created.
+ * All functions are thread-safe.
+ */
+class ZoneMap {
+ public:
+  /**
+   * Creates a new zone map for an empty table.
+   * @param schema the schema of the table
+   */
+  explicit ZoneMap(const Schema &schema);
+
+  /**
+   * Starts tracking a new, empty page, or links a page that is already tracked into the chain.
+   * @param page_id the id of the new page
+   * @param prev_page_id the id of the page that the new page is linked after, or INVALID_PAGE_ID for the first page
+   * and for pages that are not linked yet
+   */
+  void AddPage(page_id_t page_id, page_id_t prev_page_id);
+
+  /** Adds the values of a tuple that was inserted into a page to the zones of the page. */
+  void Insert(page_id_t page_id, const Tuple &tuple);
+
+  /** Removes a tuple that was deleted from a page from the zones of the page. */
+  void Delete(page_id_t page_id, const Tuple &tuple);
+
+  /**
+   * Looks up the zone of a column of a page.
+   * @param page_id the id of the page
+   * @param col_idx the index of the column
+   * @param[out] zone the zone of the column on the page
+   * @param[out] next_page_id the id of the page after this one
+   * @return false if the page is not tracked by this zone map
+   */
+  bool GetZone(page_id_t page_id, uint32_t col_idx, ColumnZone *zone, page_id_t *next_page_id) const;
+
+ private:
+  /** The zones of one page. */
+  struct PageZones {
+    page_id_t next_page_id_{INVALID_PAGE_ID};
+    std::vector<ColumnZone> columns_;
+  };
+
+  Schema schema_;
+  /** Protects zones_. */
+  mutable std::mutex latch_;
+  std::unordered_map<page_id_t, PageZones> zones_;
+};
+
+}  // namespace bustub
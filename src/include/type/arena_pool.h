@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.h
+//
+// Identification: src/include/type/arena_pool.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "type/abstract_pool.h"
+
+namespace bustub {
+
+/**
+ * ArenaPool is a memory pool that hands out memory from large chunks by bumping a pointer. Individual allocations are
+ * never returned to the pool: Free() does nothing, and all memory is released at once by Reset() or when the pool is
+ * destroyed. This makes allocation a few instructions, and freeing many small objects with the same lifetime free.
+ *
+ * An ArenaPool is not thread-safe. Threads that allocate concurrently should each use their own pool.
+ */
+class ArenaPool : public AbstractPool {
+ public:
+  /**
+   * Creates a new arena pool.
+   * @param chunk_size the size of the chunks that small allocations are carved from
+   */
+  explicit ArenaPool(size_t chunk_size = ARENA_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  DISALLOW_COPY_AND_MOVE(ArenaPool);
+
+  ~ArenaPool() override = default;
+
+  /**
+   * Allocates memory that stays valid until the pool is reset or destroyed.
+   * @param size the number of bytes to allocate
+   * @return memory aligned for any fundamental type
+   */
+  void *Allocate(size_t size) override;
+
+  /** Does nothing, memory is only released by Reset() or the destructor. */
+  void Free(void *ptr) override {}
+
+  /** Releases all memory allocated from the pool, keeping one chunk to allocate from again. */
+  void Reset();
+
+  /** @return the number of bytes allocated from the pool since it was created or last reset */
+  size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+ private:
+  /** @return a new chunk of the given size, which is added to chunks_ */
+  char *NewChunk(size_t size);
+
+  /** The size of regular chunks. */
+  size_t chunk_size_;
+  /** Every chunk of the pool. Allocations that do not fit into a regular chunk get a chunk of their own. */
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  /** The regular chunk that small allocations are currently carved from. */
+  char *current_chunk_{nullptr};
+  /** The next free byte of the current chunk. */
+  char *cursor_{nullptr};
+  /** The end of the current chunk. */
+  char *end_{nullptr};
+  size_t allocated_bytes_{0};
+};
+
+}  // namespace bustub
@@ -16,6 +16,7 @@
 #include <string>
 #include <utility>
 
+#include "type/abstract_pool.h"
 #include "type/limits.h"
 #include "type/type.h"
 
@@ -41,7 +42,9 @@ class Value {
   friend class VarlenType;
 
  public:
-  explicit Value(const TypeId type) : manage_data_(false), type_id_(type) { size_.len_ = BUSTUB_VALUE_NULL; }
+  explicit Value(const TypeId type) : storage_(VarlenStorage::Borrowed), type_id_(type) {
+    size_.len_ = BUSTUB_VALUE_NULL;
+  }
   // BOOLEAN and TINYINT
   Value(TypeId type, int8_t i);
   // DECIMAL
@@ -60,14 +63,41 @@ class Value {
   Value(TypeId type, const std::string &data);
 
   Value() : Value(TypeId::INVALID) {}
-  Value(const Value &other);
-  Value &operator=(Value other);
-  ~Value();
+  // Copies never share owned data, but short strings are copied inline
+  Value(const Value &other)
+      : value_(other.value_), size_(other.size_), storage_(other.storage_), type_id_(other.type_id_) {
+    if (storage_ == VarlenStorage::Owned) {
+      CopyVarlen(other.value_.varlen_, size_.len_);
+    }
+  }
+  // Moves never allocate, the moved-from value is left NULL if it owned data
+  Value(Value &&other) noexcept
+      : value_(other.value_), size_(other.size_), storage_(other.storage_), type_id_(other.type_id_) {
+    if (other.storage_ == VarlenStorage::Owned) {
+      other.value_.varlen_ = nullptr;
+      other.size_.len_ = BUSTUB_VALUE_NULL;
+      other.storage_ = VarlenStorage::Borrowed;
+    }
+  }
+  Value &operator=(const Value &other) {
+    Value copy(other);
+    Swap(*this, copy);
+    return *this;
+  }
+  Value &operator=(Value &&other) noexcept {
+    Swap(*this, other);
+    return *this;
+  }
+  ~Value() {
+    if (storage_ == VarlenStorage::Owned) {
+      delete[] value_.varlen_;
+    }
+  }
   // NOLINTNEXTLINE
-  friend void Swap(Value &first, Value &second) {
+  friend void Swap(Value &first, Value &second) noexcept {
     std::swap(first.value_, second.value_);
     std::swap(first.size_, second.size_);
-    std::swap(first.manage_data_, second.manage_data_);
+    std::swap(first.storage_, second.storage_);
     std::swap(first.type_id_, second.type_id_);
   }
   // check whether value is integer
@@ -132,12 +162,49 @@ class Value {
     return Type::GetInstance(type_id)->DeserializeFrom(storage);
   }
 
+  // Deserialize a value of the given type, copying variable-length data into
+  // the given pool instead of a buffer owned by the value. The value must not
+  // outlive the pool.
+  inline static Value DeserializeFrom(const char *storage, const TypeId type_id, AbstractPool *pool) {
+    if (type_id != TypeId::VARCHAR || pool == nullptr) {
+      return DeserializeFrom(storage, type_id);
+    }
+    uint32_t len = *reinterpret_cast<const uint32_t *>(storage);
+    if (len == BUSTUB_VALUE_NULL) {
+      return Value(type_id, nullptr, len, false);
+    }
+    auto data = static_cast<char *>(pool->Allocate(len));
+    memcpy(data, storage + sizeof(uint32_t), len);
+    return Value(type_id, data, len, false);
+  }
+
   // Return a string version of this value
   inline std::string ToString() const { return Type::GetInstance(type_id_)->ToString(*this); }
   // Create a copy of this value
   inline Value Copy() const { return Type::GetInstance(type_id_)->Copy(*this); }
 
  protected:
+  // The number of bytes of VARCHAR data that are stored inside the value
+  static constexpr uint32_t VARLEN_INLINE_SIZE = 8;
+
+  // Where the data of a VARCHAR value is stored
+  enum class VarlenStorage : uint8_t {
+    // Someone else's buffer, e.g. a tuple or a memory pool
+    Borrowed,
+    // A buffer allocated and freed by the value
+    Owned,
+    // The value itself, for data of up to VARLEN_INLINE_SIZE bytes
+    Inline
+  };
+
+  // Copies VARCHAR data into the value, inline if it is short enough
+  void CopyVarlen(const char *data, uint32_t len);
+
+  // The VARCHAR data, wherever it is stored
+  inline const char *VarlenData() const {
+    return storage_ == VarlenStorage::Inline ? value_.inline_ : value_.const_varlen_;
+  }
+
   // The actual value item
   union Val {
     int8_t boolean_;
@@ -149,6 +216,7 @@ class Value {
     uint64_t timestamp_;
     char *varlen_;
     const char *const_varlen_;
+    char inline_[VARLEN_INLINE_SIZE];
   } value_;
 
   union {
@@ -156,7 +224,7 @@ class Value {
     TypeId elem_type_id_;
   } size_;
 
-  bool manage_data_;
+  VarlenStorage storage_;
   // The data type
   TypeId type_id_;
 };
@@ -34,8 +34,15 @@ namespace bustub {
 
 class ValueFactory {
  public:
-  static inline Value Clone(const Value &src, __attribute__((__unused__)) AbstractPool *dataPool = nullptr) {
-    return src.Copy();
+  /**
+   * Copies a value. If a pool is given, the variable-length data of the copy is allocated from the pool, and the copy
+   * must not outlive the pool.
+   */
+  static inline Value Clone(const Value &src, AbstractPool *dataPool = nullptr) {
+    if (dataPool == nullptr || src.GetTypeId() != TypeId::VARCHAR || src.IsNull()) {
+      return src.Copy();
+    }
+    return GetVarcharValue(src.GetData(), src.GetLength(), false, dataPool);
   }
 
   static inline Value GetTinyIntValue(int8_t value) { return Value(TypeId::TINYINT, value); }
@@ -58,20 +65,30 @@ class ValueFactory {
 
   static inline Value GetBooleanValue(int8_t value) { return Value(TypeId::BOOLEAN, value); }
 
-  static inline Value GetVarcharValue(const char *value, bool manage_data,
-                                      __attribute__((__unused__)) AbstractPool *pool = nullptr) {
+  static inline Value GetVarcharValue(const char *value, bool manage_data, AbstractPool *pool = nullptr) {
     auto len = static_cast<uint32_t>(value == nullptr ? 0U : strlen(value) + 1);
-    return GetVarcharValue(value, len, manage_data);
+    return GetVarcharValue(value, len, manage_data, pool);
   }
 
+  /**
+   * @return a VARCHAR value of the given data. If a pool is given, the data is copied into the pool regardless of
+   * manage_data, and the value must not outlive the pool.
+   */
   static inline Value GetVarcharValue(const char *value, uint32_t len, bool manage_data,
-                                      __attribute__((__unused__)) AbstractPool *pool = nullptr) {
-    return Value(TypeId::VARCHAR, value, len, manage_data);
+                                      AbstractPool *pool = nullptr) {
+    if (pool == nullptr || value == nullptr) {
+      return Value(TypeId::VARCHAR, value, len, manage_data);
+    }
+    auto data = static_cast<char *>(pool->Allocate(len));
+    memcpy(data, value, len);
+    return Value(TypeId::VARCHAR, data, len, false);
   }
 
-  static inline Value GetVarcharValue(const std::string &value,
-                                      __attribute__((__unused__)) AbstractPool *pool = nullptr) {
-    return Value(TypeId::VARCHAR, value);
+  static inline Value GetVarcharValue(const std::string &value, AbstractPool *pool = nullptr) {
+    if (pool == nullptr) {
+      return Value(TypeId::VARCHAR, value);
+    }
+    return GetVarcharValue(value.c_str(), static_cast<uint32_t>(value.length()) + 1, false, pool);
   }
 
   static inline Value GetNullValueByType(TypeId type_id) {
@@ -11,14 +11,17 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "common/logger.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/page_codec.h"
 
 namespace bustub {
 
@@ -28,8 +31,14 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, bool compress_pages)
+    : file_name_(db_file),
+      next_page_id_(0),
+      num_flushes_(0),
+      num_writes_(0),
+      compress_pages_(compress_pages),
+      flush_log_(false),
+      flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.find('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -58,6 +67,9 @@ DiskManager::DiskManager(const std::string &db_file)
     // reopen with original mode
     db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   }
+  if (compress_pages_) {
+    ReadSlots();
+  }
   buffer_used = nullptr;
 }
 
@@ -73,11 +85,41 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  if (compress_pages_) {
+    // A stored size of PAGE_SIZE means that the page did not get any smaller and is stored as is.
+    char buffer[MAX_SLOT_SIZE];
+    auto header = reinterpret_cast<SlotHeader *>(buffer);
+    char *stored = buffer + sizeof(SlotHeader);
+    uint32_t stored_size = PageCodec::Compress(page_data, PAGE_SIZE, stored, PAGE_SIZE - 1);
+    if (stored_size == 0) {
+      stored_size = PAGE_SIZE;
+      memcpy(stored, page_data, PAGE_SIZE);
+    }
+    uint32_t size = (sizeof(SlotHeader) + stored_size + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+    // A page that still fits into its slot is rewritten in place. Otherwise it moves to a new slot, and the old slot
+    // is only freed once the page is in the new one.
+    auto iter = slots_.find(page_id);
+    bool had_slot = iter != slots_.end();
+    Slot old_slot = had_slot ? iter->second : Slot{0, 0};
+    Slot slot = old_slot;
+    if (old_slot.size_ < size) {
+      slot = AllocateSlot(size);
+      slots_[page_id] = slot;
+    }
+    *header = {next_sequence_++, page_id, stored_size, slot.size_};
+    db_io_.seekp(slot.offset_);
+    db_io_.write(buffer, sizeof(SlotHeader) + stored_size);
+    num_bytes_written_ += sizeof(SlotHeader) + stored_size;
+    if (had_slot && slot.offset_ != old_slot.offset_) {
+      FreeSlot(old_slot);
+    }
+  } else {
+    // set write cursor to offset
+    db_io_.seekp(GetPageOffset(page_id));
+    db_io_.write(page_data, PAGE_SIZE);
+    num_bytes_written_ += PAGE_SIZE;
+  }
   // check for I/O error
   if (db_io_.bad()) {
     LOG_DEBUG("I/O error while writing");
@@ -90,8 +132,42 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
 /**
  * Read the contents of the specified page into the given memory area
  */
-void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
+bool DiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  if (compress_pages_) {
+    auto iter = slots_.find(page_id);
+    if (iter == slots_.end()) {
+      if (lost_slots_) {
+        LOG_ERROR("Page %d may have been lost to a corrupt slot header", page_id);
+        return false;
+      }
+      // A page that was allocated but never written reads as zeroes, just like in an uncompressed file.
+      memset(page_data, 0, PAGE_SIZE);
+      return true;
+    }
+    // The whole slot is read at once. The last slot of the file may end before its padding does.
+    const Slot &slot = iter->second;
+    char buffer[MAX_SLOT_SIZE];
+    db_io_.seekp(slot.offset_);
+    db_io_.read(buffer, slot.size_);
+    auto read_count = static_cast<size_t>(db_io_.gcount());
+    db_io_.clear();
+    num_bytes_read_ += read_count;
+    auto header = reinterpret_cast<const SlotHeader *>(buffer);
+    const char *stored = buffer + sizeof(SlotHeader);
+    bool valid = read_count >= sizeof(SlotHeader) && header->page_id_ == page_id && header->slot_size_ == slot.size_ &&
+                 header->stored_size_ != 0 && header->stored_size_ <= PAGE_SIZE &&
+                 read_count >= sizeof(SlotHeader) + header->stored_size_;
+    if (valid && header->stored_size_ == PAGE_SIZE) {
+      memcpy(page_data, stored, PAGE_SIZE);
+      return true;
+    }
+    if (!valid || !PageCodec::Decompress(stored, header->stored_size_, page_data, PAGE_SIZE)) {
+      LOG_ERROR("Corrupt slot of page %d at offset %zu", page_id, slot.offset_);
+      return false;
+    }
+    return true;
+  }
+  int offset = GetPageOffset(page_id);
   // check if read beyond file length
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error while reading");
@@ -102,12 +178,14 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
     db_io_.read(page_data, PAGE_SIZE);
     // if file ends before reading PAGE_SIZE
     int read_count = db_io_.gcount();
+    num_bytes_read_ += read_count;
     if (read_count < PAGE_SIZE) {
       LOG_DEBUG("Read less than a page");
       // std::cerr << "Read less than a page" << std::endl;
       memset(page_data + read_count, 0, PAGE_SIZE - read_count);
     }
   }
+  return true;
 }
 
 /**
@@ -176,9 +254,19 @@ page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
 /**
  * Deallocate page (operations like drop index/table)
  * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * Only a compressed file frees the slot of the page, for AllocateSlot() to reuse.
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  if (!compress_pages_) {
+    return;
+  }
+  auto iter = slots_.find(page_id);
+  if (iter != slots_.end()) {
+    FreeSlot(iter->second);
+    slots_.erase(iter);
+    db_io_.flush();
+  }
+}
 
 /**
  * Returns number of flushes made so far
@@ -190,11 +278,103 @@ int DiskManager::GetNumFlushes() const { return num_flushes_; }
  */
 int DiskManager::GetNumWrites() const { return num_writes_; }
 
+/**
+ * Returns number of bytes of page data written so far
+ */
+size_t DiskManager::GetNumBytesWritten() const { return num_bytes_written_; }
+
+/**
+ * Returns number of bytes of page data read so far
+ */
+size_t DiskManager::GetNumBytesRead() const { return num_bytes_read_; }
+
 /**
  * Returns true if the log is currently being flushed
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to get the offset of a page in the database file
+ */
+size_t DiskManager::GetPageOffset(page_id_t page_id) const { return static_cast<size_t>(page_id) * PAGE_SIZE; }
+
+/**
+ * Private helper function to find the slots of an existing compressed database file
+ */
+void DiskManager::ReadSlots() {
+  auto file_size = static_cast<size_t>(std::max(GetFileSize(file_name_), 0));
+  std::unordered_map<page_id_t, uint64_t> sequences;
+  std::vector<Slot> stale_slots;
+  SlotHeader header;
+  while (file_end_ + sizeof(SlotHeader) <= file_size) {
+    db_io_.seekp(file_end_);
+    db_io_.read(reinterpret_cast<char *>(&header), sizeof(SlotHeader));
+    if (header.slot_size_ < sizeof(SlotHeader) || header.slot_size_ > MAX_SLOT_SIZE ||
+        header.slot_size_ % SLOT_ALIGNMENT != 0) {
+      // The slots after this one cannot be found anymore. They are left alone, and new slots go after them.
+      LOG_ERROR("Corrupt slot header at offset %zu, ignoring the rest of the file", file_end_);
+      lost_slots_ = true;
+      file_end_ = (file_size + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+      break;
+    }
+    Slot slot{file_end_, header.slot_size_};
+    file_end_ += slot.size_;
+    if (header.page_id_ == INVALID_PAGE_ID) {
+      free_slots_.emplace(slot.size_, slot.offset_);
+      continue;
+    }
+    next_sequence_ = std::max(next_sequence_, header.sequence_ + 1);
+    // A slot whose page was cut short by the end of the file was being written when the process stopped.
+    if (header.stored_size_ == 0 || header.stored_size_ > PAGE_SIZE ||
+        slot.offset_ + sizeof(SlotHeader) + header.stored_size_ > file_size) {
+      stale_slots.push_back(slot);
+      continue;
+    }
+    auto iter = slots_.find(header.page_id_);
+    if (iter == slots_.end()) {
+      slots_[header.page_id_] = slot;
+      sequences[header.page_id_] = header.sequence_;
+    } else if (header.sequence_ > sequences[header.page_id_]) {
+      stale_slots.push_back(iter->second);
+      iter->second = slot;
+      sequences[header.page_id_] = header.sequence_;
+    } else {
+      stale_slots.push_back(slot);
+    }
+  }
+  db_io_.clear();
+  for (const auto &slot : stale_slots) {
+    FreeSlot(slot);
+  }
+  db_io_.flush();
+}
+
+/**
+ * Private helper function to find room for a page in a compressed database file
+ */
+DiskManager::Slot DiskManager::AllocateSlot(uint32_t size) {
+  auto iter = free_slots_.lower_bound(size);
+  if (iter != free_slots_.end()) {
+    // The whole free slot is used, so that every slot stays a multiple of SLOT_ALIGNMENT and can be found again.
+    Slot slot{iter->second, iter->first};
+    free_slots_.erase(iter);
+    return slot;
+  }
+  Slot slot{file_end_, size};
+  file_end_ += size;
+  return slot;
+}
+
+/**
+ * Private helper function to give up the slot of a page in a compressed database file
+ */
+void DiskManager::FreeSlot(const Slot &slot) {
+  SlotHeader header{0, INVALID_PAGE_ID, 0, slot.size_};
+  db_io_.seekp(slot.offset_);
+  db_io_.write(reinterpret_cast<char *>(&header), sizeof(SlotHeader));
+  free_slots_.emplace(slot.size_, slot.offset_);
+}
+
 /**
  * Private helper function to get disk file size
  */
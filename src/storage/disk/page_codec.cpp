@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_codec.cpp
+//
+// Identification: src/storage/disk/page_codec.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace bustub {
+
+uint32_t PageCodec::Hash(const char *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+
+bool PageCodec::WriteLength(size_t length, char *dst, size_t dst_capacity, size_t *pos) {
+  for (; length >= 255; length -= 255) {
+    if (*pos == dst_capacity) {
+      return false;
+    }
+    dst[(*pos)++] = static_cast<char>(255);
+  }
+  if (*pos == dst_capacity) {
+    return false;
+  }
+  dst[(*pos)++] = static_cast<char>(length);
+  return true;
+}
+
+bool PageCodec::ReadLength(const char *src, size_t src_size, size_t *pos, size_t *length) {
+  uint8_t byte;
+  do {
+    if (*pos == src_size) {
+      return false;
+    }
+    byte = static_cast<uint8_t>(src[(*pos)++]);
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+size_t PageCodec::Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) {
+  // The most recent position of every hash, offset by one so that zero means none.
+  std::vector<uint32_t> table(1U << HASH_BITS, 0);
+  size_t pos = 0;
+  size_t anchor = 0;
+
+  // Writes the literals since the anchor and, if match_length is not 0, the back-reference after them.
+  auto emit = [&](size_t literal_length, size_t offset, size_t match_length) {
+    if (pos == dst_capacity) {
+      return false;
+    }
+    size_t token_pos = pos++;
+    uint8_t token = static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4);
+    if (literal_length >= 15 && !WriteLength(literal_length - 15, dst, dst_capacity, &pos)) {
+      return false;
+    }
+    if (dst_capacity - pos < literal_length) {
+      return false;
+    }
+    memcpy(dst + pos, src + anchor, literal_length);
+    pos += literal_length;
+    if (match_length != 0) {
+      if (dst_capacity - pos < 2) {
+        return false;
+      }
+      dst[pos++] = static_cast<char>(offset & 0xff);
+      dst[pos++] = static_cast<char>(offset >> 8);
+      size_t extra = match_length - MIN_MATCH;
+      token |= static_cast<uint8_t>(std::min<size_t>(extra, 15));
+      if (extra >= 15 && !WriteLength(extra - 15, dst, dst_capacity, &pos)) {
+        return false;
+      }
+    }
+    dst[token_pos] = static_cast<char>(token);
+    return true;
+  };
+
+  if (src_size > MATCH_LIMIT) {
+    size_t ip = 0;
+    while (ip < src_size - MATCH_LIMIT) {
+      uint32_t h = Hash(src + ip);
+      size_t candidate = table[h];
+      table[h] = static_cast<uint32_t>(ip + 1);
+      if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET ||
+          memcmp(src + candidate - 1, src + ip, MIN_MATCH) != 0) {
+        ip++;
+        continue;
+      }
+      size_t ref = candidate - 1;
+      size_t match_length = MIN_MATCH;
+      while (ip + match_length < src_size - LAST_LITERALS && src[ref + match_length] == src[ip + match_length]) {
+        match_length++;
+      }
+      if (!emit(ip - anchor, ip - ref, match_length)) {
+        return 0;
+      }
+      ip += match_length;
+      anchor = ip;
+    }
+  }
+  if (!emit(src_size - anchor, 0, 0)) {
+    return 0;
+  }
+  return pos;
+}
+
+bool PageCodec::Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) {
+  size_t ip = 0;
+  size_t op = 0;
+  while (ip < src_size) {
+    auto token = static_cast<uint8_t>(src[ip++]);
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !ReadLength(src, src_size, &ip, &literal_length)) {
+      return false;
+    }
+    if (src_size - ip < literal_length || dst_size - op < literal_length) {
+      return false;
+    }
+    memcpy(dst + op, src + ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+    if (ip == src_size) {
+      // The last sequence has no back-reference.
+      break;
+    }
+    if (src_size - ip < 2) {
+      return false;
+    }
+    size_t offset = static_cast<uint8_t>(src[ip]) | (static_cast<size_t>(static_cast<uint8_t>(src[ip + 1])) << 8);
+    ip += 2;
+    size_t match_length = token & 0xf;
+    if (match_length == 15 && !ReadLength(src, src_size, &ip, &match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > op || dst_size - op < match_length) {
+      return false;
+    }
+    // The source of a back-reference may overlap its destination, as in a run of one repeated byte.
+    for (size_t i = 0; i < match_length; i++, op++) {
+      dst[op] = dst[op - offset];
+    }
+  }
+  return op == dst_size;
+}
+
+}  // namespace bustub
@@ -0,0 +1,294 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_page.cpp
+//
+// Identification: src/storage/page/pax_table_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_table_page.h"
+
+#include <cassert>
+#include <vector>
+
+namespace bustub {
+
+PaxLayout::PaxLayout(const Schema &schema) : schema_(schema) {
+  // Every minipage starts 8-byte aligned, which costs at most 7 bytes of padding per column.
+  constexpr uint32_t ALIGNMENT = 8;
+  uint32_t column_count = schema_.GetColumnCount();
+  uint32_t space = PAGE_SIZE - PaxTablePage::SIZE_TABLE_PAGE_HEADER - ALIGNMENT * column_count;
+  uint32_t row_size = PaxTablePage::SIZE_TUPLE + schema_.GetLength() +
+                      schema_.GetUnlinedColumnCount() * (sizeof(uint32_t) + VARLEN_RESERVE);
+  capacity_ = space / row_size;
+  BUSTUB_ASSERT(capacity_ > 0, "A PAX page must hold at least one tuple.");
+
+  uint32_t offset = PaxTablePage::SIZE_TABLE_PAGE_HEADER + capacity_ * PaxTablePage::SIZE_TUPLE;
+  minipage_offsets_.reserve(column_count);
+  for (const auto &col : schema_.GetColumns()) {
+    offset = (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    minipage_offsets_.push_back(offset);
+    offset += capacity_ * col.GetFixedLength();
+  }
+  data_end_ = offset;
+}
+
+bool PaxTablePage::InsertTuple(const PaxLayout &layout, const Tuple &tuple, RID *rid, Transaction *txn,
+                               LockManager *lock_manager, LogManager *log_manager) {
+  uint32_t fixed_size = layout.GetSchema().GetLength();
+  BUSTUB_ASSERT(tuple.size_ >= fixed_size, "The tuple does not match the schema of the table.");
+  uint32_t varlen_size = tuple.size_ - fixed_size;
+  // If there is not enough space for the VARCHAR data, then return false.
+  if (GetFreeSpacePointer() - layout.GetDataEnd() < varlen_size) {
+    return false;
+  }
+
+  // Try to find a free slot to reuse, or claim a new one.
+  uint32_t i;
+  for (i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) == 0) {
+      break;
+    }
+  }
+  if (i == layout.GetCapacity()) {
+    return false;
+  }
+
+  // Store the VARCHAR data in the free space, and the rest of the tuple in the minipages.
+  SetFreeSpacePointer(GetFreeSpacePointer() - varlen_size);
+  memcpy(GetData() + GetFreeSpacePointer(), tuple.data_ + fixed_size, varlen_size);
+  Scatter(layout, i, tuple.data_);
+  SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
+  SetTupleSize(i, tuple.size_);
+
+  rid->Set(GetTablePageId(), i);
+  if (i == GetTupleCount()) {
+    SetTupleCount(GetTupleCount() + 1);
+  }
+
+  // Write the log record.
+  if (enable_logging) {
+    BUSTUB_ASSERT(!txn->IsSharedLocked(*rid) && !txn->IsExclusiveLocked(*rid), "A new tuple should not be locked.");
+    // Acquire an exclusive lock on the new tuple.
+    bool locked = lock_manager->LockExclusive(txn, *rid);
+    BUSTUB_ASSERT(locked, "Locking a new tuple should always work.");
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::INSERT, *rid, tuple);
+    AppendLogRecord(&log_record, txn, log_manager);
+  }
+  return true;
+}
+
+uint32_t PaxTablePage::PackTuples(const PaxLayout &layout, const std::vector<Tuple> &tuples, size_t begin,
+                                  Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  BUSTUB_ASSERT(GetTupleCount() == 0, "Tuples can only be packed into an empty page.");
+  uint32_t fixed_size = layout.GetSchema().GetLength();
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  uint32_t slot = 0;
+  for (size_t i = begin; i < tuples.size() && slot < layout.GetCapacity(); i++, slot++) {
+    uint32_t varlen_size = tuples[i].size_ - fixed_size;
+    if (free_space_pointer - layout.GetDataEnd() < varlen_size) {
+      break;
+    }
+    free_space_pointer -= varlen_size;
+    memcpy(GetData() + free_space_pointer, tuples[i].data_ + fixed_size, varlen_size);
+    Scatter(layout, slot, tuples[i].data_);
+    SetTupleOffsetAtSlot(slot, free_space_pointer);
+    SetTupleSize(slot, tuples[i].size_);
+  }
+  SetFreeSpacePointer(free_space_pointer);
+  SetTupleCount(slot);
+  LogPackedTuples(slot, txn, lock_manager, log_manager);
+  return slot;
+}
+
+bool PaxTablePage::UpdateTuple(const PaxLayout &layout, const Tuple &new_tuple, Tuple *old_tuple, const RID &rid,
+                               Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  uint32_t fixed_size = layout.GetSchema().GetLength();
+  BUSTUB_ASSERT(new_tuple.size_ >= fixed_size, "The tuple does not match the schema of the table.");
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the tuple does not exist or is deleted, abort the transaction.
+  uint32_t tuple_size = GetLiveTupleSize(rid, txn);
+  if (tuple_size == 0) {
+    return false;
+  }
+  uint32_t varlen_size = tuple_size - fixed_size;
+  uint32_t new_varlen_size = new_tuple.size_ - fixed_size;
+  // If there is not enough space to update, we need to update via delete followed by an insert.
+  if (GetFreeSpacePointer() - layout.GetDataEnd() + varlen_size < new_varlen_size) {
+    return false;
+  }
+
+  // Copy out the old value.
+  Reassemble(layout, slot_num, tuple_size, old_tuple);
+  old_tuple->rid_ = rid;
+
+  if (enable_logging) {
+    if (!LockExclusive(rid, txn, lock_manager)) {
+      return false;
+    }
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::UPDATE, rid, *old_tuple, new_tuple);
+    AppendLogRecord(&log_record, txn, log_manager);
+  }
+
+  // Perform the update, resizing the VARCHAR data of the tuple in place just like TablePage does.
+  uint32_t varlen_offset = GetTupleOffsetAtSlot(slot_num);
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  BUSTUB_ASSERT(varlen_offset >= free_space_pointer, "Offset should appear after current free space position.");
+
+  memmove(GetData() + free_space_pointer + varlen_size - new_varlen_size, GetData() + free_space_pointer,
+          varlen_offset - free_space_pointer);
+  SetFreeSpacePointer(free_space_pointer + varlen_size - new_varlen_size);
+  memcpy(GetData() + varlen_offset + varlen_size - new_varlen_size, new_tuple.data_ + fixed_size, new_varlen_size);
+  Scatter(layout, slot_num, new_tuple.data_);
+  SetTupleSize(slot_num, new_tuple.size_);
+
+  // Update all VARCHAR data offsets.
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    uint32_t varlen_offset_i = GetTupleOffsetAtSlot(i);
+    if (GetTupleSize(i) > 0 && varlen_offset_i < varlen_offset + varlen_size) {
+      SetTupleOffsetAtSlot(i, varlen_offset_i + varlen_size - new_varlen_size);
+    }
+  }
+  return true;
+}
+
+void PaxTablePage::ApplyDelete(const PaxLayout &layout, const RID &rid, Transaction *txn, LogManager *log_manager,
+                               Tuple *deleted_tuple) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+
+  uint32_t varlen_offset = GetTupleOffsetAtSlot(slot_num);
+  // Either commit a delete, or roll back an insert.
+  uint32_t tuple_size = UnsetDeletedFlag(GetTupleSize(slot_num));
+  uint32_t varlen_size = tuple_size - layout.GetSchema().GetLength();
+
+  // We need to copy out the deleted tuple for undo purposes.
+  Tuple delete_tuple;
+  Reassemble(layout, slot_num, tuple_size, &delete_tuple);
+  delete_tuple.rid_ = rid;
+
+  if (enable_logging) {
+    BUSTUB_ASSERT(txn->IsExclusiveLocked(rid), "We must own the exclusive lock!");
+
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::APPLYDELETE, rid, delete_tuple);
+    AppendLogRecord(&log_record, txn, log_manager);
+  }
+  if (deleted_tuple != nullptr) {
+    *deleted_tuple = delete_tuple;
+  }
+
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  BUSTUB_ASSERT(varlen_offset >= free_space_pointer, "Free space appears before tuples.");
+
+  memmove(GetData() + free_space_pointer + varlen_size, GetData() + free_space_pointer,
+          varlen_offset - free_space_pointer);
+  SetFreeSpacePointer(free_space_pointer + varlen_size);
+  SetTupleSize(slot_num, 0);
+  SetTupleOffsetAtSlot(slot_num, 0);
+
+  // Update all VARCHAR data offsets.
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    uint32_t varlen_offset_i = GetTupleOffsetAtSlot(i);
+    if (GetTupleSize(i) != 0 && varlen_offset_i < varlen_offset) {
+      SetTupleOffsetAtSlot(i, varlen_offset_i + varlen_size);
+    }
+  }
+}
+
+bool PaxTablePage::GetTuple(const PaxLayout &layout, const RID &rid, Tuple *tuple, Transaction *txn,
+                            LockManager *lock_manager) {
+  // If the tuple does not exist or is deleted, abort the transaction.
+  uint32_t tuple_size = GetLiveTupleSize(rid, txn);
+  if (tuple_size == 0) {
+    return false;
+  }
+  // Otherwise we have a valid tuple, try to acquire at least a shared lock.
+  if (enable_logging && !LockShared(rid, txn, lock_manager)) {
+    return false;
+  }
+  Reassemble(layout, rid.GetSlotNum(), tuple_size, tuple);
+  tuple->rid_ = rid;
+  return true;
+}
+
+bool PaxTablePage::ScanColumns(const PaxLayout &layout, uint32_t *slot, const std::vector<uint32_t> &column_idxs,
+                               TupleBatch *batch, uint32_t limit, Transaction *txn, LockManager *lock_manager) {
+  assert(limit <= batch->GetCapacity());
+  // Find the visible tuples first, so that every column is then copied in one pass over its minipage.
+  std::vector<RID> rids;
+  uint32_t first_row = batch->GetSize();
+  uint32_t i = *slot;
+  for (; i < GetTupleCount() && first_row + rids.size() < limit; i++) {
+    RID rid(GetTablePageId(), i);
+    if (IsDeleted(GetTupleSize(i)) || (enable_logging && !LockShared(rid, txn, lock_manager))) {
+      continue;
+    }
+    rids.push_back(rid);
+  }
+  *slot = i;
+  batch->AppendRows(rids);
+
+  const Schema &schema = layout.GetSchema();
+  for (auto col_idx : column_idxs) {
+    const auto &col = schema.GetColumn(col_idx);
+    ColumnVector &column = batch->GetColumn(col_idx);
+    const char *minipage = GetData() + layout.GetMinipageOffset(col_idx);
+    uint32_t width = col.GetFixedLength();
+    for (uint32_t row = 0; row < rids.size(); row++) {
+      uint32_t slot_num = rids[row].GetSlotNum();
+      if (col.IsInlined()) {
+        column.SetRaw(first_row + row, minipage + slot_num * width);
+        continue;
+      }
+      // The VARCHAR data is at its offset within the tuple, counted from the end of the fixed-length part.
+      uint32_t offset = *reinterpret_cast<const uint32_t *>(minipage + slot_num * width);
+      const char *data = GetData() + GetTupleOffsetAtSlot(slot_num) + offset - schema.GetLength();
+      column.SetValue(first_row + row, Value::DeserializeFrom(data, col.GetType()));
+    }
+  }
+  return i == GetTupleCount();
+}
+
+uint32_t PaxTablePage::GetInsertSpace(const PaxLayout &layout) {
+  // Once every slot has been claimed, only the slots of deleted tuples can be reused.
+  bool has_free_slot = GetTupleCount() < layout.GetCapacity();
+  for (uint32_t i = 0; !has_free_slot && i < GetTupleCount(); i++) {
+    has_free_slot = GetTupleSize(i) == 0;
+  }
+  if (!has_free_slot) {
+    return 0;
+  }
+  return layout.GetSchema().GetLength() + GetFreeSpacePointer() - layout.GetDataEnd();
+}
+
+void PaxTablePage::Reassemble(const PaxLayout &layout, uint32_t slot_num, uint32_t tuple_size, Tuple *tuple) {
+  if (tuple->allocated_) {
+    delete[] tuple->data_;
+  }
+  tuple->data_ = new char[tuple_size];
+  tuple->size_ = tuple_size;
+  tuple->allocated_ = true;
+  const Schema &schema = layout.GetSchema();
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &col = schema.GetColumn(i);
+    uint32_t width = col.GetFixedLength();
+    memcpy(tuple->data_ + col.GetOffset(), GetData() + layout.GetMinipageOffset(i) + slot_num * width, width);
+  }
+  memcpy(tuple->data_ + schema.GetLength(), GetData() + GetTupleOffsetAtSlot(slot_num),
+         tuple_size - schema.GetLength());
+}
+
+void PaxTablePage::Scatter(const PaxLayout &layout, uint32_t slot_num, const char *tuple_data) {
+  const Schema &schema = layout.GetSchema();
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &col = schema.GetColumn(i);
+    uint32_t width = col.GetFixedLength();
+    memcpy(GetData() + layout.GetMinipageOffset(i) + slot_num * width, tuple_data + col.GetOffset(), width);
+  }
+}
+
+}  // namespace bustub
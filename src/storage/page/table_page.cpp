@@ -23,9 +23,7 @@ void TablePage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_
   // Log that we are creating a new page.
   if (enable_logging) {
     LogRecord log_record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::NEWPAGE, prev_page_id);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
-    SetLSN(lsn);
-    txn->SetPrevLSN(lsn);
+    AppendLogRecord(&log_record, txn, log_manager);
   }
   // Set the previous and next page IDs.
   SetPrevPageId(prev_page_id);
@@ -77,52 +75,49 @@ bool TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
     bool locked = lock_manager->LockExclusive(txn, *rid);
     BUSTUB_ASSERT(locked, "Locking a new tuple should always work.");
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::INSERT, *rid, tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
-    SetLSN(lsn);
-    txn->SetPrevLSN(lsn);
+    AppendLogRecord(&log_record, txn, log_manager);
   }
   return true;
 }
 
-bool TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
-  uint32_t slot_num = rid.GetSlotNum();
-  // If the slot number is invalid, abort the transaction.
-  if (slot_num >= GetTupleCount()) {
-    if (enable_logging) {
-      txn->SetState(TransactionState::ABORTED);
-    }
-    return false;
+uint32_t TablePage::PackTuples(const std::vector<Tuple> &tuples, size_t begin, Transaction *txn,
+                               LockManager *lock_manager, LogManager *log_manager) {
+  BUSTUB_ASSERT(GetTupleCount() == 0, "Tuples can only be packed into an empty page.");
+  // Without any free slots to look for, every tuple simply goes below the previous one.
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  uint32_t free_space = GetFreeSpaceRemaining();
+  uint32_t slot = 0;
+  for (size_t i = begin; i < tuples.size() && free_space >= tuples[i].size_ + SIZE_TUPLE; i++, slot++) {
+    free_space_pointer -= tuples[i].size_;
+    free_space -= tuples[i].size_ + SIZE_TUPLE;
+    memcpy(GetData() + free_space_pointer, tuples[i].data_, tuples[i].size_);
+    SetTupleOffsetAtSlot(slot, free_space_pointer);
+    SetTupleSize(slot, tuples[i].size_);
   }
+  SetFreeSpacePointer(free_space_pointer);
+  SetTupleCount(slot);
+  LogPackedTuples(slot, txn, lock_manager, log_manager);
+  return slot;
+}
 
-  uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is already deleted, abort the transaction.
-  if (IsDeleted(tuple_size)) {
-    if (enable_logging) {
-      txn->SetState(TransactionState::ABORTED);
-    }
+bool TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  // If the tuple does not exist or is already deleted, abort the transaction.
+  uint32_t tuple_size = GetLiveTupleSize(rid, txn);
+  if (tuple_size == 0) {
     return false;
   }
 
   if (enable_logging) {
-    // Acquire an exclusive lock, upgrading from a shared lock if necessary.
-    if (txn->IsSharedLocked(rid)) {
-      if (!lock_manager->LockUpgrade(txn, rid)) {
-        return false;
-      }
-    } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
+    if (!LockExclusive(rid, txn, lock_manager)) {
       return false;
     }
     Tuple dummy_tuple;
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::MARKDELETE, rid, dummy_tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
-    SetLSN(lsn);
-    txn->SetPrevLSN(lsn);
+    AppendLogRecord(&log_record, txn, log_manager);
   }
 
   // Mark the tuple as deleted.
-  if (tuple_size > 0) {
-    SetTupleSize(slot_num, SetDeletedFlag(tuple_size));
-  }
+  SetTupleSize(rid.GetSlotNum(), SetDeletedFlag(tuple_size));
   return true;
 }
 
@@ -130,19 +125,9 @@ bool TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
                             LockManager *lock_manager, LogManager *log_manager) {
   BUSTUB_ASSERT(new_tuple.size_ > 0, "Cannot have empty tuples.");
   uint32_t slot_num = rid.GetSlotNum();
-  // If the slot number is invalid, abort the transaction.
-  if (slot_num >= GetTupleCount()) {
-    if (enable_logging) {
-      txn->SetState(TransactionState::ABORTED);
-    }
-    return false;
-  }
-  uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is deleted, abort the transaction.
-  if (IsDeleted(tuple_size)) {
-    if (enable_logging) {
-      txn->SetState(TransactionState::ABORTED);
-    }
+  // If the tuple does not exist or is deleted, abort the transaction.
+  uint32_t tuple_size = GetLiveTupleSize(rid, txn);
+  if (tuple_size == 0) {
     return false;
   }
   // If there is not enuogh space to update, we need to update via delete followed by an insert (not enough space).
@@ -162,18 +147,11 @@ bool TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   old_tuple->allocated_ = true;
 
   if (enable_logging) {
-    // Acquire an exclusive lock, upgrading from shared if necessary.
-    if (txn->IsSharedLocked(rid)) {
-      if (!lock_manager->LockUpgrade(txn, rid)) {
-        return false;
-      }
-    } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
+    if (!LockExclusive(rid, txn, lock_manager)) {
       return false;
     }
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::UPDATE, rid, *old_tuple, new_tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
-    SetLSN(lsn);
-    txn->SetPrevLSN(lsn);
+    AppendLogRecord(&log_record, txn, log_manager);
   }
 
   // Perform the update.
@@ -196,7 +174,7 @@ bool TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   return true;
 }
 
-void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple) {
   uint32_t slot_num = rid.GetSlotNum();
   BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
@@ -220,9 +198,10 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
     BUSTUB_ASSERT(txn->IsExclusiveLocked(rid), "We must own the exclusive lock!");
 
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::APPLYDELETE, rid, delete_tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
-    SetLSN(lsn);
-    txn->SetPrevLSN(lsn);
+    AppendLogRecord(&log_record, txn, log_manager);
+  }
+  if (deleted_tuple != nullptr) {
+    *deleted_tuple = delete_tuple;
   }
 
   uint32_t free_space_pointer = GetFreeSpacePointer();
@@ -249,9 +228,7 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
     BUSTUB_ASSERT(txn->IsExclusiveLocked(rid), "We must own an exclusive lock on the RID.");
     Tuple dummy_tuple;
     LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ROLLBACKDELETE, rid, dummy_tuple);
-    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
-    SetLSN(lsn);
-    txn->SetPrevLSN(lsn);
+    AppendLogRecord(&log_record, txn, log_manager);
   }
 
   uint32_t slot_num = rid.GetSlotNum();
@@ -265,42 +242,42 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
 }
 
 bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
-  // Get the current slot number.
-  uint32_t slot_num = rid.GetSlotNum();
-  // If somehow we have more slots than tuples, abort the transaction.
-  if (slot_num >= GetTupleCount()) {
-    if (enable_logging) {
-      txn->SetState(TransactionState::ABORTED);
-    }
+  Tuple view;
+  if (!GetTupleView(rid, &view, txn, lock_manager)) {
     return false;
   }
-  // Otherwise get the current tuple size too.
-  uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is deleted, abort the transaction.
-  if (IsDeleted(tuple_size)) {
-    if (enable_logging) {
-      txn->SetState(TransactionState::ABORTED);
-    }
+  // Copy the tuple data into our result.
+  tuple->size_ = view.size_;
+  if (tuple->allocated_) {
+    delete[] tuple->data_;
+  }
+  tuple->data_ = new char[tuple->size_];
+  memcpy(tuple->data_, view.data_, tuple->size_);
+  tuple->rid_ = rid;
+  tuple->allocated_ = true;
+  return true;
+}
+
+bool TablePage::GetTupleView(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
+  // If the tuple does not exist or is deleted, abort the transaction.
+  uint32_t tuple_size = GetLiveTupleSize(rid, txn);
+  if (tuple_size == 0) {
     return false;
   }
 
   // Otherwise we have a valid tuple, try to acquire at least a shared lock.
-  if (enable_logging) {
-    if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid) && !lock_manager->LockShared(txn, rid)) {
-      return false;
-    }
+  if (enable_logging && !LockShared(rid, txn, lock_manager)) {
+    return false;
   }
 
-  // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
+  // At this point, we have at least a shared lock on the RID. Point the result at the tuple data.
   if (tuple->allocated_) {
     delete[] tuple->data_;
   }
-  tuple->data_ = new char[tuple->size_];
-  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
+  tuple->data_ = GetData() + GetTupleOffsetAtSlot(rid.GetSlotNum());
+  tuple->size_ = tuple_size;
   tuple->rid_ = rid;
-  tuple->allocated_ = true;
+  tuple->allocated_ = false;
   return true;
 }
 
@@ -329,4 +306,48 @@ bool TablePage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) {
   next_rid->Set(INVALID_PAGE_ID, 0);
   return false;
 }
+
+uint32_t TablePage::GetLiveTupleSize(const RID &rid, Transaction *txn) {
+  uint32_t slot_num = rid.GetSlotNum();
+  uint32_t tuple_size = slot_num < GetTupleCount() ? GetTupleSize(slot_num) : 0;
+  if (IsDeleted(tuple_size)) {
+    if (enable_logging) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return 0;
+  }
+  return tuple_size;
+}
+
+bool TablePage::LockShared(const RID &rid, Transaction *txn, LockManager *lock_manager) {
+  return txn->IsSharedLocked(rid) || txn->IsExclusiveLocked(rid) || lock_manager->LockShared(txn, rid);
+}
+
+bool TablePage::LockExclusive(const RID &rid, Transaction *txn, LockManager *lock_manager) {
+  if (txn->IsSharedLocked(rid)) {
+    return lock_manager->LockUpgrade(txn, rid);
+  }
+  return txn->IsExclusiveLocked(rid) || lock_manager->LockExclusive(txn, rid);
+}
+
+void TablePage::LogPackedTuples(uint32_t tuple_count, Transaction *txn, LockManager *lock_manager,
+                                LogManager *log_manager) {
+  if (!enable_logging) {
+    return;
+  }
+  for (uint32_t i = 0; i < tuple_count; i++) {
+    bool locked = lock_manager->LockExclusive(txn, RID(GetTablePageId(), i));
+    BUSTUB_ASSERT(locked, "Locking a new tuple should always work.");
+  }
+  LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BULKINSERT, GetTablePageId(),
+                       GetData());
+  AppendLogRecord(&log_record, txn, log_manager);
+}
+
+void TablePage::AppendLogRecord(LogRecord *log_record, Transaction *txn, LogManager *log_manager) {
+  lsn_t lsn = log_manager->AppendLogRecord(log_record);
+  SetLSN(lsn);
+  txn->SetPrevLSN(lsn);
+}
+
 }  // namespace bustub
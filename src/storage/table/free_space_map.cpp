@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {
+  page_id_t first_page_id;
+  auto page = static_cast<FreeSpaceMapPage *>(buffer_pool_manager_->NewPage(&first_page_id));
+  if (page == nullptr) {
+    return;
+  }
+  page->Init(first_page_id);
+  buffer_pool_manager_->UnpinPage(first_page_id, true);
+  map_page_ids_.push_back(first_page_id);
+  max_categories_.push_back(0);
+}
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id)
+    : buffer_pool_manager_(buffer_pool_manager) {
+  // Rebuild the in-memory part of the map from its pages.
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    map_page_ids_.push_back(page_id);
+    auto page = FetchMapPage(map_page_ids_.size() - 1);
+    if (page == nullptr) {
+      // A map that is missing pages would put the entries it adds in the wrong place, so it is not opened at all.
+      map_page_ids_.clear();
+      max_categories_.clear();
+      entries_.clear();
+      last_page_id_ = INVALID_PAGE_ID;
+      return;
+    }
+    max_categories_.push_back(page->GetMaxCategory());
+    for (uint32_t i = 0; i < page->GetEntryCount(); i++) {
+      last_page_id_ = page->GetTablePageId(i);
+      entries_[last_page_id_] = (map_page_ids_.size() - 1) * FreeSpaceMapPage::CAPACITY + i;
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+bool FreeSpaceMap::SetFreeSpace(page_id_t page_id, uint32_t free_space) {
+  uint8_t category = ToCategory(free_space);
+  std::scoped_lock latch{latch_};
+  auto iter = entries_.find(page_id);
+  if (iter != entries_.end()) {
+    size_t map_page_idx = iter->second / FreeSpaceMapPage::CAPACITY;
+    uint32_t idx = iter->second % FreeSpaceMapPage::CAPACITY;
+    auto page = FetchMapPage(map_page_idx);
+    if (page == nullptr) {
+      return false;
+    }
+    uint8_t old_category = page->GetCategory(idx);
+    page->SetCategory(idx, category);
+    // Only a page that had the largest category can lower the largest category of its map page.
+    if (category > max_categories_[map_page_idx]) {
+      max_categories_[map_page_idx] = category;
+    } else if (category < old_category && old_category == max_categories_[map_page_idx]) {
+      max_categories_[map_page_idx] = page->GetMaxCategory();
+    }
+    buffer_pool_manager_->UnpinPage(map_page_ids_[map_page_idx], category != old_category);
+    return true;
+  }
+
+  // A new page goes at the end of the last page of the map, or into a new map page once that one is full.
+  auto page = FetchMapPage(map_page_ids_.size() - 1);
+  if (page == nullptr) {
+    return false;
+  }
+  if (!page->Append(page_id, category)) {
+    page_id_t new_page_id;
+    auto new_page = static_cast<FreeSpaceMapPage *>(buffer_pool_manager_->NewPage(&new_page_id));
+    if (new_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(map_page_ids_.back(), false);
+      return false;
+    }
+    new_page->Init(new_page_id);
+    page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(map_page_ids_.back(), true);
+    map_page_ids_.push_back(new_page_id);
+    max_categories_.push_back(0);
+    page = new_page;
+    page->Append(page_id, category);
+  }
+  entries_[page_id] = (map_page_ids_.size() - 1) * FreeSpaceMapPage::CAPACITY + page->GetEntryCount() - 1;
+  max_categories_.back() = std::max(max_categories_.back(), category);
+  last_page_id_ = page_id;
+  buffer_pool_manager_->UnpinPage(map_page_ids_.back(), true);
+  return true;
+}
+
+bool FreeSpaceMap::FindPage(uint32_t tuple_size, page_id_t *page_id) {
+  *page_id = INVALID_PAGE_ID;
+  // Round up, so that every page in the category is sure to have enough room.
+  uint32_t min_category = std::max<uint32_t>((tuple_size + CATEGORY_SIZE - 1) / CATEGORY_SIZE, 1);
+  if (min_category > 255) {
+    return true;
+  }
+  std::scoped_lock latch{latch_};
+  for (size_t i = 0; i < map_page_ids_.size(); i++) {
+    if (max_categories_[i] < min_category) {
+      continue;
+    }
+    auto page = FetchMapPage(i);
+    if (page == nullptr) {
+      return false;
+    }
+    uint32_t idx = page->Find(min_category);
+    BUSTUB_ASSERT(idx != FreeSpaceMapPage::CAPACITY, "The largest category of a map page is out of date.");
+    *page_id = page->GetTablePageId(idx);
+    buffer_pool_manager_->UnpinPage(map_page_ids_[i], false);
+    return true;
+  }
+  return true;
+}
+
+page_id_t FreeSpaceMap::GetLastPageId() {
+  std::scoped_lock latch{latch_};
+  return last_page_id_;
+}
+
+FreeSpaceMapPage *FreeSpaceMap::FetchMapPage(size_t map_page_idx) {
+  return static_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_ids_[map_page_idx]));
+}
+
+}  // namespace bustub
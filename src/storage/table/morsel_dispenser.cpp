@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.cpp
+//
+// Identification: src/storage/table/morsel_dispenser.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/morsel_dispenser.h"
+
+#include <vector>
+
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+MorselDispenser::MorselDispenser(BufferPoolManager *bpm, page_id_t first_page_id, uint32_t morsel_size)
+    : bpm_(bpm), morsel_size_(morsel_size), next_page_id_(first_page_id) {}
+
+bool MorselDispenser::Next(std::vector<page_id_t> *page_ids) {
+  page_ids->clear();
+  std::scoped_lock latch{latch_};
+  // Pages are only linked through their headers, so walk the chain to find where the next morsel starts.
+  while (page_ids->size() < morsel_size_ && next_page_id_ != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(bpm_->FetchPage(next_page_id_));
+    BUSTUB_ASSERT(page != nullptr, "All pages are pinned.");
+    page->RLatch();
+    page_ids->push_back(next_page_id_);
+    next_page_id_ = page->GetNextPageId();
+    page->RUnlatch();
+    bpm_->UnpinPage(page_ids->back(), false);
+  }
+  return !page_ids->empty();
+}
+
+}  // namespace bustub
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <vector>
 
 #include "common/logger.h"
 #include "storage/table/table_heap.h"
@@ -18,68 +19,117 @@
 namespace bustub {
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, TableLayout layout, const Schema *schema,
+                     page_id_t free_space_map_page_id)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      layout_(layout) {
+  if (layout_ == TableLayout::PAX) {
+    BUSTUB_ASSERT(schema != nullptr, "PAX tables need a schema.");
+    pax_layout_ = std::make_unique<PaxLayout>(*schema);
+  }
+  if (free_space_map_page_id != INVALID_PAGE_ID) {
+    // The map is only a hint, so a table whose map cannot be read does without one.
+    free_space_map_ = std::make_unique<FreeSpaceMap>(buffer_pool_manager_, free_space_map_page_id);
+    if (!free_space_map_->IsOpen()) {
+      free_space_map_.reset();
+    }
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
-  // Initialize the first table page.
+                     Transaction *txn, TableLayout layout, const Schema *schema)
+    : TableHeap(buffer_pool_manager, lock_manager, log_manager, INVALID_PAGE_ID, layout, schema) {
+  // Initialize the first table page. Both page formats start out with the same header.
   auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
+  // The zone map sees the table from its very first page on.
+  if (schema != nullptr) {
+    zone_map_ = std::make_unique<ZoneMap>(*schema);
+    zone_map_->AddPage(first_page_id_, INVALID_PAGE_ID);
+  }
   first_page->WLatch();
   first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  free_space_map_ = std::make_unique<FreeSpaceMap>(buffer_pool_manager_);
+  if (free_space_map_->IsOpen()) {
+    free_space_map_->SetFreeSpace(first_page_id_, GetInsertSpace(first_page));
+  } else {
+    free_space_map_.reset();
+  }
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
-  if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
+  if (tuple.size_ > GetMaxTupleSize()) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  if (private_insert_pages_) {
+    return InsertIntoPrivatePage(tuple, rid, txn);
+  }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  // Without a free space map, or if the map cannot be read, every page is tried in turn from the first one.
+  page_id_t page_id;
+  if (free_space_map_ == nullptr || !FindInsertPage(tuple.size_, &page_id)) {
+    page_id = first_page_id_;
+  }
+  TablePage *cur_page;
+  if (page_id == INVALID_PAGE_ID) {
+    cur_page = AppendPage(txn, false);
+  } else {
+    cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (cur_page != nullptr) {
+      cur_page->WLatch();
+    }
+  }
   if (cur_page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  cur_page->WLatch();
   // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
   // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+  while (!InsertIntoPage(cur_page, tuple, rid, txn)) {
     auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      // And repeat the process with the next page.
+    if (free_space_map_ != nullptr) {
+      // The page has less room than the map said, so correct the map and look again. If the map has nothing better
+      // than this page, e.g. because it has not seen the pages after it yet, or cannot be read, just follow the chain.
+      free_space_map_->SetFreeSpace(cur_page->GetTablePageId(), GetInsertSpace(cur_page));
+      page_id_t found_page_id;
+      if (FindInsertPage(tuple.size_, &found_page_id) && found_page_id != cur_page->GetTablePageId()) {
+        next_page_id = found_page_id;
+      }
+    }
+    // Unlatch and unpin the current page.
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+    // If the next page is a valid page that is not some transaction's own, repeat the process with it.
+    if (next_page_id != INVALID_PAGE_ID && !IsPrivateInsertPage(next_page_id)) {
       cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      cur_page->WLatch();
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
-      if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+      if (cur_page == nullptr) {
         txn->SetState(TransactionState::ABORTED);
         return false;
       }
-      // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
+      cur_page->WLatch();
+      continue;
     }
+    // Otherwise we have run out of valid pages. We need to create a new page.
+    cur_page = AppendPage(txn, false);
+    // If we could not create a new page,
+    if (cur_page == nullptr) {
+      // Then life sucks and we abort the transaction.
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+  }
+  if (zone_map_ != nullptr) {
+    zone_map_->Insert(rid->GetPageId(), tuple);
+  }
+  if (free_space_map_ != nullptr) {
+    free_space_map_->SetFreeSpace(rid->GetPageId(), GetInsertSpace(cur_page));
   }
   // This line has caused most of us to double-take and "whoa double unlatch".
   // We are not, in fact, double unlatching. See the invariant above.
@@ -90,6 +140,236 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
   return true;
 }
 
+bool TableHeap::BulkInsert(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) {
+  for (const auto &tuple : tuples) {
+    if (tuple.size_ > GetMaxTupleSize()) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+  }
+
+  // Pack the tuples into a chain of new pages, which nobody else can see until it is linked to the table.
+  std::vector<page_id_t> new_page_ids;
+  std::vector<uint32_t> tuple_counts;
+  std::vector<uint32_t> insert_spaces;
+  auto abandon = [&]() {
+    for (auto page_id : new_page_ids) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  };
+  TablePage *prev_page = nullptr;
+  for (size_t begin = 0; begin < tuples.size();) {
+    page_id_t page_id;
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&page_id));
+    if (prev_page != nullptr) {
+      if (page != nullptr) {
+        prev_page->SetNextPageId(page_id);
+      }
+      buffer_pool_manager_->UnpinPage(prev_page->GetTablePageId(), true);
+    }
+    if (page == nullptr) {
+      return abandon();
+    }
+    page->Init(page_id, PAGE_SIZE, prev_page == nullptr ? INVALID_PAGE_ID : prev_page->GetTablePageId(),
+               log_manager_, txn);
+    uint32_t count = pax_layout_ == nullptr
+                         ? page->PackTuples(tuples, begin, txn, lock_manager_, log_manager_)
+                         : static_cast<PaxTablePage *>(page)->PackTuples(*pax_layout_, tuples, begin, txn,
+                                                                         lock_manager_, log_manager_);
+    BUSTUB_ASSERT(count > 0, "A tuple that is not too large fits into an empty page.");
+    // Fill in the zones before the page becomes visible, so that no scan skips it in the meantime.
+    if (zone_map_ != nullptr) {
+      zone_map_->AddPage(page_id, INVALID_PAGE_ID);
+      for (size_t i = begin; i < begin + count; i++) {
+        zone_map_->Insert(page_id, tuples[i]);
+      }
+    }
+    for (uint32_t slot = 0; slot < count; slot++) {
+      rids->emplace_back(page_id, slot);
+    }
+    new_page_ids.push_back(page_id);
+    tuple_counts.push_back(count);
+    insert_spaces.push_back(GetInsertSpace(page));
+    prev_page = page;
+    begin += count;
+  }
+  if (prev_page == nullptr) {
+    return true;
+  }
+  buffer_pool_manager_->UnpinPage(prev_page->GetTablePageId(), true);
+
+  // Link the whole chain after the last page at once.
+  auto last_page = FetchLastPage();
+  auto first_page = last_page == nullptr
+                        ? nullptr
+                        : static_cast<TablePage *>(buffer_pool_manager_->FetchPage(new_page_ids.front()));
+  if (first_page == nullptr) {
+    if (last_page != nullptr) {
+      last_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(last_page->GetTablePageId(), false);
+    }
+    return abandon();
+  }
+  first_page->SetPrevPageId(last_page->GetTablePageId());
+  buffer_pool_manager_->UnpinPage(first_page->GetTablePageId(), true);
+  last_page->SetNextPageId(new_page_ids.front());
+  for (size_t i = 0; i < new_page_ids.size(); i++) {
+    if (zone_map_ != nullptr) {
+      zone_map_->AddPage(new_page_ids[i], i == 0 ? last_page->GetTablePageId() : new_page_ids[i - 1]);
+    }
+    if (free_space_map_ != nullptr) {
+      free_space_map_->SetFreeSpace(new_page_ids[i], insert_spaces[i]);
+    }
+  }
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page->GetTablePageId(), true);
+
+  // Update the transaction's write set.
+  for (size_t i = 0; i < new_page_ids.size(); i++) {
+    txn->GetWriteSet()->emplace_back(RID(new_page_ids[i], tuple_counts[i]), WType::BULKINSERT, Tuple{}, this);
+  }
+  return true;
+}
+
+void TableHeap::RollbackBulkInsert(const RID &rid, Transaction *txn) {
+  // Other transactions may have inserted into the room left on the page since, so only the packed slots go.
+  for (uint32_t slot = 0; slot < rid.GetSlotNum(); slot++) {
+    ApplyDelete(RID(rid.GetPageId(), slot), txn);
+  }
+}
+
+bool TableHeap::InsertIntoPrivatePage(const Tuple &tuple, RID *rid, Transaction *txn) {
+  page_id_t page_id = INVALID_PAGE_ID;
+  {
+    std::scoped_lock latch{insert_pages_latch_};
+    auto iter = insert_pages_.find(txn->GetTransactionId());
+    if (iter != insert_pages_.end()) {
+      page_id = iter->second;
+    }
+  }
+
+  TablePage *page = nullptr;
+  if (page_id != INVALID_PAGE_ID) {
+    page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    page->WLatch();
+    if (!InsertIntoPage(page, tuple, rid, txn)) {
+      // The page is full, so it stops being private and its leftover room goes to everyone else.
+      {
+        std::scoped_lock latch{insert_pages_latch_};
+        insert_pages_.erase(txn->GetTransactionId());
+        private_page_ids_.erase(page_id);
+      }
+      free_space_map_->SetFreeSpace(page_id, GetInsertSpace(page));
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page = nullptr;
+    }
+  }
+  if (page == nullptr) {
+    page = AppendPage(txn, true);
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    bool inserted = InsertIntoPage(page, tuple, rid, txn);
+    BUSTUB_ASSERT(inserted, "A tuple that is not too large fits into an empty page.");
+  }
+
+  if (zone_map_ != nullptr) {
+    zone_map_->Insert(rid->GetPageId(), tuple);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  // Update the transaction's write set.
+  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  return true;
+}
+
+TablePage *TableHeap::FetchLastPage() {
+  // The free space map knows the last page, unless pages were linked behind its back; then follow the chain from it.
+  page_id_t last_page_id = free_space_map_ == nullptr ? INVALID_PAGE_ID : free_space_map_->GetLastPageId();
+  auto last_page = static_cast<TablePage *>(
+      buffer_pool_manager_->FetchPage(last_page_id == INVALID_PAGE_ID ? first_page_id_ : last_page_id));
+  if (last_page == nullptr) {
+    return nullptr;
+  }
+  last_page->WLatch();
+  while (last_page->GetNextPageId() != INVALID_PAGE_ID) {
+    auto next_page_id = last_page->GetNextPageId();
+    last_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(last_page->GetTablePageId(), false);
+    last_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    if (last_page == nullptr) {
+      return nullptr;
+    }
+    last_page->WLatch();
+  }
+  return last_page;
+}
+
+TablePage *TableHeap::AppendPage(Transaction *txn, bool is_private) {
+  auto last_page = FetchLastPage();
+  if (last_page == nullptr) {
+    return nullptr;
+  }
+
+  // The last page is only latched for as long as it takes to link the new page after it.
+  page_id_t new_page_id;
+  auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&new_page_id));
+  if (new_page != nullptr) {
+    new_page->WLatch();
+    if (zone_map_ != nullptr) {
+      zone_map_->AddPage(new_page_id, last_page->GetTablePageId());
+    }
+    last_page->SetNextPageId(new_page_id);
+    new_page->Init(new_page_id, PAGE_SIZE, last_page->GetTablePageId(), log_manager_, txn);
+    if (is_private) {
+      // The page is private before anyone can find it as the last page. As far as the free space map is concerned,
+      // it is full until its transaction releases it.
+      {
+        std::scoped_lock latch{insert_pages_latch_};
+        insert_pages_[txn->GetTransactionId()] = new_page_id;
+        private_page_ids_.insert(new_page_id);
+      }
+      free_space_map_->SetFreeSpace(new_page_id, 0);
+    } else if (free_space_map_ != nullptr) {
+      free_space_map_->SetFreeSpace(new_page_id, GetInsertSpace(new_page));
+    }
+  }
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page->GetTablePageId(), new_page != nullptr);
+  return new_page;
+}
+
+void TableHeap::ReleaseInsertPage(Transaction *txn) {
+  page_id_t page_id;
+  {
+    std::scoped_lock latch{insert_pages_latch_};
+    auto iter = insert_pages_.find(txn->GetTransactionId());
+    if (iter == insert_pages_.end()) {
+      return;
+    }
+    page_id = iter->second;
+    insert_pages_.erase(iter);
+    private_page_ids_.erase(page_id);
+  }
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    // The page stays full as far as the map is concerned, which only means that its room goes unused.
+    return;
+  }
+  page->RLatch();
+  free_space_map_->SetFreeSpace(page_id, GetInsertSpace(page));
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
 bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
@@ -120,7 +400,17 @@ bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
   page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  bool is_updated = pax_layout_ == nullptr
+                        ? page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_)
+                        : static_cast<PaxTablePage *>(page)->UpdateTuple(*pax_layout_, tuple, &old_tuple, rid, txn,
+                                                                         lock_manager_, log_manager_);
+  if (is_updated && zone_map_ != nullptr) {
+    zone_map_->Delete(rid.GetPageId(), old_tuple);
+    zone_map_->Insert(rid.GetPageId(), tuple);
+  }
+  if (is_updated) {
+    UpdateFreeSpace(page);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
   // Update the transaction's write set.
@@ -136,7 +426,17 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
   page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  Tuple deleted_tuple;
+  Tuple *zone_tuple = zone_map_ == nullptr ? nullptr : &deleted_tuple;
+  if (pax_layout_ == nullptr) {
+    page->ApplyDelete(rid, txn, log_manager_, zone_tuple);
+  } else {
+    static_cast<PaxTablePage *>(page)->ApplyDelete(*pax_layout_, rid, txn, log_manager_, zone_tuple);
+  }
+  if (zone_tuple != nullptr) {
+    zone_map_->Delete(rid.GetPageId(), deleted_tuple);
+  }
+  UpdateFreeSpace(page);
   lock_manager_->Unlock(txn, rid);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
@@ -163,24 +463,154 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   }
   // Read the tuple from the page.
   page->RLatch();
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  bool res = GetTupleFromPage(page, rid, tuple, true, txn);
   page->RUnlatch();
   buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
   return res;
 }
 
-TableIterator TableHeap::Begin(Transaction *txn) {
-  // Start an iterator from the first page.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+void TableHeap::GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  assert(page != nullptr);  // all pages are pinned
+  page->RLatch();
+  RID rid;
+  bool found = page->GetFirstTupleRid(&rid);
+  while (found) {
+    tuples->emplace_back(rid);
+    if (!GetTupleFromPage(page, rid, &tuples->back(), true, txn)) {
+      tuples->pop_back();
+    }
+    RID next_rid;
+    found = page->GetNextTupleRid(rid, &next_rid);
+    rid = next_rid;
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
+void TableHeap::GetTuples(const std::vector<RID> &rids, std::vector<Tuple> *tuples, Transaction *txn) {
+  for (size_t begin = 0, end = 0; begin < rids.size(); begin = end) {
+    page_id_t page_id = rids[begin].GetPageId();
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    assert(page != nullptr);  // all pages are pinned
+    page->RLatch();
+    for (end = begin; end < rids.size() && rids[end].GetPageId() == page_id; end++) {
+      tuples->emplace_back(rids[end]);
+      if (!GetTupleFromPage(page, rids[end], &tuples->back(), true, txn)) {
+        tuples->pop_back();
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+}
+
+bool TableHeap::ScanPage(page_id_t page_id, uint32_t *slot, const std::function<bool(const Tuple &)> &visitor,
+                         page_id_t *next_page_id, Transaction *txn) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  assert(page != nullptr);  // all pages are pinned
   page->RLatch();
   RID rid;
-  // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-  page->GetFirstTupleRid(&rid);
+  bool found = *slot == 0 ? page->GetFirstTupleRid(&rid) : page->GetNextTupleRid(RID(page_id, *slot - 1), &rid);
+  Tuple tuple;
+  while (found) {
+    bool stopped = GetTupleFromPage(page, rid, &tuple, false, txn) && !visitor(tuple);
+    *slot = rid.GetSlotNum() + 1;
+    RID next_rid;
+    found = page->GetNextTupleRid(rid, &next_rid);
+    rid = next_rid;
+    if (stopped) {
+      break;
+    }
+  }
+  bool done = !found;
+  if (done) {
+    *next_page_id = page->GetNextPageId();
+  }
   page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return done;
+}
+
+bool TableHeap::ScanColumns(page_id_t page_id, uint32_t *slot, const std::vector<uint32_t> &column_idxs,
+                            TupleBatch *batch, uint32_t limit, page_id_t *next_page_id, Transaction *txn) {
+  BUSTUB_ASSERT(pax_layout_ != nullptr, "Only PAX tables can be scanned column by column.");
+  auto page = static_cast<PaxTablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  assert(page != nullptr);  // all pages are pinned
+  page->RLatch();
+  bool done = page->ScanColumns(*pax_layout_, slot, column_idxs, batch, limit, txn, lock_manager_);
+  if (done) {
+    *next_page_id = page->GetNextPageId();
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return done;
+}
+
+TableIterator TableHeap::Begin(Transaction *txn) {
+  // Start an iterator from the first page with a tuple, since e.g. private insert pages can leave the first page empty.
+  RID rid;
+  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page->RLatch();
+    // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
+    bool found = page->GetFirstTupleRid(&rid);
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = found ? INVALID_PAGE_ID : next_page_id;
+  }
   return TableIterator(this, rid, txn);
 }
 
 TableIterator TableHeap::End() { return TableIterator(this, RID(INVALID_PAGE_ID, 0), nullptr); }
 
+bool TableHeap::GetTupleFromPage(TablePage *page, const RID &rid, Tuple *tuple, bool copy, Transaction *txn) {
+  if (pax_layout_ != nullptr) {
+    return static_cast<PaxTablePage *>(page)->GetTuple(*pax_layout_, rid, tuple, txn, lock_manager_);
+  }
+  return copy ? page->GetTuple(rid, tuple, txn, lock_manager_) : page->GetTupleView(rid, tuple, txn, lock_manager_);
+}
+
+bool TableHeap::InsertIntoPage(TablePage *page, const Tuple &tuple, RID *rid, Transaction *txn) {
+  return pax_layout_ == nullptr ? page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)
+                                : static_cast<PaxTablePage *>(page)->InsertTuple(*pax_layout_, tuple, rid, txn,
+                                                                                 lock_manager_, log_manager_);
+}
+
+uint32_t TableHeap::GetInsertSpace(TablePage *page) {
+  return pax_layout_ == nullptr ? page->GetInsertSpace()
+                                : static_cast<PaxTablePage *>(page)->GetInsertSpace(*pax_layout_);
+}
+
+bool TableHeap::IsPrivateInsertPage(page_id_t page_id) {
+  std::scoped_lock latch{insert_pages_latch_};
+  return private_page_ids_.count(page_id) != 0;
+}
+
+void TableHeap::UpdateFreeSpace(TablePage *page) {
+  // The room on a private insert page is published when its transaction releases it, not before.
+  if (free_space_map_ != nullptr && !IsPrivateInsertPage(page->GetTablePageId())) {
+    free_space_map_->SetFreeSpace(page->GetTablePageId(), GetInsertSpace(page));
+  }
+}
+
+bool TableHeap::FindInsertPage(uint32_t tuple_size, page_id_t *page_id) {
+  if (!free_space_map_->FindPage(tuple_size, page_id)) {
+    return false;
+  }
+  if (*page_id != INVALID_PAGE_ID) {
+    return true;
+  }
+  // Without a page with enough room, the insert tries the last page, which may not have been seen by the map yet,
+  // unless that is some transaction's private insert page.
+  *page_id = free_space_map_->GetLastPageId();
+  if (*page_id == INVALID_PAGE_ID) {
+    *page_id = first_page_id_;
+  } else if (IsPrivateInsertPage(*page_id)) {
+    *page_id = INVALID_PAGE_ID;
+  }
+  return true;
+}
+
 }  // namespace bustub
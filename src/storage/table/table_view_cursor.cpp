@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_view_cursor.cpp
+//
+// Identification: src/storage/table/table_view_cursor.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/table_view_cursor.h"
+
+#include <cassert>
+
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+TableViewCursor::TableViewCursor(TableHeap *table_heap, Transaction *txn)
+    : table_heap_(table_heap), txn_(txn), page_id_(table_heap->GetFirstPageId()) {}
+
+bool TableViewCursor::Next(TupleView *view) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  while (page_id_ != INVALID_PAGE_ID) {
+    if (page_ == nullptr) {
+      page_ = static_cast<TablePage *>(buffer_pool_manager->FetchPage(page_id_));
+      assert(page_ != nullptr);  // all pages are pinned
+      page_->RLatch();
+    }
+    RID rid;
+    bool found = slot_ == 0 ? page_->GetFirstTupleRid(&rid) : page_->GetNextTupleRid(RID(page_id_, slot_ - 1), &rid);
+    while (found) {
+      slot_ = rid.GetSlotNum() + 1;
+      if (table_heap_->GetTupleFromPage(page_, rid, &tuple_, false, txn_)) {
+        *view = TupleView(tuple_);
+        return true;
+      }
+      RID next_rid;
+      found = page_->GetNextTupleRid(rid, &next_rid);
+      rid = next_rid;
+    }
+    // Every tuple of this page has been produced, so no view points into it anymore.
+    page_id_t next_page_id = page_->GetNextPageId();
+    Release();
+    page_id_ = next_page_id;
+    slot_ = 0;
+  }
+  return false;
+}
+
+void TableViewCursor::Release() {
+  if (page_ != nullptr) {
+    page_->RUnlatch();
+    table_heap_->buffer_pool_manager_->UnpinPage(page_id_, false);
+    page_ = nullptr;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.cpp
+//
+// Identification: src/storage/table/tmp_tuple_run.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_run.h"
+
+#include <vector>
+
+#include "storage/page/tmp_tuple_page.h"
+
+namespace bustub {
+
+bool TmpTupleRun::Append(const Tuple &tuple) {
+  // Reject a tuple that is too large before it leaves an empty page behind.
+  if (!Fits(tuple)) {
+    return false;
+  }
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  // Try the last page of the run first.
+  if (!page_ids_.empty()) {
+    auto page = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_ids_.back()));
+    if (page == nullptr) {
+      return false;
+    }
+    bool inserted = page->Insert(tuple, &tmp_tuple);
+    bpm_->UnpinPage(page_ids_.back(), inserted);
+    if (inserted) {
+      tuple_count_++;
+      return true;
+    }
+  }
+  // Otherwise start a new page.
+  page_id_t page_id;
+  auto page = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+  if (page == nullptr) {
+    return false;
+  }
+  page->Init(page_id, PAGE_SIZE);
+  page_ids_.push_back(page_id);
+  page->Insert(tuple, &tmp_tuple);
+  bpm_->UnpinPage(page_id, true);
+  tuple_count_++;
+  return true;
+}
+
+bool TmpTupleRun::Fits(const Tuple &tuple) { return tuple.GetLength() <= TmpTuplePage::GetMaxTupleSize(); }
+
+void TmpTupleRun::ReadPage(size_t page_idx, std::vector<Tuple> *tuples) {
+  auto page = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_ids_[page_idx]));
+  BUSTUB_ASSERT(page != nullptr, "All pages are pinned.");
+  page->GetTuples(tuples);
+  bpm_->UnpinPage(page_ids_[page_idx], false);
+}
+
+void TmpTupleRun::Clear() {
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+  page_ids_.clear();
+  tuple_count_ = 0;
+}
+
+}  // namespace bustub
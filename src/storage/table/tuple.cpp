@@ -21,7 +21,7 @@
 namespace bustub {
 
 // TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
-Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true) {
+Tuple::Tuple(std::vector<Value> values, const Schema *schema, AbstractPool *pool) : allocated_(pool == nullptr) {
   assert(values.size() == schema->GetColumnCount());
 
   // 1. Calculate the size of the tuple.
@@ -32,7 +32,7 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
 
   // 2. Allocate memory.
   size_ = tuple_size;
-  data_ = new char[size_];
+  data_ = allocated_ ? new char[size_] : static_cast<char *>(pool->Allocate(size_));
   std::memset(data_, 0, size_);
 
   // 3. Serialize each attribute based on the input value.
@@ -111,6 +111,16 @@ const char *Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) c
   return (data_ + offset);
 }
 
+Tuple Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema,
+                          const std::vector<uint32_t> &key_attrs) const {
+  std::vector<Value> values;
+  values.reserve(key_attrs.size());
+  for (auto idx : key_attrs) {
+    values.emplace_back(GetValue(&schema, idx));
+  }
+  return Tuple(values, &key_schema);
+}
+
 std::string Tuple::ToString(const Schema *schema) const {
   std::stringstream os;
 
@@ -153,4 +163,14 @@ void Tuple::DeserializeFrom(const char *storage) {
   this->allocated_ = true;
 }
 
+void Tuple::MakeOwned() {
+  if (allocated_ || data_ == nullptr) {
+    return;
+  }
+  char *data = new char[size_];
+  memcpy(data, data_, size_);
+  data_ = data;
+  allocated_ = true;
+}
+
 }  // namespace bustub
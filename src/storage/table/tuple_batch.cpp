@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/storage/table/tuple_batch.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tuple_batch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace bustub {
+
+ColumnVector::ColumnVector(TypeId type_id, uint32_t capacity)
+    : type_id_(type_id), width_(static_cast<uint32_t>(Type::GetTypeSize(type_id))) {
+  if (IsInlined()) {
+    data_.resize(static_cast<size_t>(width_) * capacity);
+  } else {
+    varlen_.resize(capacity);
+  }
+}
+
+Value ColumnVector::GetValue(uint32_t idx) const {
+  if (!IsInlined()) {
+    return varlen_[idx];
+  }
+  return Value::DeserializeFrom(data_.data() + idx * width_, type_id_);
+}
+
+void ColumnVector::SetValue(uint32_t idx, const Value &val) {
+  if (!IsInlined()) {
+    varlen_[idx] = val;
+    return;
+  }
+  // Serialized values have the width of their own type, so make sure that matches the column.
+  if (val.GetTypeId() != type_id_) {
+    val.CastAs(type_id_).SerializeTo(data_.data() + idx * width_);
+  } else {
+    val.SerializeTo(data_.data() + idx * width_);
+  }
+}
+
+TupleBatch::TupleBatch(const Schema *schema, uint32_t capacity) : schema_(schema), capacity_(capacity) {
+  columns_.reserve(schema_->GetColumnCount());
+  for (const auto &col : schema_->GetColumns()) {
+    columns_.emplace_back(col.GetType(), capacity_);
+  }
+  rids_.resize(capacity_);
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple) {
+  assert(!IsFull());
+  uint32_t column_count = schema_->GetColumnCount();
+  for (uint32_t i = 0; i < column_count; i++) {
+    const auto &col = schema_->GetColumn(i);
+    if (col.IsInlined()) {
+      // Inlined values are stored in the tuple exactly as the column vector stores them.
+      columns_[i].SetRaw(size_, tuple.GetData() + col.GetOffset());
+    } else {
+      columns_[i].SetValue(size_, tuple.GetValue(schema_, i));
+    }
+  }
+  rids_[size_] = tuple.GetRid();
+  size_++;
+}
+
+void TupleBatch::AppendValues(const std::vector<Value> &values, RID rid) {
+  assert(!IsFull());
+  assert(values.size() == schema_->GetColumnCount());
+  for (uint32_t i = 0; i < values.size(); i++) {
+    columns_[i].SetValue(size_, values[i]);
+  }
+  rids_[size_] = rid;
+  size_++;
+}
+
+void TupleBatch::AppendRow(const TupleBatch &other, uint32_t row_idx) {
+  assert(!IsFull());
+  assert(other.columns_.size() == columns_.size());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    const auto &src = other.columns_[i];
+    if (src.IsInlined()) {
+      columns_[i].SetRaw(size_, src.GetData<char>() + row_idx * src.GetWidth());
+    } else {
+      columns_[i].SetValue(size_, src.GetValue(row_idx));
+    }
+  }
+  rids_[size_] = other.rids_[row_idx];
+  size_++;
+}
+
+void TupleBatch::AppendRows(const std::vector<RID> &rids) {
+  assert(size_ + rids.size() <= capacity_);
+  std::copy(rids.begin(), rids.end(), rids_.begin() + size_);
+  size_ += rids.size();
+}
+
+std::vector<Value> TupleBatch::GetValues(uint32_t row_idx) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.emplace_back(column.GetValue(row_idx));
+  }
+  return values;
+}
+
+}  // namespace bustub
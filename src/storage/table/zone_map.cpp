@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+namespace bustub {
+
+ZoneMap::ZoneMap(const Schema &schema) : schema_(schema) {}
+
+void ZoneMap::AddPage(page_id_t page_id, page_id_t prev_page_id) {
+  std::scoped_lock latch{latch_};
+  auto &page = zones_[page_id];
+  if (page.columns_.empty()) {
+    for (const auto &col : schema_.GetColumns()) {
+      page.columns_.push_back(ColumnZone{Value(col.GetType()), Value(col.GetType())});
+    }
+  }
+  if (prev_page_id != INVALID_PAGE_ID) {
+    page.next_page_id_ = zones_[prev_page_id].next_page_id_;
+    zones_[prev_page_id].next_page_id_ = page_id;
+  }
+}
+
+void ZoneMap::Insert(page_id_t page_id, const Tuple &tuple) {
+  // Deserialize the values before taking the latch.
+  std::vector<Value> values;
+  values.reserve(schema_.GetColumnCount());
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    values.push_back(tuple.GetValue(&schema_, i));
+  }
+  std::scoped_lock latch{latch_};
+  auto &columns = zones_[page_id].columns_;
+  for (uint32_t i = 0; i < values.size(); i++) {
+    ColumnZone &zone = columns[i];
+    zone.tuple_count_++;
+    if (values[i].IsNull()) {
+      zone.null_count_++;
+      continue;
+    }
+    if (zone.min_.IsNull() || values[i].CompareLessThan(zone.min_) == CmpBool::CmpTrue) {
+      zone.min_ = values[i];
+    }
+    if (zone.max_.IsNull() || values[i].CompareGreaterThan(zone.max_) == CmpBool::CmpTrue) {
+      zone.max_ = std::move(values[i]);
+    }
+  }
+}
+
+void ZoneMap::Delete(page_id_t page_id, const Tuple &tuple) {
+  std::vector<bool> nulls;
+  nulls.reserve(schema_.GetColumnCount());
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    nulls.push_back(tuple.IsNull(&schema_, i));
+  }
+  std::scoped_lock latch{latch_};
+  auto &columns = zones_[page_id].columns_;
+  for (uint32_t i = 0; i < nulls.size(); i++) {
+    ColumnZone &zone = columns[i];
+    zone.tuple_count_--;
+    zone.null_count_ -= nulls[i] ? 1 : 0;
+    // The bounds cannot be narrowed without looking at the rest of the page, except once the page is empty.
+    if (zone.tuple_count_ == 0) {
+      zone.min_ = Value(zone.min_.GetTypeId());
+      zone.max_ = Value(zone.max_.GetTypeId());
+    }
+  }
+}
+
+bool ZoneMap::GetZone(page_id_t page_id, uint32_t col_idx, ColumnZone *zone, page_id_t *next_page_id) const {
+  std::scoped_lock latch{latch_};
+  auto iter = zones_.find(page_id);
+  if (iter == zones_.end()) {
+    return false;
+  }
+  *zone = iter->second.columns_[col_idx];
+  *next_page_id = iter->second.next_page_id_;
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.cpp
+//
+// Identification: src/type/arena_pool.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/arena_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace bustub {
+
+void *ArenaPool::Allocate(size_t size) {
+  constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+  size = (std::max<size_t>(size, 1) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  allocated_bytes_ += size;
+  if (size > chunk_size_ / 4) {
+    // Large allocations get a chunk of their own, so that they do not waste the rest of the current chunk.
+    return NewChunk(size);
+  }
+  if (static_cast<size_t>(end_ - cursor_) < size) {
+    current_chunk_ = NewChunk(chunk_size_);
+    cursor_ = current_chunk_;
+    end_ = current_chunk_ + chunk_size_;
+  }
+  void *result = cursor_;
+  cursor_ += size;
+  return result;
+}
+
+void ArenaPool::Reset() {
+  allocated_bytes_ = 0;
+  // Keep the current regular chunk and allocate from its start again.
+  std::unique_ptr<char[]> current;
+  for (auto &chunk : chunks_) {
+    if (chunk.get() == current_chunk_) {
+      current = std::move(chunk);
+    }
+  }
+  chunks_.clear();
+  cursor_ = current_chunk_;
+  if (current != nullptr) {
+    chunks_.push_back(std::move(current));
+  }
+}
+
+char *ArenaPool::NewChunk(size_t size) {
+  // new char[] is aligned for any fundamental type, and so is every rounded up allocation within the chunk.
+  chunks_.emplace_back(new char[size]);
+  return chunks_.back().get();
+}
+
+}  // namespace bustub
@@ -18,34 +18,19 @@
 #include "type/value.h"
 
 namespace bustub {
-Value::Value(const Value &other) {
-  type_id_ = other.type_id_;
-  size_ = other.size_;
-  manage_data_ = other.manage_data_;
-  value_ = other.value_;
-  switch (type_id_) {
-    case TypeId::VARCHAR:
-      if (size_.len_ == BUSTUB_VALUE_NULL) {
-        value_.varlen_ = nullptr;
-      } else {
-        if (manage_data_) {
-          value_.varlen_ = new char[size_.len_];
-          memcpy(value_.varlen_, other.value_.varlen_, size_.len_);
-        } else {
-          value_ = other.value_;
-        }
-      }
-      break;
-    default:
-      value_ = other.value_;
+void Value::CopyVarlen(const char *data, uint32_t len) {
+  assert(len < BUSTUB_VARCHAR_MAX_LEN);
+  size_.len_ = len;
+  if (len <= VARLEN_INLINE_SIZE) {
+    storage_ = VarlenStorage::Inline;
+    memcpy(value_.inline_, data, len);
+  } else {
+    storage_ = VarlenStorage::Owned;
+    value_.varlen_ = new char[len];
+    memcpy(value_.varlen_, data, len);
   }
 }
 
-Value &Value::operator=(Value other) {
-  Swap(*this, other);
-  return *this;
-}
-
 // BOOLEAN and TINYINT
 Value::Value(TypeId type, int8_t i) : Value(type) {
   switch (type) {
@@ -218,13 +203,8 @@ Value::Value(TypeId type, const char *data, uint32_t len, bool manage_data) : Va
         value_.varlen_ = nullptr;
         size_.len_ = BUSTUB_VALUE_NULL;
       } else {
-        manage_data_ = manage_data;
-        if (manage_data_) {
-          assert(len < BUSTUB_VARCHAR_MAX_LEN);
-          value_.varlen_ = new char[len];
-          assert(value_.varlen_ != nullptr);
-          size_.len_ = len;
-          memcpy(value_.varlen_, data, len);
+        if (manage_data) {
+          CopyVarlen(data, len);
         } else {
           // FUCK YOU GCC I do what I want.
           value_.const_varlen_ = data;
@@ -240,13 +220,8 @@ Value::Value(TypeId type, const char *data, uint32_t len, bool manage_data) : Va
 Value::Value(TypeId type, const std::string &data) : Value(type) {
   switch (type) {
     case TypeId::VARCHAR: {
-      manage_data_ = true;
       // TODO(TAs): How to represent a null string here?
-      uint32_t len = static_cast<uint32_t>(data.length()) + 1;
-      value_.varlen_ = new char[len];
-      assert(value_.varlen_ != nullptr);
-      size_.len_ = len;
-      memcpy(value_.varlen_, data.c_str(), len);
+      CopyVarlen(data.c_str(), static_cast<uint32_t>(data.length()) + 1);
       break;
     }
     default:
@@ -254,19 +229,6 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
   }
 }
 
-// delete allocated char array space
-Value::~Value() {
-  switch (type_id_) {
-    case TypeId::VARCHAR:
-      if (manage_data_) {
-        delete[] value_.varlen_;
-      }
-      break;
-    default:
-      break;
-  }
-}
-
 bool Value::CheckComparable(const Value &o) const {
   switch (GetTypeId()) {
     case TypeId::BOOLEAN:
@@ -41,7 +41,7 @@ VarlenType::VarlenType(TypeId type) : Type(type) {}
 VarlenType::~VarlenType() = default;
 
 // Access the raw variable length data
-const char *VarlenType::GetData(const Value &val) const { return val.value_.varlen_; }
+const char *VarlenType::GetData(const Value &val) const { return val.VarlenData(); }
 
 // Get the length of the variable length data (including the length field)
 uint32_t VarlenType::GetLength(const Value &val) const { return val.size_.len_; }
@@ -162,7 +162,7 @@ void VarlenType::SerializeTo(const Value &val, char *storage) const {
     return;
   }
   memcpy(storage, &len, sizeof(uint32_t));
-  memcpy(storage + sizeof(uint32_t), val.value_.varlen_, len);
+  memcpy(storage + sizeof(uint32_t), val.VarlenData(), len);
 }
 
 // Deserialize a value of the given type from the given storage space.
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** The byte-at-a-time hash that HashUtil::HashBytes used to be, kept around as a benchmark baseline. */
+static hash_t LegacyHashBytes(const char *bytes, size_t length) {
+  hash_t hash = length;
+  for (size_t i = 0; i < length; ++i) {
+    hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  }
+  return hash;
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashBytesTest) {
+  std::string data(128, '\0');
+  std::mt19937 generator(15445);
+  for (auto &c : data) {
+    c = static_cast<char>(generator());
+  }
+
+  for (size_t len = 0; len <= data.size(); len++) {
+    // Hashing is deterministic and only depends on the bytes themselves, not on their address.
+    std::string copy = data.substr(0, len);
+    ASSERT_EQ(HashUtil::HashBytes(data.data(), len), HashUtil::HashBytes(copy.data(), len));
+    // Every byte of the key contributes to the hash.
+    for (size_t i = 0; i < len; i++) {
+      std::string flipped = copy;
+      flipped[i] ^= 0x1;
+      ASSERT_NE(HashUtil::HashBytes(copy.data(), len), HashUtil::HashBytes(flipped.data(), len));
+    }
+  }
+
+  // Prefixes of the same buffer hash differently.
+  std::unordered_set<hash_t> seen;
+  for (size_t len = 0; len <= data.size(); len++) {
+    seen.insert(HashUtil::HashBytes(data.data(), len));
+  }
+  ASSERT_EQ(seen.size(), data.size() + 1);
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashValueTest) {
+  // Integers of different widths that hold the same number hash the same.
+  Value tiny = ValueFactory::GetTinyIntValue(42);
+  Value small = ValueFactory::GetSmallIntValue(42);
+  Value integer = ValueFactory::GetIntegerValue(42);
+  Value big = ValueFactory::GetBigIntValue(42);
+  ASSERT_EQ(HashUtil::HashValue(&tiny), HashUtil::HashValue(&integer));
+  ASSERT_EQ(HashUtil::HashValue(&small), HashUtil::HashValue(&integer));
+  ASSERT_EQ(HashUtil::HashValue(&big), HashUtil::HashValue(&integer));
+
+  Value str1 = ValueFactory::GetVarcharValue("bustub");
+  Value str2 = ValueFactory::GetVarcharValue(std::string("bustub"));
+  Value str3 = ValueFactory::GetVarcharValue("bustun");
+  ASSERT_EQ(HashUtil::HashValue(&str1), HashUtil::HashValue(&str2));
+  ASSERT_NE(HashUtil::HashValue(&str1), HashUtil::HashValue(&str3));
+
+  // Serial integers should not collide, and should spread over the low bits that hash tables use for bucketing.
+  std::unordered_set<hash_t> hashes;
+  std::vector<uint32_t> buckets(64, 0);
+  for (int32_t i = 0; i < 64 * 1024; i++) {
+    Value val = ValueFactory::GetIntegerValue(i);
+    hash_t h = HashUtil::HashValue(&val);
+    hashes.insert(h);
+    buckets[h % buckets.size()]++;
+  }
+  ASSERT_EQ(hashes.size(), 64 * 1024);
+  for (auto count : buckets) {
+    ASSERT_GT(count, 1024 / 2);
+    ASSERT_LT(count, 1024 * 2);
+  }
+
+  // Combining is order-dependent.
+  ASSERT_NE(HashUtil::CombineHashes(1, 2), HashUtil::CombineHashes(2, 1));
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, DISABLED_HashBytesBenchmark) {
+  constexpr size_t num_keys = 1 << 16;
+  constexpr size_t num_rounds = 64;
+  std::mt19937 generator(15445);
+
+  for (size_t key_size : {4, 8, 12, 16, 24, 32, 48, 64}) {
+    std::vector<char> keys(num_keys * key_size);
+    for (auto &c : keys) {
+      c = static_cast<char>(generator());
+    }
+
+    auto run = [&](hash_t (*hash_fn)(const char *, size_t)) {
+      hash_t sink = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t round = 0; round < num_rounds; round++) {
+        for (size_t i = 0; i < num_keys; i++) {
+          sink ^= hash_fn(keys.data() + i * key_size, key_size);
+        }
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      // Keep the compiler from optimizing the loop away.
+      EXPECT_NE(sink, 1);
+      return static_cast<double>(num_keys * num_rounds * key_size) / elapsed.count() / (1 << 20);
+    };
+
+    double legacy = run(LegacyHashBytes);
+    double current = run(HashUtil::HashBytes);
+    printf("key size %2zu: legacy %8.1f MB/s, current %8.1f MB/s, speedup %.2fx\n", key_size, legacy, current,
+           current / legacy);
+  }
+}
+
+}  // namespace bustub
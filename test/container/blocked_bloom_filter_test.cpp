@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// blocked_bloom_filter_test.cpp
+//
+// Identification: test/container/blocked_bloom_filter_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/blocked_bloom_filter.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BlockedBloomFilterTest, SampleTest) {
+  constexpr uint64_t num_keys = 10000;
+  BlockedBloomFilter filter(num_keys);
+  ASSERT_EQ(filter.GetNumBlocks(), (num_keys * 16 + 255) / 256);
+  ASSERT_FALSE(filter.MayContain(HashUtil::HashWord(0)));
+
+  for (uint64_t i = 0; i < num_keys; i++) {
+    filter.Insert(HashUtil::HashWord(i));
+  }
+
+  // No false negatives.
+  for (uint64_t i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(filter.MayContain(HashUtil::HashWord(i)));
+  }
+
+  // Few false positives.
+  uint64_t false_positives = 0;
+  for (uint64_t i = num_keys; i < 11 * num_keys; i++) {
+    false_positives += filter.MayContain(HashUtil::HashWord(i)) ? 1 : 0;
+  }
+  ASSERT_LT(false_positives, 10 * num_keys / 100);
+}
+
+}  // namespace bustub
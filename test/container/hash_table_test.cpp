@@ -13,6 +13,7 @@
 #include <thread>  // NOLINT
 #include <vector>
 
+#include "common/exception.h"
 #include "common/logger.h"
 #include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
@@ -104,4 +105,57 @@ TEST(HashTableTest, SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, ResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+
+  // insert more values than a single block holds, the table has to grow
+  int num_values = static_cast<int>(4 * initial_size);
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GE(ht.GetSize(), static_cast<size_t>(num_values));
+  EXPECT_FALSE(ht.Insert(nullptr, 0, 0));
+
+  // every value survives the resizes
+  for (int i = 0; i < num_values; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(std::vector<int>{i}, res);
+  }
+
+  // Without free frames for the pages of a larger table, resizing leaves the table as it was, and no table is created.
+  size_t size = ht.GetSize();
+  std::vector<page_id_t> pinned_page_ids;
+  page_id_t page_id;
+  while (bpm->NewPage(&page_id) != nullptr) {
+    pinned_page_ids.push_back(page_id);
+  }
+  EXPECT_FALSE(ht.Resize(size));
+  using IntHashTable = LinearProbeHashTable<int, int, IntComparator>;
+  EXPECT_THROW(IntHashTable("blah2", bpm, IntComparator(), 1, HashFunction<int>()), Exception);
+  // One free frame is enough for the header page, but not for a block page as well.
+  bpm->UnpinPage(pinned_page_ids.back(), false);
+  EXPECT_FALSE(ht.Resize(size));
+  ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+  pinned_page_ids.back() = page_id;
+  for (auto id : pinned_page_ids) {
+    bpm->UnpinPage(id, false);
+  }
+  EXPECT_EQ(ht.GetSize(), size);
+  for (int i = 0; i < num_values; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(std::vector<int>{i}, res);
+  }
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
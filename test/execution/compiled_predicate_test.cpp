@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate_test.cpp
+//
+// Identification: test/execution/compiled_predicate_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "execution/compiled_predicate.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class CompiledPredicateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    schema_ = std::make_unique<Schema>(std::vector<Column>{
+        Column("bool", TypeId::BOOLEAN), Column("tiny", TypeId::TINYINT), Column("small", TypeId::SMALLINT),
+        Column("int1", TypeId::INTEGER), Column("int2", TypeId::INTEGER), Column("big", TypeId::BIGINT),
+        Column("dec", TypeId::DECIMAL), Column("str", TypeId::VARCHAR, 8)});
+    batch_ = std::make_unique<TupleBatch>(schema_.get());
+    // Small value ranges make equal values common, and every column has some NULLs.
+    std::mt19937 generator(0);
+    auto next = [&]() { return static_cast<int>(generator() % 8) - 4; };
+    for (uint32_t row = 0; row < 500; row++) {
+      std::vector<Value> values{ValueFactory::GetBooleanValue(next() < 0),
+                                ValueFactory::GetTinyIntValue(next()),
+                                ValueFactory::GetSmallIntValue(next()),
+                                ValueFactory::GetIntegerValue(next()),
+                                ValueFactory::GetIntegerValue(next()),
+                                ValueFactory::GetBigIntValue(next()),
+                                ValueFactory::GetDecimalValue(next() / 2.0),
+                                ValueFactory::GetVarcharValue("abc")};
+      for (uint32_t i = 0; i + 1 < values.size(); i++) {
+        if (generator() % 10 == 0) {
+          values[i] = ValueFactory::GetNullValueByType(values[i].GetTypeId());
+        }
+      }
+      batch_->AppendValues(values);
+    }
+  }
+
+  const AbstractExpression *ColumnRef(uint32_t col_idx) {
+    return Own(std::make_unique<ColumnValueExpression>(0, col_idx, schema_->GetColumn(col_idx).GetType()));
+  }
+
+  const AbstractExpression *Constant(const Value &value) {
+    return Own(std::make_unique<ConstantValueExpression>(value));
+  }
+
+  const AbstractExpression *Compare(const AbstractExpression *left, ComparisonType type,
+                                    const AbstractExpression *right) {
+    return Own(std::make_unique<ComparisonExpression>(left, right, type));
+  }
+
+  const AbstractExpression *Own(std::unique_ptr<AbstractExpression> &&expr) {
+    exprs_.emplace_back(std::move(expr));
+    return exprs_.back().get();
+  }
+
+  /** Checks that the compiled predicate selects exactly the rows that the interpreted predicate accepts. */
+  void ExpectSameAsInterpreted(const AbstractExpression *predicate) {
+    auto compiled = CompiledPredicate::Compile(predicate, schema_.get());
+    ASSERT_NE(compiled, nullptr);
+    std::vector<uint32_t> expected;
+    for (uint32_t row = 0; row < batch_->GetSize(); row++) {
+      if (predicate->EvaluateAt(batch_.get(), row).GetAs<bool>()) {
+        expected.push_back(row);
+      }
+    }
+    std::vector<uint32_t> sel;
+    compiled->Filter(*batch_, &sel);
+    ASSERT_EQ(sel, expected);
+  }
+
+  std::unique_ptr<Schema> schema_;
+  std::unique_ptr<TupleBatch> batch_;
+  std::vector<std::unique_ptr<AbstractExpression>> exprs_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(CompiledPredicateTest, KernelTest) {
+  std::vector<Value> constants{ValueFactory::GetBooleanValue(true), ValueFactory::GetTinyIntValue(1),
+                               ValueFactory::GetSmallIntValue(-2), ValueFactory::GetIntegerValue(0),
+                               ValueFactory::GetIntegerValue(3), ValueFactory::GetBigIntValue(-1),
+                               ValueFactory::GetDecimalValue(0.5)};
+  for (auto type : {ComparisonType::Equal, ComparisonType::NotEqual, ComparisonType::LessThan,
+                    ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan,
+                    ComparisonType::GreaterThanOrEqual}) {
+    for (uint32_t col_idx = 0; col_idx < constants.size(); col_idx++) {
+      // column op constant, constant op column and column op column
+      ExpectSameAsInterpreted(Compare(ColumnRef(col_idx), type, Constant(constants[col_idx])));
+      ExpectSameAsInterpreted(Compare(Constant(constants[col_idx]), type, ColumnRef(col_idx)));
+      ExpectSameAsInterpreted(Compare(ColumnRef(col_idx), type, ColumnRef(col_idx)));
+    }
+    ExpectSameAsInterpreted(Compare(ColumnRef(3), type, ColumnRef(4)));
+    // Integer constants of another type are converted to the column type.
+    ExpectSameAsInterpreted(Compare(ColumnRef(2), type, Constant(ValueFactory::GetIntegerValue(1))));
+    ExpectSameAsInterpreted(Compare(Constant(ValueFactory::GetBigIntValue(-3)), type, ColumnRef(1)));
+    // Comparisons of comparisons, whose NULL results have to be propagated as well.
+    ExpectSameAsInterpreted(Compare(Compare(ColumnRef(3), ComparisonType::LessThan, ColumnRef(4)), type,
+                                    Compare(ColumnRef(5), ComparisonType::GreaterThan, Constant(constants[5]))));
+    ExpectSameAsInterpreted(Compare(Compare(ColumnRef(6), type, Constant(constants[6])), ComparisonType::Equal,
+                                    Constant(ValueFactory::GetBooleanValue(false))));
+  }
+  ExpectSameAsInterpreted(ColumnRef(0));
+  ExpectSameAsInterpreted(Constant(ValueFactory::GetBooleanValue(true)));
+  ExpectSameAsInterpreted(Constant(ValueFactory::GetBooleanValue(false)));
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompiledPredicateTest, UnsupportedTest) {
+  // VARCHAR values, different types and constants that do not fit the other side's type are left to the interpreter.
+  const Schema *schema = schema_.get();
+  auto str = ValueFactory::GetVarcharValue("abc");
+  auto decimal = ValueFactory::GetDecimalValue(1);
+  auto too_large = ValueFactory::GetIntegerValue(1000);
+  EXPECT_EQ(CompiledPredicate::Compile(Compare(ColumnRef(7), ComparisonType::Equal, Constant(str)), schema), nullptr);
+  EXPECT_EQ(CompiledPredicate::Compile(Compare(ColumnRef(3), ComparisonType::Equal, ColumnRef(5)), schema), nullptr);
+  EXPECT_EQ(CompiledPredicate::Compile(Compare(ColumnRef(3), ComparisonType::Equal, Constant(decimal)), schema),
+            nullptr);
+  EXPECT_EQ(CompiledPredicate::Compile(Compare(ColumnRef(1), ComparisonType::Equal, Constant(too_large)), schema),
+            nullptr);
+  EXPECT_EQ(CompiledPredicate::Compile(ColumnRef(3), schema), nullptr);
+}
+
+}  // namespace bustub
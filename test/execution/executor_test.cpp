@@ -10,9 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -29,7 +32,11 @@
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/join_key.h"
+#include "execution/plans/index_nested_loop_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
 #include "gtest/gtest.h"
 #include "type/value_factory.h"
 
@@ -66,6 +73,9 @@ class ExecutorTest : public ::testing::Test {
   /** @return the executor context in our test class */
   ExecutorContext *GetExecutorContext() { return exec_ctx_.get(); }
 
+  /** @return the transaction manager in our test class */
+  TransactionManager *GetTxnManager() { return txn_mgr_.get(); }
+
   // The below helper functions are useful for testing.
 
   const AbstractExpression *MakeColumnValueExpression(const Schema &schema, uint32_t tuple_idx,
@@ -148,6 +158,83 @@ TEST_F(ExecutorTest, SimpleSeqScanTest) {
   ASSERT_EQ(num_tuples, 500);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleSeqScanBatchTest) {
+  // SELECT colA, colB FROM test_1 WHERE colA < 500, a batch at a time
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto *predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  executor->Init();
+  TupleBatch batch(out_schema, 128);
+  uint32_t num_tuples = 0;
+  while (executor->NextBatch(&batch)) {
+    ASSERT_LE(batch.GetSize(), 128);
+    // Fixed-width columns can be read straight out of the column vectors.
+    const auto *col_a = batch.GetColumn(out_schema->GetColIdx("colA")).GetData<int32_t>();
+    const auto *col_b = batch.GetColumn(out_schema->GetColIdx("colB")).GetData<int32_t>();
+    for (uint32_t i = 0; i < batch.GetSize(); i++) {
+      ASSERT_EQ(col_a[i], num_tuples);
+      ASSERT_TRUE(col_b[i] < 10);
+      ASSERT_EQ(batch.GetValue(i, out_schema->GetColIdx("colA")).GetAs<int32_t>(), col_a[i]);
+      num_tuples++;
+    }
+  }
+  ASSERT_EQ(num_tuples, 500);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  // SELECT colA, colB FROM test_1 WHERE colA < 500, scanned by four workers
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto *predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  GetExecutorContext()->SetDegreeOfParallelism(4);
+
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  // The workers produce tuples in no particular order, but every qualifying tuple exactly once.
+  std::vector<bool> seen(500, false);
+  executor->Init();
+  TupleBatch batch(out_schema, 100);
+  while (executor->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.GetSize(); i++) {
+      auto a = batch.GetValue(i, out_schema->GetColIdx("colA")).GetAs<int32_t>();
+      ASSERT_LT(a, 500);
+      ASSERT_FALSE(seen[a]);
+      seen[a] = true;
+    }
+  }
+  ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 500);
+
+  // Same again, a tuple at a time.
+  std::fill(seen.begin(), seen.end(), false);
+  executor->Init();
+  Tuple tuple;
+  while (executor->Next(&tuple)) {
+    auto a = tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>();
+    ASSERT_LT(a, 500);
+    ASSERT_FALSE(seen[a]);
+    seen[a] = true;
+  }
+  ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 500);
+
+  // Abandoning a scan halfway must not leave the workers hanging.
+  executor->Init();
+  ASSERT_TRUE(executor->Next(&tuple));
+  executor.reset();
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleRawInsertTest) {
   // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
@@ -196,6 +283,38 @@ TEST_F(ExecutorTest, SimpleRawInsertTest) {
   ASSERT_FALSE(scan_executor->Next(&tuple));
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, RepeatedRawInsertTest) {
+  // INSERT INTO empty_table2 VALUES (i, i * 10), run once for every i
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("empty_table2");
+  const int32_t num_inserts = 100;
+  for (int32_t i = 0; i < num_inserts; i++) {
+    std::vector<std::vector<Value>> raw_vals{{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i * 10)}};
+    InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+    auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+    insert_executor->Init();
+    ASSERT_TRUE(insert_executor->Next(nullptr));
+  }
+
+  // Small inserts fill up the existing page rather than starting a new page each.
+  auto *bpm = GetExecutorContext()->GetBufferPoolManager();
+  size_t num_pages = 0;
+  for (page_id_t page_id = table_info->table_->GetFirstPageId(); page_id != INVALID_PAGE_ID; num_pages++) {
+    auto page = static_cast<TablePage *>(bpm->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT_EQ(num_pages, 1);
+  size_t num_tuples = 0;
+  for (auto iter = table_info->table_->Begin(GetExecutorContext()->GetTransaction()); iter != table_info->table_->End();
+       ++iter) {
+    ASSERT_EQ(iter->GetValue(&table_info->schema_, 0).GetAs<int32_t>(), static_cast<int32_t>(num_tuples));
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, num_inserts);
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleSelectInsertTest) {
   // INSERT INTO empty_table2 SELECT colA, colB FROM test_1 WHERE colA < 500
@@ -253,6 +372,102 @@ TEST_F(ExecutorTest, SimpleSelectInsertTest) {
   ASSERT_EQ(num_tuples, 500);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleSelectInsertBatchTest) {
+  // INSERT INTO empty_table2 SELECT colA, colB FROM test_1 WHERE colA < 500, a batch at a time
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    auto const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+    auto predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+    auto out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, predicate, table_info->oid_);
+  }
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("empty_table2");
+  InsertPlanNode insert_plan{scan_plan1.get(), table_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->NextBatch(nullptr));
+
+  // SELECT colA, colB FROM empty_table2, through the tuple-at-a-time adapter of the aggregation's child.
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *scan_schema;
+  {
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> agg_plan;
+  const Schema *agg_schema;
+  {
+    const AbstractExpression *colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    const AbstractExpression *countA = MakeAggregateValueExpression(false, 0);
+    const AbstractExpression *maxA = MakeAggregateValueExpression(false, 1);
+    agg_schema = MakeOutputSchema({{"countA", countA}, {"maxA", maxA}});
+    agg_plan = std::make_unique<AggregationPlanNode>(
+        agg_schema, scan_plan2.get(), nullptr, std::vector<const AbstractExpression *>{},
+        std::vector<const AbstractExpression *>{colA, colA},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::MaxAggregate});
+  }
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), agg_plan.get());
+  executor->Init();
+  TupleBatch batch(agg_schema);
+  ASSERT_TRUE(executor->NextBatch(&batch));
+  ASSERT_EQ(batch.GetSize(), 1);
+  ASSERT_EQ(batch.GetValue(0, agg_schema->GetColIdx("countA")).GetAs<int32_t>(), 500);
+  ASSERT_EQ(batch.GetValue(0, agg_schema->GetColIdx("maxA")).GetAs<int32_t>(), 499);
+  ASSERT_FALSE(executor->NextBatch(&batch));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SelfInsertTest) {
+  // INSERT INTO empty_table2 SELECT * FROM empty_table2, on a table of more than one batch and more than one page
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("empty_table2");
+  const int32_t num_rows = 1100;
+  std::vector<std::vector<Value>> raw_vals;
+  for (int32_t i = 0; i < num_rows; i++) {
+    raw_vals.push_back({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i * 10)});
+  }
+  InsertPlanNode raw_insert_plan{std::move(raw_vals), table_info->oid_};
+  auto raw_insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &raw_insert_plan);
+  raw_insert_executor->Init();
+  ASSERT_TRUE(raw_insert_executor->Next(nullptr));
+
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  InsertPlanNode insert_plan{&scan_plan, table_info->oid_};
+
+  // Every row is copied once per insert, and none of the copies is copied again by the same insert.
+  auto check_copies = [&](int32_t num_copies) {
+    std::vector<int32_t> seen(num_rows, 0);
+    size_t num_tuples = 0;
+    for (auto iter = table_info->table_->Begin(GetExecutorContext()->GetTransaction());
+         iter != table_info->table_->End(); ++iter) {
+      auto col_a = iter->GetValue(&schema, 0).GetAs<int32_t>();
+      ASSERT_EQ(iter->GetValue(&schema, 1).GetAs<int32_t>(), col_a * 10);
+      seen[col_a]++;
+      num_tuples++;
+    }
+    ASSERT_EQ(num_tuples, static_cast<size_t>(num_rows * num_copies));
+    ASSERT_EQ(std::count(seen.begin(), seen.end(), num_copies), num_rows);
+  };
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+  check_copies(2);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->NextBatch(nullptr));
+  check_copies(4);
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleHashJoinTest) {
   // Hash Join
@@ -310,6 +525,371 @@ TEST_F(ExecutorTest, SimpleHashJoinTest) {
   ASSERT_EQ(num_tuples, 100);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleHashJoinBatchTest) {
+  // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col2 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<HashJoinPlanNode> join_plan;
+  const Schema *out_final;
+  {
+    auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    auto predicate = MakeComparisonExpression(colA, col1, ComparisonType::Equal);
+    out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col2", col2}});
+    join_plan = std::make_unique<HashJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate,
+        std::move(left_keys), std::move(right_keys));
+  }
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), join_plan.get());
+  executor->Init();
+  // Use a small batch so that the join has to stop and resume in the middle of a probe batch.
+  TupleBatch batch(out_final, 7);
+  uint32_t num_tuples = 0;
+  while (executor->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.GetSize(); i++) {
+      ASSERT_EQ(batch.GetValue(i, out_final->GetColIdx("colA")).GetAs<int32_t>(),
+                batch.GetValue(i, out_final->GetColIdx("col1")).GetAs<int16_t>());
+      num_tuples++;
+    }
+  }
+  ASSERT_EQ(num_tuples, 100);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelHashJoinTest) {
+  // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col2 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1
+  GetExecutorContext()->SetDegreeOfParallelism(4);
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<HashJoinPlanNode> join_plan;
+  const Schema *out_final;
+  {
+    auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    auto predicate = MakeComparisonExpression(colA, col1, ComparisonType::Equal);
+    out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col2", col2}});
+    join_plan = std::make_unique<HashJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate,
+        std::move(left_keys), std::move(right_keys));
+  }
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), join_plan.get());
+  // The partitions are joined in no particular order, but every joined tuple must come out exactly once.
+  std::vector<bool> seen(100, false);
+  executor->Init();
+  TupleBatch batch(out_final);
+  while (executor->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.GetSize(); i++) {
+      auto a = batch.GetValue(i, out_final->GetColIdx("colA")).GetAs<int32_t>();
+      ASSERT_EQ(a, batch.GetValue(i, out_final->GetColIdx("col1")).GetAs<int16_t>());
+      ASSERT_LT(a, 100);
+      ASSERT_FALSE(seen[a]);
+      seen[a] = true;
+    }
+  }
+  ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 100);
+
+  std::fill(seen.begin(), seen.end(), false);
+  executor->Init();
+  Tuple tuple;
+  while (executor->Next(&tuple)) {
+    auto a = tuple.GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>();
+    ASSERT_LT(a, 100);
+    ASSERT_FALSE(seen[a]);
+    seen[a] = true;
+  }
+  ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 100);
+
+  // A build side over the memory budget is joined by the serial join instead, which spills it.
+  GetExecutorContext()->SetMemoryBudget(1);
+  std::fill(seen.begin(), seen.end(), false);
+  executor->Init();
+  while (executor->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.GetSize(); i++) {
+      auto a = batch.GetValue(i, out_final->GetColIdx("colA")).GetAs<int32_t>();
+      ASSERT_EQ(a, batch.GetValue(i, out_final->GetColIdx("col1")).GetAs<int16_t>());
+      ASSERT_LT(a, 100);
+      ASSERT_FALSE(seen[a]);
+      seen[a] = true;
+    }
+  }
+  ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 100);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, GraceHashJoinTest) {
+  // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col2 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1
+  // The memory budget is too small for any of test_1, so the join has to spill both inputs.
+  GetExecutorContext()->SetMemoryBudget(1);
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<HashJoinPlanNode> join_plan;
+  const Schema *out_final;
+  {
+    auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    auto predicate = MakeComparisonExpression(colA, col1, ComparisonType::Equal);
+    out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col2", col2}});
+    join_plan = std::make_unique<HashJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate,
+        std::move(left_keys), std::move(right_keys));
+  }
+
+  size_t pool_bytes = GetExecutorContext()->GetPool()->GetAllocatedBytes();
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), join_plan.get());
+  // Spilled partitions are joined one after the other, so tuples come out in no particular order.
+  std::vector<bool> seen(100, false);
+  executor->Init();
+  Tuple tuple;
+  while (executor->Next(&tuple)) {
+    auto a = tuple.GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>();
+    ASSERT_EQ(a, tuple.GetValue(out_final, out_final->GetColIdx("col1")).GetAs<int16_t>());
+    ASSERT_LT(a, 100);
+    ASSERT_FALSE(seen[a]);
+    seen[a] = true;
+  }
+  ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 100);
+
+  std::fill(seen.begin(), seen.end(), false);
+  executor->Init();
+  TupleBatch batch(out_final);
+  while (executor->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.GetSize(); i++) {
+      auto a = batch.GetValue(i, out_final->GetColIdx("colA")).GetAs<int32_t>();
+      ASSERT_LT(a, 100);
+      ASSERT_FALSE(seen[a]);
+      seen[a] = true;
+    }
+  }
+  ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 100);
+  // The build tuples that were in memory before the join spilled are released, not left in the query's pool.
+  ASSERT_EQ(GetExecutorContext()->GetPool()->GetAllocatedBytes(), pool_bytes);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, CompositeKeyHashJoinTest) {
+  // SELECT l.k1, l.k2, r.k1, r.k2 FROM t l JOIN t r ON l.k1 = r.k1 AND l.k2 = r.k2, for an INTEGER/INTEGER pair of
+  // keys and an INTEGER/BIGINT pair of keys. Only the first key is part of the join predicate, so the second key is
+  // matched by the hash table alone.
+  struct JoinSpec {
+    std::string table_;
+    std::string key1_;
+    std::string key2_;
+  };
+  for (const auto &spec : {JoinSpec{"test_1", "colB", "colC"}, JoinSpec{"test_2", "col2", "col3"}}) {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable(spec.table_);
+    auto &schema = table_info->schema_;
+    const Schema *scan_schema;
+    std::unique_ptr<AbstractPlanNode> scan_plan1;
+    std::unique_ptr<AbstractPlanNode> scan_plan2;
+    {
+      auto key1 = MakeColumnValueExpression(schema, 0, spec.key1_);
+      auto key2 = MakeColumnValueExpression(schema, 0, spec.key2_);
+      scan_schema = MakeOutputSchema({{"k1", key1}, {"k2", key2}});
+      scan_plan1 = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+      scan_plan2 = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+    }
+
+    // Count the expected matches by brute force.
+    std::vector<std::vector<Value>> rows;
+    {
+      auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), scan_plan1.get());
+      executor->Init();
+      TupleBatch batch(scan_schema);
+      while (executor->NextBatch(&batch)) {
+        for (uint32_t i = 0; i < batch.GetSize(); i++) {
+          rows.emplace_back(batch.GetValues(i));
+        }
+      }
+    }
+    uint32_t expected = 0;
+    for (const auto &l : rows) {
+      for (const auto &r : rows) {
+        if (!l[0].IsNull() && !r[0].IsNull() && l[0].CompareEquals(r[0]) == CmpBool::CmpTrue &&
+            l[1].CompareEquals(r[1]) == CmpBool::CmpTrue) {
+          expected++;
+        }
+      }
+    }
+
+    const Schema *out_final;
+    std::unique_ptr<HashJoinPlanNode> join_plan;
+    {
+      auto l_key1 = MakeColumnValueExpression(*scan_schema, 0, "k1");
+      auto l_key2 = MakeColumnValueExpression(*scan_schema, 0, "k2");
+      auto r_key1 = MakeColumnValueExpression(*scan_schema, 1, "k1");
+      auto r_key2 = MakeColumnValueExpression(*scan_schema, 1, "k2");
+      auto predicate = MakeComparisonExpression(l_key1, r_key1, ComparisonType::Equal);
+      out_final = MakeOutputSchema({{"l_k1", l_key1}, {"l_k2", l_key2}, {"r_k1", r_key1}, {"r_k2", r_key2}});
+      join_plan = std::make_unique<HashJoinPlanNode>(
+          out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate,
+          std::vector<const AbstractExpression *>{l_key1, l_key2}, std::vector<const AbstractExpression *>{r_key1, r_key2});
+    }
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), join_plan.get());
+    executor->Init();
+    uint32_t num_tuples = 0;
+    Tuple tuple;
+    while (executor->Next(&tuple)) {
+      ASSERT_EQ(tuple.GetValue(out_final, 0).CompareEquals(tuple.GetValue(out_final, 2)), CmpBool::CmpTrue);
+      ASSERT_EQ(tuple.GetValue(out_final, 1).CompareEquals(tuple.GetValue(out_final, 3)), CmpBool::CmpTrue);
+      num_tuples++;
+    }
+    ASSERT_EQ(num_tuples, expected);
+    ASSERT_GT(num_tuples, rows.size() / 2);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, BloomFilterPushDownTest) {
+  // SELECT colA, colB FROM test_1, with a Bloom filter that only contains colA in [0, 100)
+  {
+    TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    Schema &schema = table_info->schema_;
+    auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+    auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    BlockedBloomFilter filter(100);
+    for (int32_t i = 0; i < 100; i++) {
+      JoinKey key;
+      key.Append(ValueFactory::GetIntegerValue(i));
+      filter.Insert(key.hash_);
+    }
+
+    SeqScanPlanNode plan{out_schema, nullptr, table_info->oid_};
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+    auto key = MakeColumnValueExpression(*out_schema, 1, "colA");
+    ASSERT_TRUE(executor->PushDownBloomFilter(&filter, {key}));
+    executor->Init();
+    std::vector<bool> seen(100, false);
+    uint32_t num_tuples = 0;
+    Tuple tuple;
+    while (executor->Next(&tuple)) {
+      auto a = tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>();
+      if (a < 100) {
+        seen[a] = true;
+      }
+      num_tuples++;
+    }
+    // Every key in the filter passes, along with very few false positives.
+    ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 100);
+    ASSERT_LT(num_tuples, 110);
+  }
+
+  // SELECT test_2.col1, test_2.col2, test_1.colA, test_1.colB FROM test_2 JOIN test_1 ON test_2.col1 = test_1.colA
+  // The small test_2 is the build side here, so its filter lets the scan of test_1 skip most tuples.
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema1 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema2 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<HashJoinPlanNode> join_plan;
+  const Schema *out_final;
+  {
+    auto col1 = MakeColumnValueExpression(*out_schema1, 0, "col1");
+    auto col2 = MakeColumnValueExpression(*out_schema1, 0, "col2");
+    auto colA = MakeColumnValueExpression(*out_schema2, 1, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema2, 1, "colB");
+    auto predicate = MakeComparisonExpression(col1, colA, ComparisonType::Equal);
+    out_final = MakeOutputSchema({{"col1", col1}, {"col2", col2}, {"colA", colA}, {"colB", colB}});
+    join_plan = std::make_unique<HashJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate,
+        std::vector<const AbstractExpression *>{col1}, std::vector<const AbstractExpression *>{colA});
+  }
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), join_plan.get());
+  executor->Init();
+  uint32_t num_tuples = 0;
+  Tuple tuple;
+  while (executor->Next(&tuple)) {
+    ASSERT_EQ(tuple.GetValue(out_final, out_final->GetColIdx("col1")).GetAs<int16_t>(),
+              tuple.GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>());
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 100);
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleAggregationTest) {
   // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
@@ -423,4 +1003,544 @@ TEST_F(ExecutorTest, SimpleGroupByAggregation) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelGroupByAggregationTest) {
+  // SELECT colC, count(colA), sum(colA), min(colA), max(colA) FROM test_1 GROUP BY colC
+  std::unique_ptr<AbstractPlanNode> scan_plan;
+  const Schema *scan_schema;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colC = MakeColumnValueExpression(schema, 0, "colC");
+    scan_schema = MakeOutputSchema({{"colA", colA}, {"colC", colC}});
+    scan_plan = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+  }
+
+  std::unique_ptr<AbstractPlanNode> agg_plan;
+  const Schema *agg_schema;
+  {
+    const AbstractExpression *colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    const AbstractExpression *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+    const AbstractExpression *groupbyC = MakeAggregateValueExpression(true, 0);
+    const AbstractExpression *countA = MakeAggregateValueExpression(false, 0);
+    const AbstractExpression *sumA = MakeAggregateValueExpression(false, 1);
+    const AbstractExpression *minA = MakeAggregateValueExpression(false, 2);
+    const AbstractExpression *maxA = MakeAggregateValueExpression(false, 3);
+    agg_schema = MakeOutputSchema(
+        {{"colC", groupbyC}, {"countA", countA}, {"sumA", sumA}, {"minA", minA}, {"maxA", maxA}});
+    agg_plan = std::make_unique<AggregationPlanNode>(
+        agg_schema, scan_plan.get(), nullptr, std::vector<const AbstractExpression *>{colC},
+        std::vector<const AbstractExpression *>{colA, colA, colA, colA},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                     AggregationType::MinAggregate, AggregationType::MaxAggregate});
+  }
+
+  // Run the aggregation serially and in parallel, and in parallel with the groups over the memory budget part of the
+  // way, or from the start. The groups must be the same.
+  std::vector<std::unordered_map<int32_t, std::vector<int32_t>>> results;
+  std::vector<std::pair<uint32_t, size_t>> configs{
+      {1, EXECUTOR_MEMORY_BUDGET}, {4, EXECUTOR_MEMORY_BUDGET}, {4, 4096}, {4, 1}};
+  for (auto [num_workers, memory_budget] : configs) {
+    GetExecutorContext()->SetDegreeOfParallelism(num_workers);
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), agg_plan.get());
+    executor->Init();
+    auto &groups = results.emplace_back();
+    Tuple tuple;
+    while (executor->Next(&tuple)) {
+      auto colC = tuple.GetValue(agg_schema, 0).GetAs<int32_t>();
+      ASSERT_EQ(groups.count(colC), 0);
+      for (uint32_t i = 1; i < agg_schema->GetColumnCount(); i++) {
+        groups[colC].push_back(tuple.GetValue(agg_schema, i).GetAs<int32_t>());
+      }
+    }
+  }
+  ASSERT_GT(results[0].size(), 64);
+  ASSERT_EQ(results[0], results[1]);
+  ASSERT_EQ(results[0], results[2]);
+  ASSERT_EQ(results[0], results[3]);
+  int32_t total_count = 0;
+  for (const auto &[colC, aggregates] : results[1]) {
+    total_count += aggregates[0];
+  }
+  ASSERT_EQ(total_count, 1000);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SpillingGroupByAggregationTest) {
+  // SELECT colC, count(colA), sum(colA), min(colA), max(colA) FROM test_1 GROUP BY colC
+  std::unique_ptr<AbstractPlanNode> scan_plan;
+  const Schema *scan_schema;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colC = MakeColumnValueExpression(schema, 0, "colC");
+    scan_schema = MakeOutputSchema({{"colA", colA}, {"colC", colC}});
+    scan_plan = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+  }
+
+  std::unique_ptr<AbstractPlanNode> agg_plan;
+  const Schema *agg_schema;
+  {
+    const AbstractExpression *colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    const AbstractExpression *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+    const AbstractExpression *groupbyC = MakeAggregateValueExpression(true, 0);
+    const AbstractExpression *countA = MakeAggregateValueExpression(false, 0);
+    const AbstractExpression *sumA = MakeAggregateValueExpression(false, 1);
+    const AbstractExpression *minA = MakeAggregateValueExpression(false, 2);
+    const AbstractExpression *maxA = MakeAggregateValueExpression(false, 3);
+    agg_schema = MakeOutputSchema(
+        {{"colC", groupbyC}, {"countA", countA}, {"sumA", sumA}, {"minA", minA}, {"maxA", maxA}});
+    agg_plan = std::make_unique<AggregationPlanNode>(
+        agg_schema, scan_plan.get(), nullptr, std::vector<const AbstractExpression *>{colC},
+        std::vector<const AbstractExpression *>{colA, colA, colA, colA},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                     AggregationType::MinAggregate, AggregationType::MaxAggregate});
+  }
+
+  // Run the aggregation in memory, with a few groups in memory and the rest spilled, and with every group spilled.
+  // The groups must be the same.
+  std::vector<std::unordered_map<int32_t, std::vector<int32_t>>> results;
+  for (size_t memory_budget : {EXECUTOR_MEMORY_BUDGET, static_cast<size_t>(4096), static_cast<size_t>(1)}) {
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), agg_plan.get());
+    executor->Init();
+    auto &groups = results.emplace_back();
+    Tuple tuple;
+    while (executor->Next(&tuple)) {
+      auto colC = tuple.GetValue(agg_schema, 0).GetAs<int32_t>();
+      ASSERT_EQ(groups.count(colC), 0);
+      for (uint32_t i = 1; i < agg_schema->GetColumnCount(); i++) {
+        groups[colC].push_back(tuple.GetValue(agg_schema, i).GetAs<int32_t>());
+      }
+    }
+  }
+  ASSERT_GT(results[0].size(), 64);
+  ASSERT_EQ(results[0], results[1]);
+  ASSERT_EQ(results[0], results[2]);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SortTest) {
+  // SELECT colA, colB FROM test_1 ORDER BY colB DESC [LIMIT 10]
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+
+  // The expected order: the scan order, stably sorted on colB.
+  std::vector<std::pair<int32_t, int32_t>> expected;
+  {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+    executor->Init();
+    Tuple tuple;
+    while (executor->Next(&tuple)) {
+      expected.emplace_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>(),
+                            tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+    }
+  }
+  std::stable_sort(expected.begin(), expected.end(), [](auto &a, auto &b) { return a.second > b.second; });
+
+  auto sort_colB = MakeColumnValueExpression(*out_schema, 0, "colB");
+  // In-memory sort, external merge sort over many runs, Top-N, and an external sort with a limit.
+  std::vector<std::pair<size_t, size_t>> cases{{EXECUTOR_MEMORY_BUDGET, SortPlanNode::NO_LIMIT},
+                                               {4096, SortPlanNode::NO_LIMIT},
+                                               {EXECUTOR_MEMORY_BUDGET, 10},
+                                               {1, 10}};
+  for (auto [memory_budget, limit] : cases) {
+    SortPlanNode sort_plan{out_schema, &scan_plan, {{OrderByType::Descending, sort_colB}}, limit};
+    std::vector<Tuple> tuples;
+    {
+      // The sorted tuples outlive the context, and with it the pool, of the query that produced them.
+      ExecutorContext exec_ctx{GetExecutorContext()->GetTransaction(), GetExecutorContext()->GetCatalog(),
+                               GetExecutorContext()->GetBufferPoolManager()};
+      exec_ctx.SetMemoryBudget(memory_budget);
+      auto executor = ExecutorFactory::CreateExecutor(&exec_ctx, &sort_plan);
+      executor->Init();
+      Tuple tuple;
+      while (executor->Next(&tuple)) {
+        ASSERT_TRUE(tuple.IsAllocated());
+        tuples.push_back(tuple);
+      }
+    }
+    std::vector<std::pair<int32_t, int32_t>> result;
+    for (const auto &tuple : tuples) {
+      result.emplace_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>(),
+                          tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+    }
+    expected.resize(std::min(limit, expected.size()));
+    ASSERT_EQ(result, expected);
+  }
+
+  // NULLs come first in descending order too.
+  // INSERT INTO empty_table2 VALUES (0, NULL), (1, 5), (2, NULL), (3, 7), (4, 5)
+  // SELECT colA, colB FROM empty_table2 ORDER BY colB DESC [LIMIT 3]
+  auto null_table_info = GetExecutorContext()->GetCatalog()->GetTable("empty_table2");
+  Value null_value = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  std::vector<std::vector<Value>> raw_vals{{ValueFactory::GetIntegerValue(0), null_value},
+                                           {ValueFactory::GetIntegerValue(1), ValueFactory::GetIntegerValue(5)},
+                                           {ValueFactory::GetIntegerValue(2), null_value},
+                                           {ValueFactory::GetIntegerValue(3), ValueFactory::GetIntegerValue(7)},
+                                           {ValueFactory::GetIntegerValue(4), ValueFactory::GetIntegerValue(5)}};
+  InsertPlanNode insert_plan{std::move(raw_vals), null_table_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+  SeqScanPlanNode null_scan_plan{out_schema, nullptr, null_table_info->oid_};
+  std::vector<std::pair<size_t, size_t>> null_cases{
+      {EXECUTOR_MEMORY_BUDGET, SortPlanNode::NO_LIMIT}, {1, SortPlanNode::NO_LIMIT}, {EXECUTOR_MEMORY_BUDGET, 3}};
+  for (auto [memory_budget, limit] : null_cases) {
+    SortPlanNode sort_plan{out_schema, &null_scan_plan, {{OrderByType::Descending, sort_colB}}, limit};
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+    executor->Init();
+    std::vector<int32_t> result;
+    Tuple tuple;
+    while (executor->Next(&tuple)) {
+      result.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+    }
+    std::vector<int32_t> null_expected{0, 2, 3, 1, 4};
+    null_expected.resize(std::min(limit, null_expected.size()));
+    ASSERT_EQ(result, null_expected);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, IndexScanTest) {
+  // CREATE INDEX index_colB ON test_1 (colB)
+  auto *catalog = GetExecutorContext()->GetCatalog();
+  auto *txn = GetExecutorContext()->GetTransaction();
+  auto table_info = catalog->GetTable("test_1");
+  auto index_info =
+      catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(txn, "index_colB", "test_1", {1});
+  ASSERT_EQ(catalog->GetIndex("index_colB", "test_1"), index_info);
+  ASSERT_EQ(catalog->GetTableIndexes("test_1"), std::vector<IndexInfo *>{index_info});
+
+  // SELECT colA, colB FROM test_1 WHERE colB IN (3, 7) AND colA < 500
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  auto out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+
+  std::vector<std::pair<int32_t, int32_t>> expected;
+  {
+    SeqScanPlanNode scan_plan{out_schema, predicate, table_info->oid_};
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+    executor->Init();
+    Tuple tuple;
+    while (executor->Next(&tuple)) {
+      auto row = std::make_pair(tuple.GetValue(out_schema, 0).GetAs<int32_t>(),
+                                tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+      if (row.second == 3 || row.second == 7) {
+        expected.push_back(row);
+      }
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  // The index scan produces the tuples in RID order, which is also the order of the sequential scan.
+  IndexScanPlanNode index_scan_plan{
+      out_schema,
+      predicate,
+      index_info->index_oid_,
+      {{ValueFactory::GetIntegerValue(3)}, {ValueFactory::GetIntegerValue(7)}, {ValueFactory::GetIntegerValue(3)}}};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &index_scan_plan);
+  executor->Init();
+  std::vector<std::pair<int32_t, int32_t>> result;
+  TupleBatch batch(out_schema);
+  while (executor->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.GetSize(); i++) {
+      result.emplace_back(batch.GetValue(i, 0).GetAs<int32_t>(), batch.GetValue(i, 1).GetAs<int32_t>());
+    }
+  }
+  ASSERT_EQ(result, expected);
+
+  // Inserted tuples are added to the indexes of their table.
+  // CREATE INDEX index_colA ON empty_table2 (colA)
+  // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
+  auto empty_table_info = catalog->GetTable("empty_table2");
+  auto empty_index_info =
+      catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(txn, "index_colA", "empty_table2", {0});
+  std::vector<std::vector<Value>> raw_vals{{ValueFactory::GetIntegerValue(100), ValueFactory::GetIntegerValue(10)},
+                                           {ValueFactory::GetIntegerValue(101), ValueFactory::GetIntegerValue(11)},
+                                           {ValueFactory::GetIntegerValue(102), ValueFactory::GetIntegerValue(12)}};
+  InsertPlanNode insert_plan{std::move(raw_vals), empty_table_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+
+  // SELECT colB FROM empty_table2 WHERE colA = 101
+  auto empty_colB = MakeColumnValueExpression(empty_table_info->schema_, 0, "colB");
+  auto empty_out_schema = MakeOutputSchema({{"colB", empty_colB}});
+  IndexScanPlanNode point_plan{
+      empty_out_schema, nullptr, empty_index_info->index_oid_, {{ValueFactory::GetIntegerValue(101)}}};
+  auto point_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &point_plan);
+  point_executor->Init();
+  Tuple tuple;
+  ASSERT_TRUE(point_executor->Next(&tuple));
+  ASSERT_EQ(tuple.GetValue(empty_out_schema, 0).GetAs<int32_t>(), 11);
+  ASSERT_FALSE(point_executor->Next(&tuple));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, IndexInsertAbortTest) {
+  // CREATE INDEX index_colA ON empty_table2 (colA)
+  auto *catalog = GetExecutorContext()->GetCatalog();
+  auto table_info = catalog->GetTable("empty_table2");
+  auto index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "index_colA", "empty_table2", {0});
+
+  // INSERT INTO empty_table2 VALUES (100, 10), (101, 11) in a transaction that aborts.
+  auto *txn = GetTxnManager()->Begin();
+  ExecutorContext exec_ctx{txn, catalog, GetExecutorContext()->GetBufferPoolManager()};
+  std::vector<std::vector<Value>> raw_vals{{ValueFactory::GetIntegerValue(100), ValueFactory::GetIntegerValue(10)},
+                                           {ValueFactory::GetIntegerValue(101), ValueFactory::GetIntegerValue(11)}};
+  InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(&exec_ctx, &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+  ASSERT_EQ(txn->GetIndexWriteSet()->size(), 2);
+  std::vector<RID> rids;
+  index_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(101)}, &index_info->key_schema_), &rids, txn);
+  ASSERT_EQ(rids.size(), 1);
+  GetTxnManager()->Abort(txn);
+  delete txn;
+
+  // The aborted insert left nothing behind in the index.
+  // SELECT colB FROM empty_table2 WHERE colA = 100 OR colA = 101
+  auto colB = MakeColumnValueExpression(table_info->schema_, 0, "colB");
+  auto out_schema = MakeOutputSchema({{"colB", colB}});
+  IndexScanPlanNode scan_plan{
+      out_schema,
+      nullptr,
+      index_info->index_oid_,
+      {{ValueFactory::GetIntegerValue(100)}, {ValueFactory::GetIntegerValue(101)}}};
+  auto scan_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+  scan_executor->Init();
+  Tuple tuple;
+  ASSERT_FALSE(scan_executor->Next(&tuple));
+  rids.clear();
+  index_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(101)}, &index_info->key_schema_), &rids,
+                              GetExecutorContext()->GetTransaction());
+  ASSERT_TRUE(rids.empty());
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, IndexNestedLoopJoinTest) {
+  // CREATE INDEX index_colA ON test_1 (colA)
+  auto *catalog = GetExecutorContext()->GetCatalog();
+  auto table_info = catalog->GetTable("test_1");
+  auto index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetExecutorContext()->GetTransaction(), "index_colA", "test_1", {0});
+
+  // SELECT test_2.col1, test_1.colA, test_1.colB FROM test_2 JOIN test_1 ON test_2.col1 = test_1.colA
+  // WHERE test_1.colB < 5
+  std::unique_ptr<AbstractPlanNode> outer_plan;
+  const Schema *outer_schema;
+  {
+    auto outer_info = catalog->GetTable("test_2");
+    auto col1 = MakeColumnValueExpression(outer_info->schema_, 0, "col1");
+    auto col2 = MakeColumnValueExpression(outer_info->schema_, 0, "col2");
+    outer_schema = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    outer_plan = std::make_unique<SeqScanPlanNode>(outer_schema, nullptr, outer_info->oid_);
+  }
+  // The outer tuple is on the left (tuple index 0), and the inner table tuple is on the right (tuple index 1).
+  auto col1 = MakeColumnValueExpression(*outer_schema, 0, "col1");
+  auto colA = MakeColumnValueExpression(table_info->schema_, 1, "colA");
+  auto colB = MakeColumnValueExpression(table_info->schema_, 1, "colB");
+  auto const5 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(5));
+  auto predicate = MakeComparisonExpression(colB, const5, ComparisonType::LessThan);
+  auto out_schema = MakeOutputSchema({{"col1", col1}, {"colA", colA}, {"colB", colB}});
+  IndexNestedLoopJoinPlanNode join_plan{out_schema, outer_plan.get(), predicate, index_info->index_oid_, {col1}};
+
+  // test_1.colA and test_2.col1 are both serial, so every outer tuple matches the test_1 tuple with the same colA.
+  std::vector<std::tuple<int32_t, int32_t, int32_t>> expected;
+  for (auto iter = table_info->table_->Begin(GetExecutorContext()->GetTransaction()); iter != table_info->table_->End();
+       ++iter) {
+    auto a = iter->GetValue(&table_info->schema_, 0).GetAs<int32_t>();
+    auto b = iter->GetValue(&table_info->schema_, 1).GetAs<int32_t>();
+    if (a < static_cast<int32_t>(TEST2_SIZE) && b < 5) {
+      expected.emplace_back(a, a, b);
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+  executor->Init();
+  std::vector<std::tuple<int32_t, int32_t, int32_t>> result;
+  TupleBatch batch(out_schema);
+  while (executor->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.GetSize(); i++) {
+      result.emplace_back(batch.GetValue(i, 0).GetAs<int16_t>(), batch.GetValue(i, 1).GetAs<int32_t>(),
+                          batch.GetValue(i, 2).GetAs<int32_t>());
+    }
+  }
+  ASSERT_EQ(result, expected);
+
+  // Tuple-at-a-time execution produces the same result.
+  executor->Init();
+  result.clear();
+  Tuple tuple;
+  while (executor->Next(&tuple)) {
+    result.emplace_back(tuple.GetValue(out_schema, 0).GetAs<int16_t>(), tuple.GetValue(out_schema, 1).GetAs<int32_t>(),
+                        tuple.GetValue(out_schema, 2).GetAs<int32_t>());
+  }
+  ASSERT_EQ(result, expected);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SeqScanViewTest) {
+  // SELECT * FROM test_1 WHERE colA < 500, read as views of the tuples in their pages
+  auto *catalog = GetExecutorContext()->GetCatalog();
+  auto table_info = catalog->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  std::vector<std::pair<std::string, const AbstractExpression *>> columns;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &name = schema.GetColumn(i).GetName();
+    columns.emplace_back(name, MakeColumnValueExpression(schema, 0, name));
+  }
+  auto out_schema = MakeOutputSchema(columns);
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  SeqScanPlanNode scan_plan{out_schema, predicate, table_info->oid_};
+
+  std::vector<std::string> expected;
+  {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+    executor->Init();
+    Tuple tuple;
+    while (executor->Next(&tuple)) {
+      expected.push_back(tuple.ToString(out_schema));
+    }
+  }
+  ASSERT_EQ(expected.size(), 500);
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+  executor->Init();
+  std::vector<std::string> result;
+  TupleView view;
+  while (executor->NextView(&view)) {
+    ASSERT_LT(view.GetValue(out_schema, 0).GetAs<int32_t>(), 500);
+    result.push_back(view.AsTuple().ToString(out_schema));
+  }
+  ASSERT_EQ(result, expected);
+
+  // INSERT INTO test_1_copy SELECT * FROM test_1 WHERE colA < 500 inserts the scanned tuples straight from their pages.
+  auto copy_info = catalog->CreateTable(GetExecutorContext()->GetTransaction(), "test_1_copy", schema);
+  InsertPlanNode insert_plan{&scan_plan, copy_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+  result.clear();
+  for (auto iter = copy_info->table_->Begin(GetExecutorContext()->GetTransaction()); iter != copy_info->table_->End();
+       ++iter) {
+    result.push_back(iter->ToString(&schema));
+  }
+  ASSERT_EQ(result, expected);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, PaxSeqScanTest) {
+  // CREATE TABLE test_1_pax with the PAX layout; INSERT INTO test_1_pax SELECT * FROM test_1
+  auto *catalog = GetExecutorContext()->GetCatalog();
+  auto table_info = catalog->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  std::vector<std::pair<std::string, const AbstractExpression *>> columns;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &name = schema.GetColumn(i).GetName();
+    columns.emplace_back(name, MakeColumnValueExpression(schema, 0, name));
+  }
+  SeqScanPlanNode copy_plan{MakeOutputSchema(columns), nullptr, table_info->oid_};
+  auto pax_info = catalog->CreateTable(GetExecutorContext()->GetTransaction(), "test_1_pax", schema, TableLayout::PAX);
+  ASSERT_EQ(pax_info->table_->GetLayout(), TableLayout::PAX);
+  InsertPlanNode insert_plan{&copy_plan, pax_info->oid_};
+  auto insert_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &insert_plan);
+  insert_executor->Init();
+  ASSERT_TRUE(insert_executor->Next(nullptr));
+
+  // SELECT colA, colB FROM test_1_pax WHERE colA < 500 gathers only colA and colB out of the PAX pages.
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+  auto *predicate = MakeComparisonExpression(colA, const500, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  auto scan = [&](const TableMetadata *info, const AbstractExpression *scan_predicate, bool batches) {
+    SeqScanPlanNode plan{out_schema, scan_predicate, info->oid_};
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+    executor->Init();
+    std::vector<std::string> result;
+    if (batches) {
+      TupleBatch batch(out_schema, 100);
+      while (executor->NextBatch(&batch)) {
+        for (uint32_t i = 0; i < batch.GetSize(); i++) {
+          result.push_back(batch.GetTuple(i).ToString(out_schema));
+        }
+      }
+    } else {
+      Tuple tuple;
+      while (executor->Next(&tuple)) {
+        result.push_back(tuple.ToString(out_schema));
+      }
+    }
+    return result;
+  };
+  auto expected = scan(table_info, predicate, true);
+  ASSERT_EQ(expected.size(), 500);
+  ASSERT_EQ(scan(pax_info, predicate, true), expected);
+  ASSERT_EQ(scan(pax_info, predicate, false), expected);
+  ASSERT_EQ(scan(pax_info, nullptr, true), scan(table_info, nullptr, true));
+  ASSERT_EQ(scan(pax_info, nullptr, true).size(), TEST1_SIZE);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ZoneMapSeqScanTest) {
+  // colA is serial, so the zone maps of test_1 rule out most pages for range predicates on it.
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  auto count = [&](const AbstractExpression *predicate, bool batches) {
+    SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+    executor->Init();
+    uint32_t num_tuples = 0;
+    if (batches) {
+      TupleBatch batch(out_schema);
+      while (executor->NextBatch(&batch)) {
+        num_tuples += batch.GetSize();
+      }
+    } else {
+      Tuple tuple;
+      while (executor->Next(&tuple)) {
+        num_tuples++;
+      }
+    }
+    return num_tuples;
+  };
+  auto constant = [&](int32_t value) { return MakeConstantValueExpression(ValueFactory::GetIntegerValue(value)); };
+  std::vector<std::pair<const AbstractExpression *, uint32_t>> cases{
+      {MakeComparisonExpression(colA, constant(500), ComparisonType::LessThan), 500},
+      {MakeComparisonExpression(constant(500), colA, ComparisonType::GreaterThan), 500},
+      {MakeComparisonExpression(colA, constant(900), ComparisonType::GreaterThanOrEqual), 100},
+      {MakeComparisonExpression(constant(900), colA, ComparisonType::LessThanOrEqual), 100},
+      {MakeComparisonExpression(colA, constant(700), ComparisonType::Equal), 1},
+      {MakeComparisonExpression(colA, constant(3), ComparisonType::NotEqual), TEST1_SIZE - 1},
+      {MakeComparisonExpression(colA, constant(5000), ComparisonType::GreaterThan), 0},
+      {MakeComparisonExpression(colA, MakeConstantValueExpression(ValueFactory::GetBigIntValue(10)),
+                                ComparisonType::LessThanOrEqual),
+       11},
+  };
+  for (const auto &[predicate, expected] : cases) {
+    ASSERT_EQ(count(predicate, false), expected);
+    ASSERT_EQ(count(predicate, true), expected);
+  }
+}
+
 }  // namespace bustub
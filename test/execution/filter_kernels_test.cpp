@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels_test.cpp
+//
+// Identification: test/execution/filter_kernels_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "execution/filter_kernels.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Checks the kernels of one comparison against the scalar loop, for every row count up to a few blocks. */
+template <typename T, ComparisonType CMP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+void CheckKernels(const std::vector<T> &left, const std::vector<T> &right) {
+  for (uint32_t n : {0U, 1U, 7U, 31U, 32U, 33U, 64U, 100U, static_cast<uint32_t>(left.size())}) {
+    std::vector<int8_t> expected(n);
+    FilterKernels::CompareScalar<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>(left.data(), right.data(), expected.data(), 0,
+                                                                        n);
+    std::vector<uint32_t> expected_sel;
+    for (uint32_t i = 0; i < n; i++) {
+      if (expected[i] != 0) {
+        expected_sel.push_back(i);
+      }
+    }
+
+    std::vector<int8_t> out(n);
+    FilterKernels::Compare<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>(left.data(), right.data(), out.data(), n);
+    ASSERT_EQ(out, expected);
+
+    std::vector<uint32_t> sel(n);
+    sel.resize(FilterKernels::Select(out.data(), n, sel.data()));
+    ASSERT_EQ(sel, expected_sel);
+
+    sel.resize(n);
+    sel.resize(FilterKernels::CompareSelect<T, CMP, LEFT_CONSTANT, RIGHT_CONSTANT>(left.data(), right.data(), n,
+                                                                                   sel.data()));
+    ASSERT_EQ(sel, expected_sel);
+  }
+}
+
+template <typename T, ComparisonType CMP>
+void CheckKernels(const std::vector<T> &left, const std::vector<T> &right) {
+  CheckKernels<T, CMP, false, false>(left, right);
+  CheckKernels<T, CMP, false, true>(left, right);
+  CheckKernels<T, CMP, true, false>(left, right);
+}
+
+/** Checks the kernels of every comparison on random values of type T, with small ranges and a few NULLs. */
+template <typename T>
+void CheckKernels() {
+  std::mt19937 generator(0);
+  std::vector<T> left;
+  std::vector<T> right;
+  for (uint32_t i = 0; i < 1000; i++) {
+    left.push_back(static_cast<T>(generator() % 8) - static_cast<T>(generator() % 4));
+    right.push_back(static_cast<T>(generator() % 8) - static_cast<T>(generator() % 4));
+    if (generator() % 10 == 0) {
+      (generator() % 2 == 0 ? left : right).back() = FilterKernels::NullOf<T>();
+    }
+  }
+  // Constants are never NULL.
+  left[0] = 3;
+  right[0] = 2;
+  CheckKernels<T, ComparisonType::Equal>(left, right);
+  CheckKernels<T, ComparisonType::NotEqual>(left, right);
+  CheckKernels<T, ComparisonType::LessThan>(left, right);
+  CheckKernels<T, ComparisonType::LessThanOrEqual>(left, right);
+  CheckKernels<T, ComparisonType::GreaterThan>(left, right);
+  CheckKernels<T, ComparisonType::GreaterThanOrEqual>(left, right);
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, CompareTest) {
+  CheckKernels<int8_t>();
+  CheckKernels<int16_t>();
+  CheckKernels<int32_t>();
+  CheckKernels<int64_t>();
+  CheckKernels<uint64_t>();
+  CheckKernels<double>();
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, LargeColumnTest) {
+  // One comparison of a large column against a constant, the case that the kernels are built for.
+  const uint32_t n = 1 << 20;
+  std::vector<int32_t> values(n);
+  for (uint32_t i = 0; i < n; i++) {
+    values[i] = static_cast<int32_t>(i % 1000);
+  }
+  int32_t constant = 10;
+  std::vector<uint32_t> sel(n);
+  uint32_t count = FilterKernels::CompareSelect<int32_t, ComparisonType::LessThan, false, true>(values.data(),
+                                                                                              &constant, n, sel.data());
+  ASSERT_EQ(count, (n / 1000) * 10 + std::min<uint32_t>(n % 1000, 10));
+  for (uint32_t i = 0; i < count; i++) {
+    ASSERT_LT(values[sel[i]], constant);
+    if (i > 0) {
+      ASSERT_LT(sel[i - 1], sel[i]);
+    }
+  }
+}
+
+}  // namespace bustub
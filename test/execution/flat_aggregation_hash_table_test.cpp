@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_aggregation_hash_table_test.cpp
+//
+// Identification: test/execution/flat_aggregation_hash_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "execution/flat_aggregation_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FlatAggregationHashTableTest, SampleTest) {
+  // Two keys, and a small initial capacity so that the table has to grow several times.
+  FlatAggregationHashTable table(2,
+                                 {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                  AggregationType::MinAggregate, AggregationType::MaxAggregate},
+                                 4);
+  std::map<std::pair<int64_t, int64_t>, std::vector<int64_t>> expected;
+  for (int64_t i = 0; i < 10000; i++) {
+    int64_t key[2] = {i % 100, -(i % 7)};
+    int64_t input = (i * 7919) % 1000 - 500;
+    int64_t inputs[4] = {input, input, input, input};
+    table.InsertCombine(key, table.Hash(key), inputs);
+
+    auto [iter, inserted] = expected.try_emplace({key[0], key[1]}, std::vector<int64_t>{0, 0, input, input});
+    iter->second[0]++;
+    iter->second[1] += input;
+    iter->second[2] = std::min(iter->second[2], input);
+    iter->second[3] = std::max(iter->second[3], input);
+  }
+  ASSERT_EQ(table.Size(), expected.size());
+
+  size_t num_groups = 0;
+  table.ForEach([&](const int64_t *key, const int64_t *accumulators) {
+    auto iter = expected.find({key[0], key[1]});
+    ASSERT_NE(iter, expected.end());
+    ASSERT_EQ(std::vector<int64_t>(accumulators, accumulators + 4), iter->second);
+    num_groups++;
+  });
+  ASSERT_EQ(num_groups, expected.size());
+}
+
+}  // namespace bustub
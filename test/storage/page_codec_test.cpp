@@ -0,0 +1,233 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_codec_test.cpp
+//
+// Identification: test/storage/page_codec_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/page_codec.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageCodecTest, RoundTripTest) {
+  std::mt19937 rng(15445);
+  std::vector<char> compressed(PAGE_SIZE);
+  std::vector<char> decompressed(PAGE_SIZE);
+  auto round_trip = [&](const std::vector<char> &page) {
+    size_t size = PageCodec::Compress(page.data(), page.size(), compressed.data(), compressed.size());
+    if (size == 0) {
+      return size;
+    }
+    EXPECT_TRUE(PageCodec::Decompress(compressed.data(), size, decompressed.data(), page.size()));
+    EXPECT_EQ(memcmp(page.data(), decompressed.data(), page.size()), 0);
+    return size;
+  };
+
+  // An empty page shrinks to a handful of bytes.
+  std::vector<char> page(PAGE_SIZE, 0);
+  ASSERT_LT(round_trip(page), 64);
+
+  // Narrow integers at the front and the back, with free space in between.
+  for (int i = 0; i < 200; i++) {
+    auto value = static_cast<int32_t>(1000000 + rng() % 100);
+    memcpy(page.data() + i * sizeof(int32_t), &value, sizeof(value));
+    memcpy(page.data() + PAGE_SIZE - (i + 1) * sizeof(int32_t), &value, sizeof(value));
+  }
+  ASSERT_LT(round_trip(page), PAGE_SIZE / 2);
+
+  // Random bytes do not compress, and random short inputs still round-trip.
+  for (auto &c : page) {
+    c = static_cast<char>(rng());
+  }
+  ASSERT_EQ(PageCodec::Compress(page.data(), page.size(), compressed.data(), PAGE_SIZE - 1), 0);
+  for (size_t size : {0, 1, 12, 13, 100}) {
+    std::vector<char> small(page.begin(), page.begin() + size);
+    ASSERT_GT(round_trip(small), 0);
+  }
+
+  // Long literal runs and long matches need the extended length bytes.
+  for (int i = PAGE_SIZE / 2; i < PAGE_SIZE; i++) {
+    page[i] = page[i % 7];
+  }
+  ASSERT_GT(round_trip(page), PAGE_SIZE / 2);
+  ASSERT_LT(round_trip(page), PAGE_SIZE / 2 + 64);
+
+  // Corrupt input is rejected instead of overrunning the output.
+  size_t size = PageCodec::Compress(page.data(), page.size(), compressed.data(), compressed.size());
+  ASSERT_FALSE(PageCodec::Decompress(compressed.data(), size - 1, decompressed.data(), PAGE_SIZE));
+  ASSERT_FALSE(PageCodec::Decompress(compressed.data(), size, decompressed.data(), PAGE_SIZE - 1));
+  char bad_offset[] = {0x10, 'a', 0x05, 0x00};
+  ASSERT_FALSE(PageCodec::Decompress(bad_offset, sizeof(bad_offset), decompressed.data(), PAGE_SIZE));
+}
+
+// NOLINTNEXTLINE
+TEST(PageCodecTest, DiskManagerTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::VARCHAR, 16)});
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db", true);
+  // A small pool, so that most pages are written out and read back in.
+  auto *buffer_pool_manager = new BufferPoolManager(5, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < 2000; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i % 100), ValueFactory::GetBigIntValue(1600000000 + i),
+                 ValueFactory::GetVarcharValue(i % 2 == 0 ? "even" : "odd")},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rids.push_back(rid);
+  }
+  buffer_pool_manager->FlushAllPages();
+  ASSERT_GT(disk_manager->GetNumWrites(), 5);
+  ASSERT_LT(disk_manager->GetNumBytesWritten(), static_cast<size_t>(disk_manager->GetNumWrites()) * PAGE_SIZE / 2);
+  // Pages take up only their compressed size on disk, even though most of them grew and moved while being filled.
+  std::set<page_id_t> pages;
+  for (const auto &rid : rids) {
+    pages.insert(rid.GetPageId());
+  }
+  auto file_size = [] {
+    return static_cast<size_t>(std::ifstream("test.db", std::ios::binary | std::ios::ate).tellg());
+  };
+  ASSERT_LT(file_size(), pages.size() * PAGE_SIZE * 3 / 4);
+
+  auto check_tuples = [&](TableHeap *heap) {
+    for (int32_t i = 0; i < 2000; i++) {
+      Tuple tuple;
+      ASSERT_TRUE(heap->GetTuple(rids[i], &tuple, transaction));
+      ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i % 100);
+      ASSERT_EQ(tuple.GetValue(&schema, 1).GetAs<int64_t>(), 1600000000 + i);
+      ASSERT_EQ(tuple.GetValue(&schema, 2).ToString(), i % 2 == 0 ? "even" : "odd");
+    }
+  };
+  check_tuples(table);
+
+  // The pages are found again when the file is opened again.
+  page_id_t first_page_id = table->GetFirstPageId();
+  delete table;
+  delete buffer_pool_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  disk_manager = new DiskManager("test.db", true);
+  buffer_pool_manager = new BufferPoolManager(5, disk_manager);
+  table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, first_page_id);
+  check_tuples(table);
+  // Reading every page once only reads the slots of the pages.
+  ASSERT_LE(disk_manager->GetNumBytesRead(), file_size());
+
+  // A page that does not compress gets a slot of a full page, which is reused once the page is deallocated.
+  std::mt19937 rng(15445);
+  std::vector<char> page(PAGE_SIZE);
+  for (auto &c : page) {
+    c = static_cast<char>(rng());
+  }
+  disk_manager->WritePage(10000, page.data());
+  size_t size = file_size();
+  disk_manager->DeallocatePage(10000);
+  disk_manager->WritePage(10001, page.data());
+  ASSERT_EQ(file_size(), size);
+  std::vector<char> read(PAGE_SIZE);
+  disk_manager->ReadPage(10001, read.data());
+  ASSERT_EQ(memcmp(page.data(), read.data(), PAGE_SIZE), 0);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(PageCodecTest, SlotRecoveryTest) {
+  auto file_size = [] {
+    return static_cast<size_t>(std::ifstream("test.db", std::ios::binary | std::ios::ate).tellg());
+  };
+  auto read_file = [](size_t offset, size_t size) {
+    std::vector<char> bytes(size);
+    std::ifstream file("test.db", std::ios::binary);
+    file.seekg(offset);
+    file.read(bytes.data(), size);
+    return bytes;
+  };
+  auto write_file = [](size_t offset, const std::vector<char> &bytes) {
+    std::fstream file("test.db", std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(bytes.data(), bytes.size());
+  };
+  std::mt19937 rng(15445);
+  std::vector<char> random_page(PAGE_SIZE);
+  for (auto &c : random_page) {
+    c = static_cast<char>(rng());
+  }
+  std::vector<char> zero_page(PAGE_SIZE, 0);
+
+  // Page 1 takes a full slot at the start of the file, and page 2 a small slot after it. Once page 1 is gone, page 2
+  // grows and moves into the full slot, before its old slot.
+  // The padding of the last slot is not written, so the size of a full slot is the file size rounded up.
+  auto *disk_manager = new DiskManager("test.db", true);
+  disk_manager->WritePage(1, random_page.data());
+  size_t full_slot_size = (file_size() + 511) / 512 * 512;
+  disk_manager->WritePage(2, zero_page.data());
+  size_t end = file_size();
+  auto old_slot = read_file(full_slot_size, end - full_slot_size);
+  disk_manager->DeallocatePage(1);
+  disk_manager->WritePage(2, random_page.data());
+  ASSERT_EQ(file_size(), end);
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // As if the process had stopped before the old slot was freed, both slots now hold page 2. The newer copy wins,
+  // even though it comes first in the file, and the older slot is free again.
+  write_file(full_slot_size, old_slot);
+  disk_manager = new DiskManager("test.db", true);
+  std::vector<char> read(PAGE_SIZE);
+  ASSERT_TRUE(disk_manager->ReadPage(2, read.data()));
+  ASSERT_EQ(memcmp(random_page.data(), read.data(), PAGE_SIZE), 0);
+  disk_manager->WritePage(3, zero_page.data());
+  ASSERT_EQ(file_size(), end);
+  ASSERT_TRUE(disk_manager->ReadPage(3, read.data()));
+  ASSERT_EQ(memcmp(zero_page.data(), read.data(), PAGE_SIZE), 0);
+
+  // A slot whose page does not decompress is reported instead of being read as a page of zeroes, and the buffer pool
+  // does not hand it out.
+  disk_manager->ShutDown();
+  delete disk_manager;
+  write_file(full_slot_size + 24, std::vector<char>(end - full_slot_size - 24, static_cast<char>(0xff)));
+  disk_manager = new DiskManager("test.db", true);
+  ASSERT_FALSE(disk_manager->ReadPage(3, read.data()));
+  auto *buffer_pool_manager = new BufferPoolManager(2, disk_manager);
+  ASSERT_EQ(buffer_pool_manager->FetchPage(3), nullptr);
+  ASSERT_NE(buffer_pool_manager->FetchPage(2), nullptr);
+  buffer_pool_manager->UnpinPage(2, false);
+
+  delete buffer_pool_manager;
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_page_test.cpp
+//
+// Identification: test/storage/pax_table_page_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the i-th test tuple, whose VARCHAR column is len characters long */
+Tuple MakeTuple(const Schema &schema, int32_t i, size_t len) {
+  std::vector<Value> values{ValueFactory::GetVarcharValue(std::string(len, static_cast<char>('a' + i % 26))),
+                            ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(3 * int64_t{i}),
+                            ValueFactory::GetSmallIntValue(static_cast<int16_t>(i % 100))};
+  return Tuple(values, &schema);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(PaxTablePageTest, LayoutTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::BOOLEAN)});
+  PaxLayout layout(schema);
+  // Every slot needs 8 bytes of slot array and 13 bytes of minipages.
+  ASSERT_EQ(layout.GetCapacity(), (PAGE_SIZE - 24 - 3 * 8) / (8 + 13));
+  uint32_t capacity = layout.GetCapacity();
+  ASSERT_EQ(layout.GetMinipageOffset(0), 24 + 8 * capacity);
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    ASSERT_EQ(layout.GetMinipageOffset(i) % 8, 0);
+  }
+  ASSERT_GE(layout.GetMinipageOffset(1), layout.GetMinipageOffset(0) + 4 * capacity);
+  ASSERT_GE(layout.GetMinipageOffset(2), layout.GetMinipageOffset(1) + 8 * capacity);
+  ASSERT_EQ(layout.GetDataEnd(), layout.GetMinipageOffset(2) + capacity);
+  ASSERT_LE(layout.GetDataEnd(), PAGE_SIZE);
+  ASSERT_EQ(layout.GetMaxTupleSize(), schema.GetLength() + PAGE_SIZE - layout.GetDataEnd());
+}
+
+// NOLINTNEXTLINE
+TEST(PaxTablePageTest, TableHeapTest) {
+  Schema schema({Column("a", TypeId::VARCHAR, 40), Column("b", TypeId::INTEGER), Column("c", TypeId::BIGINT),
+                 Column("d", TypeId::SMALLINT)});
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, TableLayout::PAX, &schema);
+  ASSERT_EQ(table->GetLayout(), TableLayout::PAX);
+
+  // RID -> expected tuple string, in table order.
+  std::map<RID, std::string, bool (*)(const RID &, const RID &)> expected(
+      [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < 2000; i++) {
+    Tuple tuple = MakeTuple(schema, i, i % 23);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rids.push_back(rid);
+    expected[rid] = tuple.ToString(&schema);
+  }
+  ASSERT_NE(rids.front().GetPageId(), rids.back().GetPageId());
+
+  auto check = [&] {
+    for (const auto &[rid, tuple_string] : expected) {
+      Tuple tuple;
+      ASSERT_TRUE(table->GetTuple(rid, &tuple, transaction));
+      ASSERT_EQ(tuple.ToString(&schema), tuple_string);
+    }
+    std::vector<std::string> scanned;
+    for (auto iter = table->Begin(transaction); iter != table->End(); ++iter) {
+      scanned.push_back(iter->ToString(&schema));
+    }
+    ASSERT_EQ(scanned.size(), expected.size());
+    auto expected_iter = expected.begin();
+    for (const auto &tuple_string : scanned) {
+      ASSERT_EQ(tuple_string, (expected_iter++)->second);
+    }
+  };
+  check();
+
+  // Updates grow and shrink the VARCHAR data of tuples in the middle of their pages.
+  for (int32_t i = 0; i < 2000; i += 3) {
+    Tuple tuple = MakeTuple(schema, -i, (i * 7) % 40);
+    if (table->UpdateTuple(tuple, rids[i], transaction)) {
+      expected[rids[i]] = tuple.ToString(&schema);
+    }
+  }
+  check();
+
+  // Deletes free slots and VARCHAR space, which new tuples reuse.
+  for (int32_t i = 0; i < 2000; i += 5) {
+    ASSERT_TRUE(table->MarkDelete(rids[i], transaction));
+    table->ApplyDelete(rids[i], transaction);
+    expected.erase(rids[i]);
+    Tuple tuple;
+    ASSERT_FALSE(table->GetTuple(rids[i], &tuple, transaction));
+  }
+  check();
+  for (int32_t i = 0; i < 100; i++) {
+    Tuple tuple = MakeTuple(schema, 5000 + i, 5);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    ASSERT_EQ(expected.count(rid), 0);
+    expected[rid] = tuple.ToString(&schema);
+  }
+  ASSERT_EQ(rids.front().GetPageId(), expected.begin()->first.GetPageId());
+  check();
+
+  // Copy two of the columns into small batches, page by page.
+  TupleBatch batch(&schema, 64);
+  std::vector<uint32_t> column_idxs{3, 0};
+  auto expected_iter = expected.begin();
+  page_id_t page_id = table->GetFirstPageId();
+  uint32_t slot = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    batch.Reset();
+    page_id_t next_page_id;
+    bool page_done = table->ScanColumns(page_id, &slot, column_idxs, &batch, 50, &next_page_id, transaction);
+    ASSERT_LE(batch.GetSize(), 50);
+    for (uint32_t row = 0; row < batch.GetSize(); row++, expected_iter++) {
+      ASSERT_NE(expected_iter, expected.end());
+      ASSERT_EQ(batch.GetRid(row), expected_iter->first);
+      Tuple tuple;
+      ASSERT_TRUE(table->GetTuple(batch.GetRid(row), &tuple, transaction));
+      ASSERT_EQ(batch.GetColumn(3).GetData<int16_t>()[row], tuple.GetValue(&schema, 3).GetAs<int16_t>());
+      ASSERT_EQ(batch.GetValue(row, 0).CompareEquals(tuple.GetValue(&schema, 0)), CmpBool::CmpTrue);
+    }
+    if (page_done) {
+      page_id = next_page_id;
+      slot = 0;
+    }
+  }
+  ASSERT_EQ(expected_iter, expected.end());
+
+  // Tuples whose VARCHAR data does not fit into a page are rejected.
+  std::vector<Value> values{ValueFactory::GetVarcharValue(std::string(PAGE_SIZE, 'x')),
+                            ValueFactory::GetIntegerValue(0), ValueFactory::GetBigIntValue(0),
+                            ValueFactory::GetSmallIntValue(0)};
+  RID rid;
+  ASSERT_FALSE(table->InsertTuple(Tuple(values, &schema), &rid, transaction));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+}  // namespace bustub
@@ -10,16 +10,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
+#include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
+TEST(TmpTuplePageTest, BasicTest) {
   // There are many ways to do this assignment, and this is only one of them.
   // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
   // You will get full credit as long as you are correctly using a linear probe hash table.
@@ -48,4 +52,80 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
 }
 
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, ReadBackTest) {
+  TmpTuplePage page{};
+  page_id_t page_id = 15445;
+  page.Init(page_id, PAGE_SIZE);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 32);
+  Schema schema(columns);
+
+  // Fill the page up.
+  std::vector<TmpTuple> tmp_tuples;
+  for (int32_t i = 0;; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 10, 'x'))}, &schema);
+    TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+    if (!page.Insert(tuple, &tmp_tuple)) {
+      break;
+    }
+    ASSERT_EQ(tmp_tuple.GetPageId(), page_id);
+    tmp_tuples.push_back(tmp_tuple);
+  }
+  ASSERT_GT(tmp_tuples.size(), 100);
+
+  // Every tuple can be read back through its TmpTuple, or all at once in insertion order.
+  std::vector<Tuple> tuples;
+  page.GetTuples(&tuples);
+  ASSERT_EQ(tuples.size(), tmp_tuples.size());
+  for (int32_t i = 0; i < static_cast<int32_t>(tmp_tuples.size()); i++) {
+    Tuple tuple;
+    page.Get(tmp_tuples[i], &tuple);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(i % 10, 'x'));
+    ASSERT_EQ(tuples[i].GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(tuples[i].GetValue(&schema, 1).ToString(), std::string(i % 10, 'x'));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, RunTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(1, disk_manager);
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::VARCHAR, PAGE_SIZE);
+  Schema schema(columns);
+  Tuple small({ValueFactory::GetVarcharValue("x")}, &schema);
+  Tuple large({ValueFactory::GetVarcharValue(std::string(PAGE_SIZE, 'x'))}, &schema);
+
+  // A tuple that does not fit on a page is rejected up front, without leaving an empty page in the run.
+  TmpTupleRun run(bpm);
+  ASSERT_TRUE(TmpTupleRun::Fits(small));
+  ASSERT_FALSE(TmpTupleRun::Fits(large));
+  ASSERT_FALSE(run.Append(large));
+  ASSERT_EQ(run.GetPageCount(), 0);
+
+  // A tuple that fits is only rejected while the buffer pool has no free frame.
+  page_id_t page_id;
+  ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+  ASSERT_FALSE(run.Append(small));
+  ASSERT_EQ(run.GetPageCount(), 0);
+  bpm->UnpinPage(page_id, false);
+  bpm->DeletePage(page_id);
+  ASSERT_TRUE(run.Append(small));
+  std::vector<Tuple> tuples;
+  run.ReadPage(0, &tuples);
+  ASSERT_EQ(tuples.size(), 1);
+  ASSERT_EQ(tuples[0].GetValue(&schema, 0).ToString(), "x");
+  run.Clear();
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete disk_manager;
+}
+
 }  // namespace bustub
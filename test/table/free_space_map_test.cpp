@@ -0,0 +1,287 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_test.cpp
+//
+// Identification: test/table/free_space_map_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, MapTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(10, disk_manager);
+  auto *map = new FreeSpaceMap(buffer_pool_manager);
+  ASSERT_TRUE(map->IsOpen());
+  auto find_page = [&](uint32_t tuple_size) {
+    page_id_t page_id;
+    EXPECT_TRUE(map->FindPage(tuple_size, &page_id));
+    return page_id;
+  };
+  ASSERT_EQ(find_page(1), INVALID_PAGE_ID);
+  ASSERT_EQ(map->GetLastPageId(), INVALID_PAGE_ID);
+
+  // Enough pages to need a second map page, all of them full except for a few.
+  const page_id_t num_pages = FreeSpaceMapPage::CAPACITY + 100;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    map->SetFreeSpace(1000 + i, 10);
+  }
+  ASSERT_EQ(map->GetLastPageId(), 1000 + num_pages - 1);
+  ASSERT_EQ(find_page(10), INVALID_PAGE_ID);
+  map->SetFreeSpace(1000 + num_pages - 1, 100);
+  map->SetFreeSpace(1000 + 500, 40);
+  // Categories round the free space down and the tuple size up.
+  ASSERT_EQ(find_page(32), 1500);
+  ASSERT_EQ(find_page(33), 1000 + num_pages - 1);
+  ASSERT_EQ(find_page(96), 1000 + num_pages - 1);
+  ASSERT_EQ(find_page(97), INVALID_PAGE_ID);
+  ASSERT_EQ(find_page(PAGE_SIZE), INVALID_PAGE_ID);
+
+  // Shrinking the only page with room leaves the map without one.
+  map->SetFreeSpace(1000 + num_pages - 1, 0);
+  ASSERT_EQ(find_page(33), INVALID_PAGE_ID);
+  ASSERT_EQ(find_page(32), 1500);
+
+  // The map can be opened again from its pages.
+  page_id_t first_page_id = map->GetFirstPageId();
+  delete map;
+  map = new FreeSpaceMap(buffer_pool_manager, first_page_id);
+  ASSERT_EQ(map->GetLastPageId(), 1000 + num_pages - 1);
+  ASSERT_EQ(find_page(32), 1500);
+  ASSERT_EQ(find_page(33), INVALID_PAGE_ID);
+  map->SetFreeSpace(1001, PAGE_SIZE);
+  ASSERT_EQ(find_page(PAGE_SIZE / 2), 1001);
+
+  // Without a free frame for its pages, the map fails lookups and updates and leaves its entries as they were.
+  std::vector<page_id_t> pinned_page_ids;
+  page_id_t pinned_page_id;
+  while (buffer_pool_manager->NewPage(&pinned_page_id) != nullptr) {
+    pinned_page_ids.push_back(pinned_page_id);
+  }
+  page_id_t page_id;
+  ASSERT_FALSE(map->FindPage(PAGE_SIZE / 2, &page_id));
+  ASSERT_FALSE(map->SetFreeSpace(1001, 0));
+  ASSERT_FALSE(map->SetFreeSpace(1000 + num_pages, PAGE_SIZE));
+  ASSERT_FALSE(FreeSpaceMap(buffer_pool_manager).IsOpen());
+  ASSERT_FALSE(FreeSpaceMap(buffer_pool_manager, first_page_id).IsOpen());
+  for (auto id : pinned_page_ids) {
+    buffer_pool_manager->UnpinPage(id, false);
+  }
+  ASSERT_EQ(find_page(PAGE_SIZE / 2), 1001);
+  ASSERT_EQ(map->GetLastPageId(), 1000 + num_pages - 1);
+
+  delete map;
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete buffer_pool_manager;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, TableHeapTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 100)});
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+  ASSERT_NE(table->GetFreeSpaceMapPageId(), INVALID_PAGE_ID);
+
+  auto make_tuple = [&](int32_t a, size_t length) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::string(length, 'x'))}, &schema);
+  };
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < 1000; i++) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(make_tuple(i, 50), &rid, transaction));
+    rids.push_back(rid);
+  }
+  page_id_t first_page_id = table->GetFirstPageId();
+  page_id_t last_page_id = rids.back().GetPageId();
+  ASSERT_NE(first_page_id, last_page_id);
+
+  // Freeing up room on the first page sends the next insert that fits there, and only those, back to it.
+  ASSERT_TRUE(table->MarkDelete(rids.front(), transaction));
+  table->ApplyDelete(rids.front(), transaction);
+  RID rid;
+  ASSERT_TRUE(table->InsertTuple(make_tuple(-1, 100), &rid, transaction));
+  ASSERT_NE(rid.GetPageId(), first_page_id);
+  ASSERT_TRUE(table->InsertTuple(make_tuple(-2, 10), &rid, transaction));
+  ASSERT_EQ(rid.GetPageId(), first_page_id);
+  Tuple tuple;
+  ASSERT_TRUE(table->GetTuple(rid, &tuple, transaction));
+  ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), -2);
+
+  // A table opened with its free space map goes straight to the end of the table.
+  TableHeap opened(buffer_pool_manager, lock_manager, log_manager, first_page_id, TableLayout::ROW, nullptr,
+                   table->GetFreeSpaceMapPageId());
+  ASSERT_TRUE(opened.InsertTuple(make_tuple(-3, 50), &rid, transaction));
+  ASSERT_GE(rid.GetPageId(), last_page_id);
+
+  // Every tuple can still be found by walking the table.
+  size_t num_tuples = 0;
+  for (auto iter = opened.Begin(transaction); iter != opened.End(); ++iter) {
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, 1002);
+
+  // With a single free frame, the map and the table page cannot both be pinned. The insert still goes through, and
+  // only leaves the map's entry stale, and with no free frame at all, it aborts the transaction.
+  std::vector<page_id_t> pinned_page_ids;
+  page_id_t pinned_page_id;
+  while (buffer_pool_manager->NewPage(&pinned_page_id) != nullptr) {
+    pinned_page_ids.push_back(pinned_page_id);
+  }
+  buffer_pool_manager->UnpinPage(pinned_page_ids.back(), false);
+  ASSERT_TRUE(table->InsertTuple(make_tuple(-4, 50), &rid, transaction));
+  ASSERT_TRUE(opened.InsertTuple(make_tuple(-5, 50), &rid, transaction));
+  ASSERT_NE(buffer_pool_manager->NewPage(&pinned_page_id), nullptr);
+  pinned_page_ids.back() = pinned_page_id;
+  Transaction aborted_transaction(1);
+  ASSERT_FALSE(table->InsertTuple(make_tuple(-6, 50), &rid, &aborted_transaction));
+  ASSERT_EQ(aborted_transaction.GetState(), TransactionState::ABORTED);
+  for (auto id : pinned_page_ids) {
+    buffer_pool_manager->UnpinPage(id, false);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, PrivateInsertPagesTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT)});
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  TransactionManager txn_mgr{lock_manager, log_manager};
+  auto *create_txn = txn_mgr.Begin();
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, create_txn, TableLayout::ROW, &schema);
+  txn_mgr.Commit(create_txn);
+  delete create_txn;
+  table->SetPrivateInsertPages(true);
+
+  // Every thread inserts in a transaction of its own, and so into pages of its own.
+  const int num_threads = 4;
+  const int32_t num_tuples = 1000;
+  std::vector<Transaction *> txns;
+  std::vector<std::vector<RID>> rids(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    txns.push_back(txn_mgr.Begin());
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i] {
+      for (int32_t j = 0; j < num_tuples; j++) {
+        Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(j)}, &schema);
+        RID rid;
+        ASSERT_TRUE(table->InsertTuple(tuple, &rid, txns[i]));
+        rids[i].push_back(rid);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::set<page_id_t> all_pages;
+  size_t num_pages = 0;
+  for (int i = 0; i < num_threads; i++) {
+    std::set<page_id_t> pages;
+    for (const auto &rid : rids[i]) {
+      pages.insert(rid.GetPageId());
+    }
+    ASSERT_NE(pages.count(table->GetFirstPageId()), 1);
+    num_pages += pages.size();
+    all_pages.insert(pages.begin(), pages.end());
+  }
+  ASSERT_EQ(all_pages.size(), num_pages);
+
+  // Every page made it into the chain, and the zone map saw every tuple.
+  size_t count = 0;
+  std::vector<uint32_t> per_thread(num_threads, 0);
+  for (auto iter = table->Begin(txns[0]); iter != table->End(); ++iter) {
+    per_thread[iter->GetValue(&schema, 0).GetAs<int32_t>()]++;
+    count++;
+  }
+  ASSERT_EQ(count, num_threads * num_tuples);
+  for (int i = 0; i < num_threads; i++) {
+    ASSERT_EQ(per_thread[i], num_tuples);
+  }
+  ColumnZone zone;
+  page_id_t next_page_id;
+  ASSERT_TRUE(table->GetZone(rids[1].back().GetPageId(), 0, &zone, &next_page_id));
+  ASSERT_EQ(zone.min_.GetAs<int32_t>(), 1);
+  ASSERT_EQ(zone.max_.GetAs<int32_t>(), 1);
+
+  // Shared inserts stay off the pages that the transactions still hold, even once the other pages are full, and even
+  // if a transaction frees up room on its page.
+  std::set<page_id_t> last_pages;
+  for (int i = 0; i < num_threads; i++) {
+    last_pages.insert(rids[i].back().GetPageId());
+  }
+  table->ApplyDelete(rids[num_threads - 1].back(), txns[num_threads - 1]);
+  table->SetPrivateInsertPages(false);
+  auto *shared_txn = txn_mgr.Begin();
+  for (int32_t j = 0; j < num_tuples; j++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(num_threads), ValueFactory::GetBigIntValue(j)}, &schema);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, shared_txn));
+    ASSERT_EQ(last_pages.count(rid.GetPageId()), 0);
+  }
+  txn_mgr.Commit(shared_txn);
+  delete shared_txn;
+  table->SetPrivateInsertPages(true);
+
+  // Once the transactions are done, their last pages take inserts from anyone again.
+  for (auto *txn : txns) {
+    txn_mgr.Commit(txn);
+    delete txn;
+  }
+  table->SetPrivateInsertPages(false);
+  auto *txn = txn_mgr.Begin();
+  Tuple tuple({ValueFactory::GetIntegerValue(-1), ValueFactory::GetBigIntValue(-1)}, &schema);
+  RID rid;
+  ASSERT_TRUE(table->InsertTuple(tuple, &rid, txn));
+  ASSERT_TRUE(rid.GetPageId() == table->GetFirstPageId() || last_pages.count(rid.GetPageId()) == 1);
+  txn_mgr.Commit(txn);
+  delete txn;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -14,13 +14,16 @@
 #include <cstdio>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +74,148 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, ScanPageTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Column col3{"c", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2, col3};
+  Schema schema{cols};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+
+  // A short tuple may still fit on an earlier page, so the tuples are sorted into table order, i.e. RID order.
+  std::vector<std::pair<RID, std::string>> inserted;
+  for (int i = 0; i < 1000; ++i) {
+    Tuple tuple = ConstructTuple(&schema);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    inserted.emplace_back(rid, tuple.ToString(&schema));
+  }
+  std::sort(inserted.begin(), inserted.end(),
+            [](const auto &a, const auto &b) { return a.first.Get() < b.first.Get(); });
+  std::vector<RID> rid_v;
+  std::vector<std::string> tuple_strings;
+  for (const auto &[rid, tuple_string] : inserted) {
+    rid_v.push_back(rid);
+    tuple_strings.push_back(tuple_string);
+  }
+  ASSERT_NE(rid_v.front().GetPageId(), rid_v.back().GetPageId());
+
+  // Visit the table in place, stopping after every 7th tuple and resuming from the returned slot.
+  std::vector<RID> visited_rids;
+  std::vector<std::string> visited_strings;
+  page_id_t page_id = table->GetFirstPageId();
+  uint32_t slot = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    page_id_t next_page_id;
+    bool page_done = table->ScanPage(
+        page_id, &slot,
+        [&](const Tuple &tuple) {
+          EXPECT_FALSE(tuple.IsAllocated());
+          visited_rids.push_back(tuple.GetRid());
+          visited_strings.push_back(tuple.ToString(&schema));
+          return visited_rids.size() % 7 != 0;
+        },
+        &next_page_id, transaction);
+    if (page_done) {
+      page_id = next_page_id;
+      slot = 0;
+    }
+  }
+  ASSERT_EQ(visited_rids, rid_v);
+  ASSERT_EQ(visited_strings, tuple_strings);
+
+  disk_manager->ShutDown();
+  remove("test.db");  // remove db file
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, BulkInsertTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 20)});
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(10, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  TransactionManager txn_mgr{lock_manager, log_manager};
+  auto make_tuple = [&](int32_t a) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::to_string(a))}, &schema);
+  };
+
+  for (auto layout : {TableLayout::ROW, TableLayout::PAX}) {
+    auto *txn = txn_mgr.Begin();
+    TableHeap table(buffer_pool_manager, lock_manager, log_manager, txn, layout, &schema);
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(make_tuple(-1), &rid, txn));
+    txn_mgr.Commit(txn);
+    delete txn;
+
+    // The tuples go onto new pages after the existing one, in order, with one write record per page.
+    txn = txn_mgr.Begin();
+    std::vector<Tuple> tuples;
+    for (int32_t i = 0; i < 3000; i++) {
+      tuples.push_back(make_tuple(i));
+    }
+    std::vector<RID> rids;
+    ASSERT_TRUE(table.BulkInsert(tuples, &rids, txn));
+    ASSERT_EQ(rids.size(), tuples.size());
+    ASSERT_NE(rids.front().GetPageId(), table.GetFirstPageId());
+    ASSERT_EQ(rids.front().GetSlotNum(), 0);
+    ASSERT_GT(txn->GetWriteSet()->size(), 1);
+    ASSERT_LT(txn->GetWriteSet()->size(), 100);
+    for (int32_t i = 0; i < 3000; i++) {
+      Tuple tuple;
+      ASSERT_TRUE(table.GetTuple(rids[i], &tuple, txn));
+      ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+      ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::to_string(i));
+    }
+    int32_t expected = -1;
+    for (auto iter = table.Begin(txn); iter != table.End(); ++iter) {
+      ASSERT_EQ(iter->GetValue(&schema, 0).GetAs<int32_t>(), expected++);
+    }
+    ASSERT_EQ(expected, 3000);
+    ColumnZone zone;
+    page_id_t next_page_id;
+    ASSERT_TRUE(table.GetZone(rids.back().GetPageId(), 0, &zone, &next_page_id));
+    ASSERT_EQ(zone.max_.GetAs<int32_t>(), 2999);
+    ASSERT_EQ(next_page_id, INVALID_PAGE_ID);
+
+    // An insert by someone else may use the room left on the last new page, and survives the rollback.
+    auto *other_txn = txn_mgr.Begin();
+    ASSERT_TRUE(table.InsertTuple(make_tuple(5000), &rid, other_txn));
+    txn_mgr.Commit(other_txn);
+    delete other_txn;
+    txn_mgr.Abort(txn);
+    delete txn;
+    txn = txn_mgr.Begin();
+    std::vector<int32_t> remaining;
+    for (auto iter = table.Begin(txn); iter != table.End(); ++iter) {
+      remaining.push_back(iter->GetValue(&schema, 0).GetAs<int32_t>());
+    }
+    ASSERT_EQ(remaining, std::vector<int32_t>({-1, 5000}));
+    txn_mgr.Commit(txn);
+    delete txn;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+}
+
 }  // namespace bustub
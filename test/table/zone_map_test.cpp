@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map_test.cpp
+//
+// Identification: test/table/zone_map_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/zone_map.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, ZoneTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 10)});
+  ZoneMap zone_map(schema);
+  zone_map.AddPage(1, INVALID_PAGE_ID);
+  zone_map.AddPage(2, 1);
+  ColumnZone zone;
+  page_id_t next_page_id;
+  ASSERT_FALSE(zone_map.GetZone(3, 0, &zone, &next_page_id));
+  ASSERT_TRUE(zone_map.GetZone(1, 0, &zone, &next_page_id));
+  ASSERT_EQ(next_page_id, 2);
+  ASSERT_EQ(zone.tuple_count_, 0);
+  ASSERT_TRUE(zone.min_.IsNull());
+
+  auto make_tuple = [&](Value a, const std::string &b) {
+    return Tuple({std::move(a), ValueFactory::GetVarcharValue(b)}, &schema);
+  };
+  Tuple five = make_tuple(ValueFactory::GetIntegerValue(5), "m");
+  Tuple null = make_tuple(ValueFactory::GetNullValueByType(TypeId::INTEGER), "z");
+  Tuple minus_three = make_tuple(ValueFactory::GetIntegerValue(-3), "a");
+  zone_map.Insert(1, five);
+  zone_map.Insert(1, null);
+  zone_map.Insert(1, minus_three);
+  ASSERT_TRUE(zone_map.GetZone(1, 0, &zone, &next_page_id));
+  ASSERT_EQ(zone.tuple_count_, 3);
+  ASSERT_EQ(zone.null_count_, 1);
+  ASSERT_EQ(zone.min_.GetAs<int32_t>(), -3);
+  ASSERT_EQ(zone.max_.GetAs<int32_t>(), 5);
+  ASSERT_TRUE(zone_map.GetZone(1, 1, &zone, &next_page_id));
+  ASSERT_EQ(zone.min_.ToString(), "a");
+  ASSERT_EQ(zone.max_.ToString(), "z");
+  ASSERT_TRUE(zone_map.GetZone(2, 0, &zone, &next_page_id));
+  ASSERT_EQ(zone.tuple_count_, 0);
+  ASSERT_EQ(next_page_id, INVALID_PAGE_ID);
+
+  // Deletes keep the bounds until the page is empty.
+  zone_map.Delete(1, null);
+  zone_map.Delete(1, minus_three);
+  ASSERT_TRUE(zone_map.GetZone(1, 0, &zone, &next_page_id));
+  ASSERT_EQ(zone.tuple_count_, 1);
+  ASSERT_EQ(zone.null_count_, 0);
+  ASSERT_EQ(zone.min_.GetAs<int32_t>(), -3);
+  zone_map.Delete(1, five);
+  ASSERT_TRUE(zone_map.GetZone(1, 0, &zone, &next_page_id));
+  ASSERT_EQ(zone.tuple_count_, 0);
+  ASSERT_TRUE(zone.min_.IsNull());
+  ASSERT_TRUE(zone.max_.IsNull());
+}
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, TableHeapTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT)});
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, TableLayout::ROW, &schema);
+
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < 2000; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(-int64_t{i})}, &schema);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rids.push_back(rid);
+  }
+  // Update the first tuple to a value way out of range, and delete the last one.
+  Tuple updated({ValueFactory::GetIntegerValue(100000), ValueFactory::GetBigIntValue(0)}, &schema);
+  ASSERT_TRUE(table->UpdateTuple(updated, rids.front(), transaction));
+  ASSERT_TRUE(table->MarkDelete(rids.back(), transaction));
+  table->ApplyDelete(rids.back(), transaction);
+
+  // The zone map follows the page chain, and every page covers the serial values that were inserted into it.
+  page_id_t page_id = table->GetFirstPageId();
+  int32_t expected_min = 0;
+  uint32_t num_tuples = 0;
+  uint32_t num_pages = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    ColumnZone zone;
+    page_id_t next_page_id;
+    ASSERT_TRUE(table->GetZone(page_id, 0, &zone, &next_page_id));
+    num_tuples += zone.tuple_count_;
+    ASSERT_EQ(zone.null_count_, 0);
+    ASSERT_EQ(zone.min_.GetAs<int32_t>(), expected_min);
+    if (num_pages == 0) {
+      ASSERT_EQ(zone.max_.GetAs<int32_t>(), 100000);
+      expected_min = 0;
+      for (const auto &rid : rids) {
+        expected_min += rid.GetPageId() == page_id ? 1 : 0;
+      }
+    } else {
+      expected_min = zone.max_.GetAs<int32_t>() + 1;
+    }
+    num_pages++;
+    page_id = next_page_id;
+  }
+  ASSERT_GT(num_pages, 1);
+  ASSERT_EQ(expected_min, 2000);
+  ASSERT_EQ(num_tuples, 1999);
+
+  // A table opened on existing pages has not seen their tuples, so it keeps no zone map.
+  TableHeap opened(buffer_pool_manager, lock_manager, log_manager, table->GetFirstPageId());
+  ColumnZone zone;
+  page_id_t next_page_id;
+  ASSERT_FALSE(opened.GetZone(table->GetFirstPageId(), 0, &zone, &next_page_id));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+}  // namespace bustub
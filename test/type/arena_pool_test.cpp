@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool_test.cpp
+//
+// Identification: test/type/arena_pool_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "gtest/gtest.h"
+#include "storage/table/tuple.h"
+#include "type/arena_pool.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ArenaPoolTest, AllocateTest) {
+  ArenaPool pool(1024);
+  std::vector<char *> allocations;
+  // Small allocations are aligned, do not overlap and survive later allocations, including large ones.
+  for (size_t i = 0; i < 200; i++) {
+    size_t size = i % 3 == 0 ? 2000 : i % 17 + 1;
+    auto data = static_cast<char *>(pool.Allocate(size));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data) % alignof(std::max_align_t), 0);
+    memset(data, static_cast<int>(i), size);
+    allocations.push_back(data);
+  }
+  for (size_t i = 0; i < allocations.size(); i++) {
+    size_t size = i % 3 == 0 ? 2000 : i % 17 + 1;
+    for (size_t j = 0; j < size; j++) {
+      ASSERT_EQ(allocations[i][j], static_cast<char>(i));
+    }
+  }
+  EXPECT_GE(pool.GetAllocatedBytes(), 67 * 2000);
+
+  pool.Reset();
+  EXPECT_EQ(pool.GetAllocatedBytes(), 0);
+  auto data = static_cast<char *>(pool.Allocate(10));
+  memset(data, 1, 10);
+  EXPECT_EQ(pool.GetAllocatedBytes(), alignof(std::max_align_t));
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaPoolTest, ValueTest) {
+  ArenaPool pool;
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 20)});
+  Tuple tuple({ValueFactory::GetIntegerValue(7), ValueFactory::GetVarcharValue("pooled")}, &schema, &pool);
+
+  // Pool tuples share their data on copy.
+  Tuple copy = tuple;
+  EXPECT_FALSE(copy.IsAllocated());
+  EXPECT_EQ(copy.GetData(), tuple.GetData());
+  EXPECT_EQ(copy.GetValue(&schema, 0).GetAs<int32_t>(), 7);
+  EXPECT_EQ(copy.GetValue(&schema, 1).ToString(), "pooled");
+
+  // VARCHAR values can be deserialized and cloned into the pool.
+  char storage[32];
+  copy.GetValue(&schema, 1).SerializeTo(storage);
+  Value value = Value::DeserializeFrom(storage, TypeId::VARCHAR, &pool);
+  memset(storage, 0, sizeof(storage));
+  EXPECT_EQ(value.ToString(), "pooled");
+  Value clone = ValueFactory::Clone(value, &pool);
+  EXPECT_NE(clone.GetData(), value.GetData());
+  EXPECT_EQ(clone.CompareEquals(value), CmpBool::CmpTrue);
+  Value from_string = ValueFactory::GetVarcharValue(std::string("string"), &pool);
+  EXPECT_EQ(from_string.ToString(), "string");
+  EXPECT_TRUE(ValueFactory::Clone(ValueFactory::GetNullValueByType(TypeId::VARCHAR), &pool).IsNull());
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaPoolTest, ExecutorContextTest) {
+  auto context = std::make_unique<ExecutorContext>(nullptr, nullptr, nullptr);
+  ArenaPool *pool = context->GetPool();
+  EXPECT_EQ(context->GetPool(), pool);
+
+  // Every thread gets a pool of its own.
+  ArenaPool *other_pool = nullptr;
+  std::thread thread([&] { other_pool = context->GetPool(); });
+  thread.join();
+  EXPECT_NE(other_pool, nullptr);
+  EXPECT_NE(other_pool, pool);
+
+  // A new context gets new pools, even at the same address.
+  context.reset();
+  ExecutorContext other_context(nullptr, nullptr, nullptr);
+  pool = other_context.GetPool();
+  pool->Allocate(10);
+  EXPECT_EQ(pool->GetAllocatedBytes(), alignof(std::max_align_t));
+}
+
+}  // namespace bustub
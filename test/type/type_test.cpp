@@ -95,4 +95,37 @@ TEST(TypeTests, TemplateTest) {
   BPlusTreePage<Value, Value> node;
   node.GetInfo(val1, val2);
 }
+
+// NOLINTNEXTLINE
+TEST(TypeTests, VarcharStorageTest) {
+  static_assert(sizeof(Value) == 16, "Value should stay two words wide");
+  std::string short_str = "short";
+  std::string long_str = "a string that does not fit into a value";
+  for (const auto &str : {short_str, long_str}) {
+    Value val(TypeId::VARCHAR, str);
+    EXPECT_EQ(val.ToString(), str);
+
+    // Copies have data of their own.
+    Value copy = val;
+    EXPECT_NE(copy.GetData(), val.GetData());
+    EXPECT_EQ(copy.CompareEquals(val), CmpBool::CmpTrue);
+    Value assigned(TypeId::INTEGER, 1);
+    assigned = copy;
+    EXPECT_EQ(assigned.ToString(), str);
+
+    // Moves keep the data, and leave a VARCHAR behind.
+    std::vector<Value> values;
+    values.push_back(std::move(copy));
+    values.resize(100, Value(TypeId::INTEGER, 2));
+    EXPECT_EQ(values[0].ToString(), str);
+    EXPECT_EQ(copy.GetTypeId(), TypeId::VARCHAR);  // NOLINT
+    assigned = std::move(values[0]);
+    EXPECT_EQ(assigned.ToString(), str);
+
+    // Values that do not manage their data share it with their copies.
+    Value borrowed(TypeId::VARCHAR, str.c_str(), static_cast<uint32_t>(str.length()) + 1, false);
+    Value borrowed_copy = borrowed;
+    EXPECT_EQ(borrowed_copy.GetData(), str.c_str());
+  }
+}
 }  // namespace bustub